@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../utils/data_structures/BTree/BTree.h"
+#include "../../utils/data_structures/FixedKey/FixedKey.h"
+
+/**
+ * Benchmarks the B-tree used by the PK index: inserts, point searches and range iterations
+ * for 64-bit integer keys (UUID and int PKs) and 16 character inline keys (char(16) PKs)
+ * across node degrees.
+ * Usage: btree_benchmark [keys] [seed]
+ */
+
+struct BenchmarkResult {
+    double insertTime;
+    double searchTime;
+    double fullScanTime;
+    double rangeScanTime;
+    size_t visitedKeys;
+    size_t reservedSize;
+};
+
+/**
+ * Gets the time elapsed since a point in time.
+ * @param start Point in time to measure from.
+ * @return Elapsed time in milliseconds.
+ */
+static double elapsedMilliseconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Generates 16 digit UUIDs the same way generateUUID does, but from a fixed seed.
+ * @param number Amount of UUIDs to generate.
+ * @param seed Seed of the generator.
+ * @return The generated UUIDs.
+ */
+static std::vector<std::string> generateUUIDs(size_t number, unsigned seed) {
+    std::mt19937_64 generator(seed);
+    std::vector<std::string> uuids(number);
+
+    for (auto &uuid : uuids) {
+        uuid.resize(16);
+        for (auto &digit : uuid) digit = static_cast<char>('0' + generator() % 10);
+    }
+    return uuids;
+}
+
+template <typename Key>
+static BenchmarkResult runBenchmark(long degree, const std::vector<Key> &keys, const std::vector<Key> &probes,
+                                    const std::vector<std::pair<Key, Key>> &ranges) {
+    BenchmarkResult result{};
+    BTree<Key> btree(degree);
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &key : keys) btree.insert(key);
+    result.insertTime = elapsedMilliseconds(start);
+    result.reservedSize = btree.getReservedSize();
+
+    size_t found = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto &probe : probes) found += btree.search(probe);
+    result.searchTime = elapsedMilliseconds(start);
+    if (found != probes.size()) std::cerr << "Warning: " << probes.size() - found << " keys were not found!" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    btree.forEach([&result](const Key &) {
+        result.visitedKeys++;
+        return true;
+    });
+    result.fullScanTime = elapsedMilliseconds(start);
+
+    start = std::chrono::steady_clock::now();
+    for (const auto &[low, high] : ranges) {
+        btree.forEachInRange(low, high, [&result](const Key &) {
+            result.visitedKeys++;
+            return true;
+        });
+    }
+    result.rangeScanTime = elapsedMilliseconds(start);
+
+    return result;
+}
+
+template <typename Key>
+static void runSuite(const std::string &name, const std::vector<Key> &keys) {
+    std::vector<Key> probes(keys.begin(), keys.end());
+    std::shuffle(probes.begin(), probes.end(), std::mt19937(7));
+
+    // Ranges start at random keys and cover about 100 keys each.
+    std::vector<Key> sorted(keys.begin(), keys.end());
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<std::pair<Key, Key>> ranges;
+    for (size_t index = 0 ; index + 100 < sorted.size() && ranges.size() < 10000 ; index += sorted.size() / 10000 + 1) {
+        ranges.emplace_back(sorted[index], sorted[index + 99]);
+    }
+
+    std::cout << name << " (" << keys.size() << " keys)\n";
+    std::cout << std::setw(8) << "degree" << std::setw(14) << "insert(ms)" << std::setw(14) << "search(ms)"
+              << std::setw(14) << "scan(ms)" << std::setw(14) << "ranges(ms)" << std::setw(14) << "memory(KB)" << "\n";
+
+    for (long degree : {2L, 4L, 8L, 16L, 32L, 64L, 128L, 256L}) {
+        BenchmarkResult result = runBenchmark(degree, keys, probes, ranges);
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(8) << degree << std::setw(14) << result.insertTime << std::setw(14) << result.searchTime
+                  << std::setw(14) << result.fullScanTime << std::setw(14) << result.rangeScanTime
+                  << std::setw(14) << result.reservedSize / 1024 << "\n";
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char **argv) {
+    size_t keyNumber = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    unsigned seed = argc > 2 ? std::stoul(argv[2]) : 42;
+
+    std::vector<std::string> uuids = generateUUIDs(keyNumber, seed);
+
+    std::vector<int64_t> integerKeys;
+    std::vector<FixedKey<16>> fixedKeys;
+    for (const auto &uuid : uuids) {
+        integerKeys.push_back(std::stoll(uuid));
+        fixedKeys.emplace_back(uuid);
+    }
+
+    runSuite("int64 keys", integerKeys);
+    runSuite("char(16) keys", fixedKeys);
+
+    return 0;
+}
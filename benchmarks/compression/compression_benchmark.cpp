@@ -0,0 +1,136 @@
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "../../io/io.h"
+#include "../../utils/compression/compression.h"
+
+/**
+ * Benchmarks the compression of relation files: the same rows are written plain and at several
+ * compression levels, then read with full scans and with reads of single rows by their offset, the
+ * way fetches by PK read them. The size of the files and the bytes read from the disk show what the
+ * compression saves, the throughputs what it costs.
+ * The benchmark runs in a temporary directory, which is removed at the end.
+ * Usage: compression_benchmark [rows] [seed]
+ */
+
+struct BenchmarkResult {
+    uint64_t fileSize;
+    double writeTime;
+    double scanTime;
+    uint64_t scanBytesRead;
+    double readTime;
+};
+
+/**
+ * Gets the time elapsed since a point in time.
+ * @param start Point in time to measure from.
+ * @return Elapsed time in milliseconds.
+ */
+static double elapsedMilliseconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Generates the lines of a relation file: a header and versioned rows with a PK, a name out of a
+ * few, a boolean and a random amount, like the rows FQL writes.
+ * @param number Amount of rows to generate.
+ * @param seed Seed of the generator.
+ * @return The header followed by the rows.
+ */
+static std::vector<std::string> generateLines(size_t number, unsigned seed) {
+    const std::vector<std::string> names = {"Ann", "Bob", "Cid", "Dan", "Eve", "Ina", "Liv", "Max"};
+    std::mt19937 generator(seed);
+    std::vector<std::string> lines = {"RID,ID,name,active,amount"};
+
+    for (size_t index = 0 ; index < number ; index++) {
+        lines.push_back(std::to_string(index) + "@1-000000000000," + std::to_string(index) + ","
+                        + names[generator() % names.size()] + "," + (generator() % 2 ? "True" : "False") + ","
+                        + std::to_string(generator() % 100000));
+    }
+    return lines;
+}
+
+static BenchmarkResult runLevel(const std::string &filePath, const std::vector<std::string> &lines,
+                                const std::vector<uint64_t> &offsets, int level) {
+    BenchmarkResult result{};
+    createFile(filePath);
+
+    auto start = std::chrono::steady_clock::now();
+    if (level > 0) writeCompressedLines(filePath, lines, level);
+    else writeLines(filePath, lines);
+    result.writeTime = elapsedMilliseconds(start);
+    result.fileSize = getFileSize(filePath);
+
+    // The first scan reads every block from the disk, the block pool is then measured by the reads.
+    size_t scannedLines = 0;
+    uint64_t bytesRead = getBytesRead();
+    start = std::chrono::steady_clock::now();
+    forEachLine(filePath, [&](uint64_t, const std::string &) { scannedLines++; });
+    result.scanTime = elapsedMilliseconds(start);
+    result.scanBytesRead = getBytesRead() - bytesRead;
+    if (scannedLines != lines.size()) throw std::runtime_error("Scan of " + filePath + " lost lines!");
+
+    start = std::chrono::steady_clock::now();
+    for (uint64_t offset : offsets) {
+        if (readLineAt(filePath, offset).empty()) throw std::runtime_error("Read of " + filePath + " lost a line!");
+    }
+    result.readTime = elapsedMilliseconds(start);
+
+    return result;
+}
+
+static void showResult(const std::string &name, size_t rows, size_t reads, uint64_t plainSize,
+                       const BenchmarkResult &result) {
+    double megabytes = static_cast<double>(plainSize) / (1024 * 1024);
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(10) << name << std::setw(12) << result.fileSize / 1024
+              << std::setw(10) << static_cast<double>(plainSize) / static_cast<double>(result.fileSize)
+              << std::setw(12) << megabytes / (result.writeTime / 1000)
+              << std::setw(14) << rows / (result.scanTime / 1000)
+              << std::setw(14) << result.scanBytesRead / 1024
+              << std::setw(14) << reads / (result.readTime / 1000) << "\n";
+}
+
+int main(int argc, char **argv) {
+    size_t rowNumber = argc > 1 ? std::stoul(argv[1]) : 200000;
+    unsigned seed = argc > 2 ? std::stoul(argv[2]) : 42;
+    size_t readNumber = 20000;
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() /
+                                      ("fql_compression_benchmark_" + std::to_string(getpid()));
+    std::filesystem::create_directories(directory);
+    std::string filePath = (directory / "relation").string();
+
+    std::vector<std::string> lines = generateLines(rowNumber, seed);
+    std::vector<uint64_t> lineOffsets;
+    uint64_t plainSize = 0;
+    for (const auto &line : lines) {
+        lineOffsets.push_back(plainSize);
+        plainSize += line.size() + 1;
+    }
+
+    std::mt19937 generator(seed);
+    std::vector<uint64_t> offsets(readNumber);
+    for (auto &offset : offsets) offset = lineOffsets[1 + generator() % rowNumber];
+
+    std::cout << "Relation file compression (" << rowNumber << " rows, " << readNumber << " random reads)\n";
+    std::cout << std::setw(10) << "level" << std::setw(12) << "size(KiB)" << std::setw(10) << "ratio"
+              << std::setw(12) << "write MB/s" << std::setw(14) << "scan rows/s" << std::setw(14) << "scan KiB read"
+              << std::setw(14) << "reads/s" << "\n";
+
+    for (int level : {0, 1, 3, 6, maxCompressionLevel}) {
+        BenchmarkResult result = runLevel(filePath, lines, offsets, level);
+        showResult(level == 0 ? "plain" : std::to_string(level), rowNumber, readNumber, plainSize, result);
+    }
+    std::cout << std::endl;
+
+    std::filesystem::remove_all(directory);
+
+    return 0;
+}
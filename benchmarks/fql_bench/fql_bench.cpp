@@ -0,0 +1,332 @@
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <unistd.h>
+
+#include "../../interpretor/executor/executor.h"
+#include "../../interpretor/parser/parser.h"
+#include "../../interpretor/scanner/scanner.h"
+#include "../../domain/datatype/datatypes/uuid/Uuid.h"
+#include "../../utils/data_structures/PKIndex/PKIndex.h"
+
+/**
+ * Benchmarks every statement type of FQL on generated relations of 10^3 rows up to a maximum
+ * number of rows, growing tenfold: add, addf, PK and non-PK update and delete, fetch with and
+ * without where, ordered and aggregated fetches, concatenation, show, the scan and parse/build of
+ * source files and the PK index B-tree. The data is generated from a fixed seed, so two runs with
+ * the same arguments execute the same statements on the same rows.
+ * The benchmark runs in a temporary directory, which is removed at the end, and writes its results
+ * as JSON to the output file, or to the standard output if none is given.
+ * Usage: fql_bench [maxRows] [seed] [output]
+ */
+
+struct BenchmarkResult {
+    std::string benchmark;
+    size_t rows;
+    size_t statements;
+    double time;
+};
+
+/**
+ * Generates the rows of a benchmark relation. Every datatype of FQL has a column, and the same
+ * seed always produces the same rows.
+ */
+class RowGenerator {
+public:
+    explicit RowGenerator(unsigned seed) : generator(seed) {}
+
+    /**
+     * Generates the UUID of a row. Distinct indexes get distinct UUIDs, spread over the whole range.
+     * @param index Index of the row.
+     * @return 16 digit UUID.
+     */
+    static std::string getUUID(size_t index) {
+        // 7 is coprime with 10^15, so the multiplication permutes the indexes below 10^15.
+        uint64_t scattered = (static_cast<uint64_t>(index) * 7 + 123456789) % 1000000000000000ULL;
+        std::string digits = std::to_string(scattered);
+
+        return std::to_string(1 + index % 9) + std::string(15 - digits.size(), '0') + digits;
+    }
+
+    /**
+     * Generates the values of a row, in the order of the benchmark relation attributes.
+     * @param index Index of the row.
+     * @param frontEndValues True to only generate values the parser accepts in add statements (no NULL).
+     * @return Values of the row.
+     */
+    std::vector<std::string> getRow(size_t index, bool frontEndValues) {
+        std::vector<std::string> row = {getUUID(index), getName(), getCode(), getBoolean(!frontEndValues),
+                                        std::to_string(generator() % 1000)};
+
+        int year = 2000 + static_cast<int>(generator() % 25);
+        int month = 1 + static_cast<int>(generator() % 12);
+        int day = 1 + static_cast<int>(generator() % 28);
+        row.push_back(getDate(year, month, day));
+        row.push_back(getDate(year, month, day) + " " + getTwoDigits(generator() % 24) + ":" +
+                      getTwoDigits(generator() % 60) + ":" + getTwoDigits(generator() % 60));
+        return row;
+    }
+
+private:
+    std::mt19937_64 generator;
+
+    static std::string getTwoDigits(uint64_t value) {
+        return (value < 10 ? "0" : "") + std::to_string(value);
+    }
+
+    static std::string getDate(int year, int month, int day) {
+        return std::to_string(year) + "-" + getTwoDigits(month) + "-" + getTwoDigits(day);
+    }
+
+    std::string getName() {
+        static const std::vector<std::string> syllables = {"Ka", "Lo", "Mi", "Ne", "Ra", "Su", "To", "Vi", "Da", "Pe"};
+
+        std::string name;
+        size_t length = 2 + generator() % 4;
+        for (size_t index = 0 ; index < length ; index++) name += syllables[generator() % syllables.size()];
+        return name;
+    }
+
+    std::string getCode() {
+        std::string code(8, 'A');
+        for (auto &character : code) character = static_cast<char>('A' + generator() % 26);
+
+        // The scanner reads a value starting with a keyword (FK, PK, ...) as the keyword, so the codes
+        // start with a letter no keyword starts with.
+        code[0] = static_cast<char>('A' + generator() % 5);
+        return code;
+    }
+
+    std::string getBoolean(bool nullable) {
+        uint64_t value = generator() % 10;
+        if (value == 0 && nullable) return "NULL";
+        return value % 2 == 0 ? "True" : "False";
+    }
+};
+
+/**
+ * Gets the time elapsed since a point in time.
+ * @param start Point in time to measure from.
+ * @return Elapsed time in milliseconds.
+ */
+static double elapsedMilliseconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Measures a function, without the output it writes.
+ * @param function Function to measure.
+ * @return Time of the function in milliseconds.
+ */
+static double measure(const std::function<void()> &function) {
+    std::ostringstream discarded;
+    std::streambuf *output = std::cout.rdbuf(discarded.rdbuf());
+
+    auto start = std::chrono::steady_clock::now();
+    function();
+    double time = elapsedMilliseconds(start);
+
+    std::cout.rdbuf(output);
+    return time;
+}
+
+/**
+ * Writes lines to a file.
+ * @param filePath Path of the file.
+ * @param lines Lines to write.
+ */
+static void writeFile(const std::string &filePath, const std::vector<std::string> &lines) {
+    std::ofstream fout(filePath);
+    for (const auto &line : lines) fout << line << '\n';
+}
+
+/**
+ * Writes build lines to a file and executes them.
+ * @param lines Build lines to execute.
+ * @return Time of the execution in milliseconds.
+ */
+static double runBuildLines(const std::vector<std::string> &lines) {
+    writeFile("bench.fqlb", lines);
+    return measure([] { executeCode("bench.fqlb"); });
+}
+
+static std::vector<std::string> buildFetch(const std::string &relation, const std::vector<std::string> &clauses) {
+    std::vector<std::string> lines = {"array:fetched", "fetchRelation:" + relation};
+    lines.insert(lines.end(), clauses.begin(), clauses.end());
+    return lines;
+}
+
+static std::vector<std::string> buildMutations(const std::string &opCode, const std::string &relation,
+                                               size_t rows, size_t statements, const std::string &set) {
+    std::vector<std::string> lines;
+    for (size_t statement = 0 ; statement < statements ; statement++) {
+        // The rows are taken evenly from the whole relation.
+        size_t index = statement * (rows / statements);
+        lines.insert(lines.end(), {opCode + ":" + relation, "where:(== ID \"" + RowGenerator::getUUID(index) + "\")"});
+        if (!set.empty()) lines.push_back("set:" + set);
+    }
+    return lines;
+}
+
+/**
+ * Benchmarks the statements on a relation of a given number of rows.
+ * @param rows Number of rows of the relation.
+ * @param seed Seed of the data generator.
+ * @param results Results the benchmarks are added to.
+ */
+static void benchmarkStatements(size_t rows, unsigned seed, std::vector<BenchmarkResult> &results) {
+    std::string relation = "Items" + std::to_string(rows);
+    runBuildLines({"createRelation:Bench," + relation, "createRelationAttributes:" + relation,
+                   "createAttribute:ID,UUID,PK", "createAttribute:name,varchar(24),NOT NULL",
+                   "createAttribute:code,char(8),NOT NULL", "createAttribute:active,boolean,NULLABLE",
+                   "createAttribute:amount,int,NULLABLE", "createAttribute:created,date,NULLABLE",
+                   "createAttribute:modified,datetime,NULLABLE"});
+
+    RowGenerator generator(seed);
+    std::vector<std::string> lines;
+    lines.reserve(rows * 8);
+    for (size_t index = 0 ; index < rows ; index++) {
+        lines.push_back("addRelation:" + relation);
+        for (const auto &value : generator.getRow(index, false)) lines.push_back("addArgument:" + value);
+    }
+    results.push_back({"add", rows, rows, runBuildLines(lines)});
+    lines.clear();
+
+    results.push_back({"fetch", rows, 1, runBuildLines(buildFetch(relation, {"fetchAttribute:name"}))});
+    results.push_back({"fetch where", rows, 1,
+                       runBuildLines(buildFetch(relation, {"fetchAttribute:name", "where:(== amount \"7\")"}))});
+    results.push_back({"fetch order by", rows, 1,
+                       runBuildLines(buildFetch(relation, {"fetchAttribute:name", "orderBy:amount,desc"}))});
+    results.push_back({"fetch group by", rows, 1,
+                       runBuildLines(buildFetch(relation, {"fetchAttribute:active", "fetchAggregate:sum,amount",
+                                                           "groupBy:active"}))});
+    results.push_back({"concatenate", rows, 1,
+                       runBuildLines(buildFetch(relation, {"fetchAttribute:name", "concatenate: ",
+                                                           "fetchRelation:" + relation, "fetchAttribute:code"}))});
+    results.push_back({"show", rows, 1, runBuildLines({"show:" + relation})});
+
+    // Statements keyed by the PK touch a single row each, a thousand of them are measured.
+    size_t statements = std::min<size_t>(rows, 1000);
+    results.push_back({"update PK", rows, statements,
+                       runBuildLines(buildMutations("updateRelation", relation, rows, statements, "(= amount \"1\")"))});
+    results.push_back({"update non-PK", rows, 1,
+                       runBuildLines({"updateRelation:" + relation, "where:(== amount \"8\")", "set:(= active \"False\")"})});
+    results.push_back({"delete PK", rows, statements,
+                       runBuildLines(buildMutations("deleteRelation", relation, rows, statements, ""))});
+    results.push_back({"delete non-PK", rows, 1, runBuildLines({"deleteRelation:" + relation, "where:(== amount \"9\")"})});
+}
+
+/**
+ * Benchmarks the scan, the parse/build and the execution of a source file that adds the rows of a
+ * data file with addf. The parser reads the data file and turns every line into an add statement.
+ * @param rows Number of rows of the data file.
+ * @param seed Seed of the data generator.
+ * @param results Results the benchmarks are added to.
+ */
+static void benchmarkSourceFile(size_t rows, unsigned seed, std::vector<BenchmarkResult> &results) {
+    std::string schema = "Source" + std::to_string(rows);
+    std::string dataPath = "data" + std::to_string(rows);
+
+    RowGenerator generator(seed + 1);
+    std::vector<std::string> dataLines;
+    dataLines.reserve(rows);
+    for (size_t index = 0 ; index < rows ; index++) {
+        std::string line;
+        for (const auto &value : generator.getRow(index, true)) line += (line.empty() ? "" : ", ") + value;
+        dataLines.push_back(line);
+    }
+    writeFile(dataPath, dataLines);
+    dataLines.clear();
+
+    writeFile("source", {"schema: " + schema, "using: " + schema, "relation: Items", "Items -> {", "    ID,UUID,PK",
+                         "    name,varchar(24),NOT NULL", "    code,char(8),NOT NULL", "    active,boolean,NULLABLE",
+                         "    amount,int,NULLABLE", "    created,date,NULLABLE", "    modified,datetime,NULLABLE", "}",
+                         "Items.addf(" + dataPath + ")"});
+
+    std::vector<std::string> tokens;
+    results.push_back({"scan", rows, 1, measure([&tokens] {
+        std::unordered_set<std::string> scannedFiles;
+        tokens = scanCode("source", scannedFiles);
+    })});
+
+    // The parser writes the build file, which has to exist.
+    writeFile("source.fqlb", {});
+    int built = 0;
+    results.push_back({"parse/build", rows, 1, measure([&] { built = parseCode(tokens, "source.fqlb"); })});
+    if (!built) throw std::runtime_error("The source file of " + std::to_string(rows) + " rows did not build!");
+
+    results.push_back({"addf", rows, 1, measure([] { executeCode("source.fqlb"); })});
+}
+
+/**
+ * Benchmarks the PK index alone: inserts and searches of UUID PKs in the B-tree used by the executor.
+ * @param rows Number of PKs.
+ * @param results Results the benchmarks are added to.
+ */
+static void benchmarkBTree(size_t rows, std::vector<BenchmarkResult> &results) {
+    Uuid uuid;
+    std::vector<Value> PKs;
+    PKs.reserve(rows);
+    for (size_t index = 0 ; index < rows ; index++) PKs.push_back(uuid.decode(RowGenerator::getUUID(index)));
+
+    BTreePKIndex<int64_t> pkIndex(sysconf(_SC_PAGESIZE));
+    results.push_back({"btree insert", rows, rows, measure([&] { for (const auto &PK : PKs) pkIndex.insert(PK); })});
+
+    size_t found = 0;
+    results.push_back({"btree search", rows, rows, measure([&] { for (const auto &PK : PKs) found += pkIndex.search(PK); })});
+    if (found != rows) throw std::runtime_error("The B-tree lost " + std::to_string(rows - found) + " PKs!");
+}
+
+static void writeResults(std::ostream &out, size_t maxRows, unsigned seed, const std::vector<BenchmarkResult> &results) {
+    out << "{\n  \"maxRows\": " << maxRows << ",\n  \"seed\": " << seed << ",\n  \"results\": [";
+    for (size_t index = 0 ; index < results.size() ; index++) {
+        const BenchmarkResult &result = results[index];
+        double seconds = result.time / 1000;
+
+        out << (index == 0 ? "\n" : ",\n") << "    {\"benchmark\": \"" << result.benchmark << "\", \"rows\": "
+            << result.rows << ", \"statements\": " << result.statements << ", \"time_ms\": " << result.time
+            << ", \"statements_per_second\": " << (seconds > 0 ? result.statements / seconds : 0)
+            << ", \"rows_per_second\": " << (seconds > 0 ? result.rows / seconds : 0) << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+int main(int argc, char **argv) {
+    size_t maxRows = argc > 1 ? std::stoul(argv[1]) : 10000;
+    unsigned seed = argc > 2 ? std::stoul(argv[2]) : 42;
+    std::filesystem::path outputPath = argc > 3 ? std::filesystem::absolute(argv[3]) : std::filesystem::path();
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() /
+                                      ("fql_bench_" + std::to_string(getpid()));
+    std::filesystem::create_directories(directory / "DB");
+    std::filesystem::current_path(directory);
+
+    runBuildLines({"createSchema:Bench"});
+
+    std::vector<BenchmarkResult> results;
+    for (size_t rows = 1000 ; rows <= maxRows ; rows *= 10) {
+        std::cerr << "Benchmarking " << rows << " rows" << std::endl;
+        benchmarkStatements(rows, seed, results);
+        benchmarkSourceFile(rows, seed, results);
+        benchmarkBTree(rows, results);
+    }
+
+    std::filesystem::current_path(directory.parent_path());
+    std::filesystem::remove_all(directory);
+
+    if (outputPath.empty()) writeResults(std::cout, maxRows, seed, results);
+    else {
+        std::ofstream fout(outputPath);
+        writeResults(fout, maxRows, seed, results);
+    }
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "../../interpretor/executor/executor.h"
+
+/**
+ * Benchmarks durable commits: the same adds and PK updates are executed once with every statement
+ * in its own transaction (autocommit) and once inside a single explicit transaction, whose writes
+ * are buffered and applied with one write per relation at commit.
+ * The benchmark runs in a temporary directory, which is removed at the end.
+ * Usage: transaction_benchmark [rows] [seed]
+ */
+
+struct BenchmarkResult {
+    size_t transactions;
+    double totalTime;
+};
+
+/**
+ * Gets the time elapsed since a point in time.
+ * @param start Point in time to measure from.
+ * @return Elapsed time in milliseconds.
+ */
+static double elapsedMilliseconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Generates 16 digit UUIDs the same way generateUUID does, but from a fixed seed.
+ * @param number Amount of UUIDs to generate.
+ * @param seed Seed of the generator.
+ * @return The generated UUIDs.
+ */
+static std::vector<std::string> generateUUIDs(size_t number, unsigned seed) {
+    std::mt19937_64 generator(seed);
+    std::vector<std::string> uuids(number);
+
+    for (auto &uuid : uuids) {
+        uuid.resize(16);
+        for (auto &digit : uuid) digit = static_cast<char>('1' + generator() % 9);
+    }
+    return uuids;
+}
+
+/**
+ * Builds the lines of a statement, wrapped in a transaction of its own when autocommitted.
+ * @param lines Build lines the statement is appended to.
+ * @param statement Build lines of the statement.
+ * @param autocommit True if the statement gets its own transaction.
+ */
+static void addStatement(std::vector<std::string> &lines, const std::vector<std::string> &statement, bool autocommit) {
+    if (autocommit) lines.emplace_back("transaction:begin");
+    lines.insert(lines.end(), statement.begin(), statement.end());
+    if (autocommit) lines.emplace_back("transaction:commit");
+}
+
+static std::vector<std::string> buildAdds(const std::string &relation, const std::vector<std::string> &uuids,
+                                          bool autocommit) {
+    std::vector<std::string> lines;
+    if (!autocommit) lines.emplace_back("transaction:begin");
+    for (size_t index = 0 ; index < uuids.size() ; index++) {
+        addStatement(lines, {"addRelation:" + relation, "addArgument:" + uuids[index],
+                             "addArgument:" + std::to_string(index)}, autocommit);
+    }
+    if (!autocommit) lines.emplace_back("transaction:commit");
+    return lines;
+}
+
+static std::vector<std::string> buildUpdates(const std::string &relation, const std::vector<std::string> &uuids,
+                                             bool autocommit) {
+    std::vector<std::string> lines;
+    if (!autocommit) lines.emplace_back("transaction:begin");
+    for (size_t index = 0 ; index < uuids.size() ; index++) {
+        addStatement(lines, {"updateRelation:" + relation, "where:(== ID \"" + uuids[index] + "\")",
+                             "set:(= value \"" + std::to_string(index + 1) + "\")"}, autocommit);
+    }
+    if (!autocommit) lines.emplace_back("transaction:commit");
+    return lines;
+}
+
+/**
+ * Writes build lines to a file and executes them, without the output of the executor.
+ * @param filePath Path of the build file.
+ * @param lines Build lines to execute.
+ * @return Time of the execution in milliseconds.
+ */
+static double runBuildFile(const std::string &filePath, const std::vector<std::string> &lines) {
+    std::ofstream fout(filePath);
+    for (const auto &line : lines) fout << line << '\n';
+    fout.close();
+
+    std::ostringstream discarded;
+    std::streambuf *output = std::cout.rdbuf(discarded.rdbuf());
+
+    auto start = std::chrono::steady_clock::now();
+    executeCode(filePath);
+    double time = elapsedMilliseconds(start);
+
+    std::cout.rdbuf(output);
+    return time;
+}
+
+static void showResult(const std::string &name, size_t rows, const BenchmarkResult &result) {
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(22) << name << std::setw(14) << result.transactions << std::setw(14) << result.totalTime
+              << std::setw(14) << rows / (result.totalTime / 1000) << std::setw(14) << result.totalTime / result.transactions
+              << "\n";
+}
+
+int main(int argc, char **argv) {
+    size_t rowNumber = argc > 1 ? std::stoul(argv[1]) : 2000;
+    unsigned seed = argc > 2 ? std::stoul(argv[2]) : 42;
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() /
+                                      ("fql_transaction_benchmark_" + std::to_string(getpid()));
+    std::filesystem::create_directories(directory / "DB");
+    std::filesystem::current_path(directory);
+
+    // Each mode writes to a relation of its own, declared up front.
+    std::vector<std::string> schemaLines = {"createSchema:Bench"};
+    for (const std::string relation : {"Autocommit", "Batched"}) {
+        schemaLines.insert(schemaLines.end(), {"createRelation:Bench," + relation, "createRelationAttributes:" + relation,
+                                               "createAttribute:ID,UUID,PK", "createAttribute:value,int,NOT NULL"});
+    }
+    runBuildFile("schema.fqlb", schemaLines);
+
+    std::vector<std::string> uuids = generateUUIDs(rowNumber, seed);
+
+    std::cout << "Durable commits (" << rowNumber << " rows)\n";
+    std::cout << std::setw(22) << "workload" << std::setw(14) << "commits" << std::setw(14) << "total(ms)"
+              << std::setw(14) << "rows/s" << std::setw(14) << "ms/commit" << "\n";
+
+    BenchmarkResult result{rowNumber, runBuildFile("adds.fqlb", buildAdds("Autocommit", uuids, true))};
+    showResult("add autocommit", rowNumber, result);
+    result = {1, runBuildFile("adds.fqlb", buildAdds("Batched", uuids, false))};
+    showResult("add transaction", rowNumber, result);
+
+    result = {rowNumber, runBuildFile("updates.fqlb", buildUpdates("Autocommit", uuids, true))};
+    showResult("update autocommit", rowNumber, result);
+    result = {1, runBuildFile("updates.fqlb", buildUpdates("Batched", uuids, false))};
+    showResult("update transaction", rowNumber, result);
+    std::cout << std::endl;
+
+    std::filesystem::current_path(directory.parent_path());
+    std::filesystem::remove_all(directory);
+
+    return 0;
+}
@@ -1,3 +1,27 @@
 #include "Datatype.h"
 
 #include <string>
+
+bool Datatype::isNull(const std::string &value) {
+    return value.empty() || value == "NULL" || value == "Null" || value == "null";
+}
+
+bool Datatype::compareNulls(const std::string &first, const std::string &second, int &result) {
+    bool firstNull = isNull(first);
+    bool secondNull = isNull(second);
+    if (!firstNull && !secondNull) return false;
+
+    if (firstNull && secondNull) result = 0;
+    else result = firstNull ? -1 : 1;
+    return true;
+}
+
+bool Datatype::parseDigits(const std::string &value, size_t start, size_t count, int64_t &result) {
+    if (start + count > value.size()) return false;
+
+    for (size_t index = start ; index < start + count ; index++) {
+        if (value[index] < '0' || value[index] > '9') return false;
+        result = result * 10 + (value[index] - '0');
+    }
+    return true;
+}
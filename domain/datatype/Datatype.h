@@ -3,6 +3,8 @@
 
 #include <string>
 
+#include "../value/Value.h"
+
 /**
  * Using this interface allows the user to specify
  * the datatype of an attribute.
@@ -16,6 +18,49 @@ public:
 
     virtual int getMaxLength() = 0;
     virtual void setMaxLength(int maxLength) = 0;
+
+    /**
+     * Compares two stored values of this data type. NULL values are ordered before any other value.
+     * @param first First stored value.
+     * @param second Second stored value.
+     * @return Negative if first < second, 0 if they are equal, positive otherwise.
+     */
+    virtual int compare(const std::string &first, const std::string &second) = 0;
+
+    /**
+     * Decodes a stored value of this data type into its in-memory representation.
+     * Values that are not valid for the data type are kept as strings.
+     * @param value Stored value.
+     * @return The decoded value, a NULL value if the stored value represents NULL.
+     */
+    virtual Value decode(const std::string &value) = 0;
+
+    /**
+     * Checks whether a stored value represents NULL.
+     * @param value Stored value to check.
+     * @return True if the value is NULL, false otherwise.
+     */
+    static bool isNull(const std::string &value);
+
+protected:
+    /**
+     * Orders two values when at least one of them is NULL.
+     * @param first First stored value.
+     * @param second Second stored value.
+     * @param result Result of the comparison if at least one value is NULL.
+     * @return True if the comparison was decided by a NULL value, false otherwise.
+     */
+    static bool compareNulls(const std::string &first, const std::string &second, int &result);
+
+    /**
+     * Parses a fixed amount of decimal digits of a stored value.
+     * @param value Stored value.
+     * @param start Index of the first digit.
+     * @param count Amount of digits to parse.
+     * @param result Parsed number, accumulated onto its previous value.
+     * @return True if all the characters were digits, false otherwise.
+     */
+    static bool parseDigits(const std::string &value, size_t start, size_t count, int64_t &result);
 };
 
-#endif //FQL_DATATYPE_H
\ No newline at end of file
+#endif //FQL_DATATYPE_H
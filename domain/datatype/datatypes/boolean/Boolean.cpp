@@ -20,4 +20,21 @@ int Boolean::getMaxLength() {
 
 void Boolean::setMaxLength(int newMaxLength) {
     this->maxLength = newMaxLength;
-}
\ No newline at end of file
+}
+
+int Boolean::compare(const std::string &first, const std::string &second) {
+    int result;
+    if (compareNulls(first, second, result)) return result;
+
+    bool firstValue = first == "True" || first == "true" || first == "1";
+    bool secondValue = second == "True" || second == "true" || second == "1";
+    return firstValue - secondValue;
+}
+
+Value Boolean::decode(const std::string &value) {
+    if (isNull(value)) return {};
+
+    if (value == "True" || value == "true" || value == "1") return Value::fromBoolean(true);
+    if (value == "False" || value == "false" || value == "0") return Value::fromBoolean(false);
+    return Value::fromString(value);
+}
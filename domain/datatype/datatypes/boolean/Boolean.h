@@ -16,6 +16,9 @@ public:
 
     int getMaxLength() override;
     void setMaxLength(int newMaxLength) override;
+
+    int compare(const std::string &first, const std::string &second) override;
+    Value decode(const std::string &value) override;
 };
 
 #endif // FQL_BOOLEAN_H
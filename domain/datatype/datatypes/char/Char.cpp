@@ -25,3 +25,15 @@ int Char::getMaxLength() {
 void Char::setMaxLength(int newMaxLength) {
     this->maxLength = newMaxLength;
 }
+
+int Char::compare(const std::string &first, const std::string &second) {
+    int result;
+    if (compareNulls(first, second, result)) return result;
+
+    return first.compare(second);
+}
+
+Value Char::decode(const std::string &value) {
+    if (isNull(value)) return {};
+    return Value::fromString(value);
+}
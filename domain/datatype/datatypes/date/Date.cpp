@@ -21,3 +21,22 @@ int Date::getMaxLength() {
 void Date::setMaxLength(int newMaxLength) {
     this->maxLength = newMaxLength;
 }
+
+int Date::compare(const std::string &first, const std::string &second) {
+    int result;
+    if (compareNulls(first, second, result)) return result;
+
+    // Dates are stored as YYYY-MM-DD, so the lexicographic order is the chronological order.
+    return first.compare(second);
+}
+
+Value Date::decode(const std::string &value) {
+    if (isNull(value)) return {};
+
+    // YYYY-MM-DD is packed as YYYYMMDD.
+    int64_t date = 0;
+    if (value.size() != 10 || value[4] != '-' || value[7] != '-' || !parseDigits(value, 0, 4, date)
+        || !parseDigits(value, 5, 2, date) || !parseDigits(value, 8, 2, date)) return Value::fromString(value);
+
+    return Value::fromDate(date);
+}
@@ -20,3 +20,26 @@ int Datetime::getMaxLength() {
 void Datetime::setMaxLength(int newMaxLength) {
     this->maxLength = newMaxLength;
 }
+
+int Datetime::compare(const std::string &first, const std::string &second) {
+    int result;
+    if (compareNulls(first, second, result)) return result;
+
+    // Datetimes are stored as YYYY-MM-DD hh:mm:ss, so the lexicographic order is the chronological order.
+    return first.compare(second);
+}
+
+Value Datetime::decode(const std::string &value) {
+    if (isNull(value)) return {};
+
+    // YYYY-MM-DD hh:mm:ss is packed as YYYYMMDDhhmmss.
+    int64_t datetime = 0;
+    if (value.size() != 19 || value[4] != '-' || value[7] != '-' || value[10] != ' ' || value[13] != ':'
+        || value[16] != ':' || !parseDigits(value, 0, 4, datetime) || !parseDigits(value, 5, 2, datetime)
+        || !parseDigits(value, 8, 2, datetime) || !parseDigits(value, 11, 2, datetime)
+        || !parseDigits(value, 14, 2, datetime) || !parseDigits(value, 17, 2, datetime)) {
+        return Value::fromString(value);
+    }
+
+    return Value::fromDatetime(datetime);
+}
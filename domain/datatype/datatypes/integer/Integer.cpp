@@ -1,3 +1,6 @@
+#include <cerrno>
+#include <cstdlib>
+
 #include "Integer.h"
 
 Integer::Integer() {
@@ -20,3 +23,23 @@ int Integer::getMaxLength() {
 void Integer::setMaxLength(int newMaxLength) {
     this->maxLength = newMaxLength;
 }
+
+int Integer::compare(const std::string &first, const std::string &second) {
+    int result;
+    if (compareNulls(first, second, result)) return result;
+
+    long long firstValue = std::strtoll(first.c_str(), nullptr, 10);
+    long long secondValue = std::strtoll(second.c_str(), nullptr, 10);
+    return (firstValue > secondValue) - (firstValue < secondValue);
+}
+
+Value Integer::decode(const std::string &value) {
+    if (isNull(value)) return {};
+
+    char *end = nullptr;
+    errno = 0;
+    long long integer = std::strtoll(value.c_str(), &end, 10);
+    if (errno != 0 || end == value.c_str() || *end != '\0') return Value::fromString(value);
+
+    return Value::fromInteger(integer);
+}
@@ -0,0 +1,35 @@
+#include "Uuid.h"
+
+Uuid::Uuid() {
+    this->name = "UUID";
+    this->maxLength = 16;
+}
+
+std::string Uuid::getName() {
+    return this->name;
+}
+
+void Uuid::setName(const std::string &newName) {
+    this->name = newName;
+}
+
+int Uuid::getMaxLength() {
+    return this->maxLength;
+}
+
+void Uuid::setMaxLength(int newMaxLength) {
+    this->maxLength = newMaxLength;
+}
+
+int Uuid::compare(const std::string &first, const std::string &second) {
+    int result;
+    if (compareNulls(first, second, result)) return result;
+
+    // UUIDs always have 16 digits, so the lexicographic order is the numeric order.
+    return first.compare(second);
+}
+
+Value Uuid::decode(const std::string &value) {
+    if (isNull(value)) return {};
+    return Value::fromString(value);
+}
@@ -0,0 +1,24 @@
+#ifndef FQL_UUID_H
+#define FQL_UUID_H
+
+#include "../../Datatype.h"
+
+class Uuid : public Datatype {
+private:
+    std::string name;
+    int maxLength;
+
+public:
+    Uuid();
+
+    std::string getName() override;
+    void setName(const std::string &newName) override;
+
+    int getMaxLength() override;
+    void setMaxLength(int newMaxLength) override;
+
+    int compare(const std::string &first, const std::string &second) override;
+    Value decode(const std::string &value) override;
+};
+
+#endif //FQL_UUID_H
@@ -25,3 +25,15 @@ int Varchar::getMaxLength() {
 void Varchar::setMaxLength(int newMaxLength) {
     this->maxLength = newMaxLength;
 }
+
+int Varchar::compare(const std::string &first, const std::string &second) {
+    int result;
+    if (compareNulls(first, second, result)) return result;
+
+    return first.compare(second);
+}
+
+Value Varchar::decode(const std::string &value) {
+    if (isNull(value)) return {};
+    return Value::fromString(value);
+}
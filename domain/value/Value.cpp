@@ -0,0 +1,182 @@
+#include <cstring>
+#include <string_view>
+
+#include "Value.h"
+
+Value::Value() : type(ValueType::Null), length(0), data() {
+    this->data.number = 0;
+}
+
+Value Value::fromInteger(int64_t integer) {
+    Value value;
+    value.type = ValueType::Integer;
+    value.data.number = integer;
+
+    return value;
+}
+
+Value Value::fromBoolean(bool boolean) {
+    Value value;
+    value.type = ValueType::Boolean;
+    value.data.number = boolean;
+
+    return value;
+}
+
+Value Value::fromDate(int64_t date) {
+    Value value;
+    value.type = ValueType::Date;
+    value.data.number = date;
+
+    return value;
+}
+
+Value Value::fromDatetime(int64_t datetime) {
+    Value value;
+    value.type = ValueType::Datetime;
+    value.data.number = datetime;
+
+    return value;
+}
+
+Value Value::fromString(const std::string &string) {
+    Value value;
+    value.type = ValueType::String;
+
+    if (string.size() <= inlineCapacity) {
+        value.length = static_cast<uint8_t>(string.size());
+        std::memcpy(value.data.characters, string.data(), string.size());
+    }
+    else {
+        value.length = sharedLength;
+        value.shared = std::make_shared<const std::string>(string);
+    }
+
+    return value;
+}
+
+bool Value::isInline() const {
+    return this->length != sharedLength;
+}
+
+ValueType Value::getType() const {
+    return this->type;
+}
+
+bool Value::isNull() const {
+    return this->type == ValueType::Null;
+}
+
+int64_t Value::getInteger() const {
+    if (this->type == ValueType::Null || this->type == ValueType::String) return 0;
+    return this->data.number;
+}
+
+const char *Value::getCharacters() const {
+    if (this->type != ValueType::String) return "";
+    return isInline() ? this->data.characters : this->shared->data();
+}
+
+size_t Value::getLength() const {
+    if (this->type != ValueType::String) return 0;
+    return isInline() ? this->length : this->shared->size();
+}
+
+/**
+ * Writes a number with a fixed amount of digits, padded with zeros.
+ * @param text Text to append the number to.
+ * @param number Number to write.
+ * @param digits Amount of digits to write.
+ */
+static void appendDigits(std::string &text, int64_t number, size_t digits) {
+    std::string part = std::to_string(number);
+    if (part.size() < digits) text.append(digits - part.size(), '0');
+    text += part;
+}
+
+std::string Value::toString() const {
+    std::string text;
+    int64_t number = this->data.number;
+
+    switch (this->type) {
+        case ValueType::Null:
+            return "NULL";
+        case ValueType::Integer:
+            return std::to_string(number);
+        case ValueType::Boolean:
+            return number ? "True" : "False";
+        case ValueType::Date:
+            appendDigits(text, number / 10000, 4);
+            text += "-";
+            appendDigits(text, number / 100 % 100, 2);
+            text += "-";
+            appendDigits(text, number % 100, 2);
+            return text;
+        case ValueType::Datetime:
+            appendDigits(text, number / 10000000000, 4);
+            text += "-";
+            appendDigits(text, number / 100000000 % 100, 2);
+            text += "-";
+            appendDigits(text, number / 1000000 % 100, 2);
+            text += " ";
+            appendDigits(text, number / 10000 % 100, 2);
+            text += ":";
+            appendDigits(text, number / 100 % 100, 2);
+            text += ":";
+            appendDigits(text, number % 100, 2);
+            return text;
+        case ValueType::String:
+            return {getCharacters(), getLength()};
+    }
+
+    return text;
+}
+
+int Value::compare(const Value &other) const {
+    if (this->type != other.type) {
+        if (this->type == ValueType::Null) return -1;
+        if (other.type == ValueType::Null) return 1;
+        return static_cast<int>(this->type) - static_cast<int>(other.type);
+    }
+
+    if (this->type == ValueType::Null) return 0;
+    if (this->type == ValueType::String) {
+        // Copies of a value share their string, which is then equal without comparing it.
+        if (!isInline() && !other.isInline() && this->shared == other.shared) return 0;
+
+        std::string_view first(getCharacters(), getLength());
+        std::string_view second(other.getCharacters(), other.getLength());
+        return first.compare(second);
+    }
+
+    return (this->data.number > other.data.number) - (this->data.number < other.data.number);
+}
+
+size_t Value::hash() const {
+    if (this->type == ValueType::String) {
+        return std::hash<std::string_view>()(std::string_view(getCharacters(), getLength()));
+    }
+
+    return std::hash<int64_t>()(getInteger()) ^ static_cast<size_t>(this->type);
+}
+
+bool Value::operator==(const Value &other) const {
+    return compare(other) == 0;
+}
+
+bool Value::operator!=(const Value &other) const {
+    return compare(other) != 0;
+}
+
+bool Value::operator<(const Value &other) const {
+    return compare(other) < 0;
+}
+
+bool Value::operator>(const Value &other) const {
+    return compare(other) > 0;
+}
+
+std::ostream &operator<<(std::ostream &os, const Value &value) {
+    if (value.getType() == ValueType::String) return os.write(value.getCharacters(), value.getLength());
+    return os << value.toString();
+}
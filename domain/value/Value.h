@@ -0,0 +1,112 @@
+#ifndef FQL_VALUE_H
+#define FQL_VALUE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+
+/**
+ * Type of the value held by a Value.
+ */
+enum class ValueType : uint8_t {
+    Null,
+    Integer,
+    Boolean,
+    Date,
+    Datetime,
+    String
+};
+
+/**
+ * Compact in-memory representation of a stored value. Integers, booleans, dates and
+ * datetimes are packed into a 64-bit integer, dates as YYYYMMDD and datetimes as
+ * YYYYMMDDhhmmss so that the numeric order is the chronological order. Strings of at most
+ * inlineCapacity characters are stored inline, longer ones are allocated once and shared by the
+ * copies of the value, so they are freed with its last copy.
+ */
+class Value {
+public:
+    static constexpr size_t inlineCapacity = 16;
+
+private:
+    // Length of a string that is shared instead of being stored inline.
+    static constexpr uint8_t sharedLength = 0xFF;
+
+    ValueType type;
+    uint8_t length;
+    union {
+        int64_t number;
+        char characters[inlineCapacity];
+    } data;
+    std::shared_ptr<const std::string> shared;
+
+    bool isInline() const;
+
+public:
+    Value();
+
+    static Value fromInteger(int64_t integer);
+    static Value fromBoolean(bool boolean);
+    static Value fromDate(int64_t date);
+    static Value fromDatetime(int64_t datetime);
+    static Value fromString(const std::string &string);
+
+    ValueType getType() const;
+    bool isNull() const;
+
+    /**
+     * Gets the packed integer of an integer, boolean, date or datetime value.
+     * @return The packed integer, 0 for NULL and string values.
+     */
+    int64_t getInteger() const;
+
+    /**
+     * Gets the characters of a string value without copying them.
+     * @return Pointer to the characters of the string.
+     */
+    const char *getCharacters() const;
+
+    /**
+     * Gets the number of characters of a string value.
+     * @return The number of characters, 0 for values that are not strings.
+     */
+    size_t getLength() const;
+
+    /**
+     * Converts the value back to the text it is stored as.
+     * @return The stored text of the value, "NULL" for NULL values.
+     */
+    std::string toString() const;
+
+    /**
+     * Compares two values. NULL values are ordered before any other value and values of
+     * different types are ordered by their type.
+     * @param other Value to compare with.
+     * @return Negative if this < other, 0 if they are equal, positive otherwise.
+     */
+    int compare(const Value &other) const;
+
+    /**
+     * Hashes the value consistently with the equality of values.
+     * @return Hash of the value.
+     */
+    size_t hash() const;
+
+    bool operator==(const Value &other) const;
+    bool operator!=(const Value &other) const;
+    bool operator<(const Value &other) const;
+    bool operator>(const Value &other) const;
+};
+
+std::ostream &operator<<(std::ostream &os, const Value &value);
+
+template<>
+struct std::hash<Value> {
+    size_t operator()(const Value &value) const noexcept {
+        return value.hash();
+    }
+};
+
+#endif //FQL_VALUE_H
@@ -5,13 +5,8 @@
 #include "../../io/io.h"
 
 void buildExecutable(const std::vector<std::string> &builderLines, const std::string &filePath){
-    if (!validFile(filePath)){
-        writeLines(filePath, builderLines);
-    }
-    else{
-        createFile(filePath);
-        writeLines(filePath, builderLines);
-    }
+    if (!validFile(filePath)) createFile(filePath);
+    writeLines(filePath, builderLines);
 }
 
 void buildSchema(std::vector<std::string> &builderLines, const std::string &schema){
@@ -41,6 +36,19 @@ void buildRelationDelete(std::vector<std::string> &builderLines, const std::stri
     builderLines.push_back("where:" + whereExpression);
 }
 
+void buildRelationCompact(std::vector<std::string> &builderLines, const std::string &relation){
+    builderLines.push_back("compactRelation:" + relation);
+}
+
+void buildRelationAnalyze(std::vector<std::string> &builderLines, const std::string &relation){
+    builderLines.push_back("analyzeRelation:" + relation);
+}
+
+void buildRelationCompress(std::vector<std::string> &builderLines, const std::string &relation,
+                           const std::string &level){
+    builderLines.push_back("compressRelation:" + relation + "," + level);
+}
+
 void buildRelationUpdate(std::vector<std::string> &builderLines, const std::string &relation,
                          const std::string &whereExpression, const std::string &setExpression){
     builderLines.push_back("updateRelation:" + relation);
@@ -55,17 +63,41 @@ void buildArray(std::vector<std::string> &builderLines, const std::string &array
 void buildFetch(std::vector<std::string> &builderLines, const std::string &relation,
                 const std::vector<std::string> &attributes){
     builderLines.push_back("fetchRelation:" + relation);
-    for (auto const &attribute : attributes) builderLines.push_back("fetchAttribute:" + attribute);
+    for (auto const &attribute : attributes) {
+        size_t openIndex = attribute.find('(');
+        if (openIndex == std::string::npos) builderLines.push_back("fetchAttribute:" + attribute);
+        else {
+            std::string function = attribute.substr(0, openIndex);
+            std::string argument = attribute.substr(openIndex + 1, attribute.size() - openIndex - 2);
+            builderLines.push_back("fetchAggregate:" + function + (argument.empty() ? "" : "," + argument));
+        }
+    }
 }
 
 void buildWhere(std::vector<std::string> &builderLines, const std::string &whereExpression){
     builderLines.push_back("where:" + whereExpression);
 }
 
+void buildOrderBy(std::vector<std::string> &builderLines, const std::vector<std::string> &orderKeys){
+    for (auto const &orderKey : orderKeys) builderLines.push_back("orderBy:" + orderKey);
+}
+
+void buildGroupBy(std::vector<std::string> &builderLines, const std::vector<std::string> &groupKeys){
+    for (auto const &groupKey : groupKeys) builderLines.push_back("groupBy:" + groupKey);
+}
+
 void buildConcatenate(std::vector<std::string> &builderLines, const std::string &op){
     builderLines.push_back("concatenate:" + op);
 }
 
+void buildTransaction(std::vector<std::string> &builderLines, const std::string &statement){
+    builderLines.push_back("transaction:" + statement);
+}
+
+void buildExplain(std::vector<std::string> &builderLines, const std::string &line){
+    builderLines.push_back("explain:" + line);
+}
+
 void buildShow(std::vector<std::string> &builderLines, const std::string &relation){
     builderLines.push_back("show:" + relation);
 }
@@ -42,6 +42,29 @@ void buildRelationAttributes(std::vector<std::string> &builderLines, const std::
 void buildRelationAdd(std::vector<std::string> &builderLines, const std::string &relation,
                       const std::vector<std::string> &arguments);
 
+/**
+ * Builds the execution lines for the compact method.
+ * @param builderLines Builder lines to save for execution.
+ * @param relation Relation to build.
+ */
+void buildRelationCompact(std::vector<std::string> &builderLines, const std::string &relation);
+
+/**
+ * Builds the execution lines for the analyze method.
+ * @param builderLines Builder lines to save for execution.
+ * @param relation Relation to build.
+ */
+void buildRelationAnalyze(std::vector<std::string> &builderLines, const std::string &relation);
+
+/**
+ * Builds the execution lines for the compress method.
+ * @param builderLines Builder lines to save for execution.
+ * @param relation Relation to build.
+ * @param level Compression level of the relation.
+ */
+void buildRelationCompress(std::vector<std::string> &builderLines, const std::string &relation,
+                           const std::string &level);
+
 /**
  * Builds the execution lines for the delete method.
  * @param builderLines Builder lines to save for execution.
@@ -72,7 +95,7 @@ void buildArray(std::vector<std::string> &builderLines, const std::string &array
  * Builds the execution lines for the fetch method.
  * @param builderLines Builder lines to save for the execution.
  * @param relation Relation to fetch from.
- * @param attributes Attributes to fetch from the relation.
+ * @param attributes Attributes to fetch from the relation, aggregates have the form "function(attribute)".
  */
 void buildFetch(std::vector<std::string> &builderLines, const std::string &relation,
                 const std::vector<std::string> &attributes);
@@ -84,6 +107,20 @@ void buildFetch(std::vector<std::string> &builderLines, const std::string &relat
  */
 void buildWhere(std::vector<std::string> &builderLines, const std::string &whereExpression);
 
+/**
+ * Builds the execution lines for the order by clause of the fetch method.
+ * @param builderLines Builder lines to save for the execution.
+ * @param orderKeys Keys to order by, each of the form "attribute,direction".
+ */
+void buildOrderBy(std::vector<std::string> &builderLines, const std::vector<std::string> &orderKeys);
+
+/**
+ * Builds the execution lines for the group by clause of the fetch method.
+ * @param builderLines Builder lines to save for the execution.
+ * @param groupKeys Attributes to group by.
+ */
+void buildGroupBy(std::vector<std::string> &builderLines, const std::vector<std::string> &groupKeys);
+
 /**
  * Builds the execution lines for the concatenation of arrays.
  * @param builderLines Builder lines to save for the execution.
@@ -91,6 +128,20 @@ void buildWhere(std::vector<std::string> &builderLines, const std::string &where
  */
 void buildConcatenate(std::vector<std::string> &builderLines, const std::string &op);
 
+/**
+ * Builds the execution lines for a begin, commit or rollback statement.
+ * @param builderLines Builder lines to save for the execution.
+ * @param statement Either begin, commit or rollback.
+ */
+void buildTransaction(std::vector<std::string> &builderLines, const std::string &statement);
+
+/**
+ * Builds the execution line that explains the statement following it.
+ * @param builderLines Builder lines to save for the execution.
+ * @param line Line of the explain keyword in the source file.
+ */
+void buildExplain(std::vector<std::string> &builderLines, const std::string &line);
+
 /**
  * Builds the execution lines for the show function for the relations.
  * @param builderLines Builder lines to save for the execution.
@@ -0,0 +1,210 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <filesystem>
+
+#include "cache.h"
+#include "../../io/io.h"
+
+namespace {
+    const std::string scanDirectory = cacheDirectory + "/scan";
+    const std::string buildDirectory = cacheDirectory + "/build";
+
+    bool cacheEnabled = false;
+
+    // Files read by the build that is being parsed, with the hash of their content.
+    std::vector<std::pair<std::string, uint64_t>> buildDependencies;
+
+    std::string toHex(uint64_t hash) {
+        static const char digits[] = "0123456789abcdef";
+        std::string hex(16, '0');
+        for (size_t index = 16 ; index-- > 0 ; hash >>= 4) hex[index] = digits[hash & 0xf];
+        return hex;
+    }
+
+    /**
+     * Gets a stamp of the FQL executable, entries written by another build of FQL are never matched.
+     */
+    const std::string &getExecutableStamp() {
+        static const std::string stamp = [] {
+            std::error_code error;
+            std::filesystem::path executable = std::filesystem::read_symlink("/proc/self/exe", error);
+            if (error) return std::string("unknown");
+
+            auto size = std::filesystem::file_size(executable, error);
+            auto time = std::filesystem::last_write_time(executable, error);
+            if (error) return std::string("unknown");
+            return std::to_string(size) + "," + std::to_string(time.time_since_epoch().count());
+        }();
+        return stamp;
+    }
+
+    /**
+     * Gets the key an entry is stored under, the content together with the stamp of the FQL executable.
+     */
+    std::string getEntryKey(const std::string &content) {
+        return getExecutableStamp() + "\n" + content;
+    }
+
+    std::string getEntryPath(const std::string &directory, const std::string &key) {
+        return directory + "/" + toHex(hashContent(key));
+    }
+
+    std::string joinLines(const std::vector<std::string> &lines) {
+        std::string content;
+        for (const auto &line : lines) {
+            content += line;
+            content += '\n';
+        }
+        return content;
+    }
+
+    std::string readContent(const std::string &filePath) {
+        std::ifstream fin(filePath, std::ios::binary);
+        return {std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>()};
+    }
+
+    /**
+     * Reads the entry stored under a key. The key is kept at the start of the entry as "source:" lines,
+     * an entry stored under another key with the same hash is not used.
+     * @param directory Directory of the entry.
+     * @param key Key of the entry.
+     * @param lines Lines of the entry after its key, set when it is found.
+     * @return True if the entry was found, false otherwise.
+     */
+    bool readEntry(const std::string &directory, const std::string &key, std::vector<std::string> &lines) {
+        std::string entryPath = getEntryPath(directory, key);
+        std::error_code error;
+        if (!std::filesystem::is_regular_file(entryPath, error)) return false;
+
+        std::vector<std::string> entryLines = readLines(entryPath);
+        size_t sourceLines = 0;
+        std::string source;
+        while (sourceLines < entryLines.size() && entryLines[sourceLines].rfind("source:", 0) == 0) {
+            if (sourceLines > 0) source += '\n';
+            source += entryLines[sourceLines].substr(7);
+            sourceLines++;
+        }
+        if (sourceLines == 0 || source != key) return false;
+
+        lines.assign(entryLines.begin() + sourceLines, entryLines.end());
+        // The entry was used, so it is the last one to be removed.
+        std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), error);
+        return true;
+    }
+
+    void removeOldestEntries(const std::string &directory) {
+        std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> entries;
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator(directory, error)) {
+            entries.emplace_back(entry.last_write_time(error), entry.path());
+        }
+        if (entries.size() <= maxCacheEntries) return;
+
+        std::sort(entries.begin(), entries.end());
+        for (size_t index = 0 ; index < entries.size() - maxCacheEntries ; index++) {
+            std::filesystem::remove(entries[index].second, error);
+        }
+    }
+
+    void writeEntry(const std::string &directory, const std::string &key, const std::vector<std::string> &lines) {
+        std::vector<std::string> entryLines;
+        size_t start = 0;
+        while (true) {
+            size_t end = key.find('\n', start);
+            entryLines.push_back("source:" + key.substr(start, end == std::string::npos ? end : end - start));
+            if (end == std::string::npos) break;
+            start = end + 1;
+        }
+        entryLines.insert(entryLines.end(), lines.begin(), lines.end());
+
+        std::string entryPath = getEntryPath(directory, key);
+        std::filesystem::create_directories(directory);
+        createFile(entryPath);
+        writeLines(entryPath, entryLines);
+        removeOldestEntries(directory);
+    }
+}
+
+void setBuildCache(bool enabled) {
+    cacheEnabled = enabled;
+}
+
+uint64_t hashContent(const std::string &content) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char character : content) {
+        hash ^= character;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool loadScannedFile(const std::string &content, std::vector<std::string> &tokens) {
+    if (!cacheEnabled) return false;
+
+    return readEntry(scanDirectory, getEntryKey(content), tokens);
+}
+
+void storeScannedFile(const std::string &content, const std::vector<std::string> &tokens) {
+    if (!cacheEnabled) return;
+
+    writeEntry(scanDirectory, getEntryKey(content), tokens);
+}
+
+bool loadBuild(const std::vector<std::string> &codeLines, std::vector<std::string> &buildLines,
+               std::vector<std::string> &warnings) {
+    buildDependencies.clear();
+    if (!cacheEnabled) return false;
+
+    std::vector<std::string> lines;
+    if (!readEntry(buildDirectory, getEntryKey(joinLines(codeLines)), lines)) return false;
+
+    std::vector<std::string> cachedBuildLines;
+    std::vector<std::string> cachedWarnings;
+    for (const auto &line : lines) {
+        size_t separator = line.find(':');
+        if (separator == std::string::npos) return false;
+
+        std::string kind = line.substr(0, separator);
+        std::string value = line.substr(separator + 1);
+        if (kind == "dependency") {
+            // The path can hold commas, the hash is after the last one.
+            size_t comma = value.rfind(',');
+            if (comma == std::string::npos) return false;
+
+            std::string filePath = value.substr(0, comma);
+            std::error_code error;
+            if (!std::filesystem::is_regular_file(filePath, error) ||
+                toHex(hashContent(readContent(filePath))) != value.substr(comma + 1)) return false;
+        }
+        else if (kind == "warning") cachedWarnings.push_back(value);
+        else if (kind == "build") cachedBuildLines.push_back(value);
+        else return false;
+    }
+
+    buildLines = std::move(cachedBuildLines);
+    warnings = std::move(cachedWarnings);
+    return true;
+}
+
+void addBuildDependency(const std::string &filePath) {
+    if (!cacheEnabled) return;
+
+    buildDependencies.emplace_back(filePath, hashContent(readContent(filePath)));
+}
+
+void storeBuild(const std::vector<std::string> &codeLines, const std::vector<std::string> &buildLines,
+                const std::vector<std::string> &warnings) {
+    if (!cacheEnabled) return;
+
+    std::vector<std::string> lines;
+    lines.reserve(buildDependencies.size() + warnings.size() + buildLines.size());
+    for (const auto &[filePath, hash] : buildDependencies) lines.push_back("dependency:" + filePath + "," + toHex(hash));
+    for (const auto &warning : warnings) lines.push_back("warning:" + warning);
+    for (const auto &buildLine : buildLines) lines.push_back("build:" + buildLine);
+
+    writeEntry(buildDirectory, getEntryKey(joinLines(codeLines)), lines);
+    buildDependencies.clear();
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#ifndef FQL_CACHE_H
+#define FQL_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Directory of the build cache. Scanned files and builds are stored under the hash of their content
+ * and of the FQL executable, so a changed file or a rebuilt FQL never reuses a stale entry. An entry
+ * keeps the content it was stored for and is only used for that exact content, not for another one
+ * with the same hash.
+ */
+const std::string cacheDirectory = ".fql_cache";
+
+/**
+ * Maximum number of entries kept for scanned files and for builds, the least recently used are removed.
+ */
+const size_t maxCacheEntries = 512;
+
+/**
+ * Turns the build cache on or off. It is off unless FQL builds code given on the command line.
+ * @param enabled True to use the cache, false otherwise.
+ */
+void setBuildCache(bool enabled);
+
+/**
+ * Hashes content with 64-bit FNV-1a.
+ * @param content Content to hash.
+ * @return Hash of the content.
+ */
+uint64_t hashContent(const std::string &content);
+
+/**
+ * Gets the tokens of a file that was scanned before with the same content.
+ * @param content Content of the file.
+ * @param tokens Tokens of the file, set when they are cached.
+ * @return True if the tokens were cached, false otherwise.
+ */
+bool loadScannedFile(const std::string &content, std::vector<std::string> &tokens);
+
+/**
+ * Stores the tokens of a scanned file.
+ * @param content Content of the file.
+ * @param tokens Tokens of the file.
+ */
+void storeScannedFile(const std::string &content, const std::vector<std::string> &tokens);
+
+/**
+ * Gets the build lines of code that was built before with the same tokens, as long as the files it
+ * depends on (i.e. the files of addf) did not change. It also starts recording the dependencies of
+ * the build that follows.
+ * @param codeLines Scanned tokens of the code.
+ * @param buildLines Build lines of the code, set when they are cached.
+ * @param warnings Warnings of the build, set when it is cached.
+ * @return True if the build was cached, false otherwise.
+ */
+bool loadBuild(const std::vector<std::string> &codeLines, std::vector<std::string> &buildLines,
+               std::vector<std::string> &warnings);
+
+/**
+ * Records a file read by the build, the build is only reused while the file keeps its content.
+ * @param filePath Path of the file.
+ */
+void addBuildDependency(const std::string &filePath);
+
+/**
+ * Stores a successful build together with its recorded dependencies.
+ * @param codeLines Scanned tokens of the code.
+ * @param buildLines Build lines of the code.
+ * @param warnings Warnings of the build.
+ */
+void storeBuild(const std::vector<std::string> &codeLines, const std::vector<std::string> &buildLines,
+                const std::vector<std::string> &warnings);
+
+#endif //FQL_CACHE_H
@@ -0,0 +1,187 @@
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <stdexcept>
+
+#include "dictionary.h"
+#include "../../io/io.h"
+#include "../transaction/transaction.h"
+
+namespace {
+    /**
+     * Dictionaries of the encoded attributes of a relation, by the index of the attribute in a row.
+     * loadedSize Size of the dictionary file when it was last read or appended to.
+     */
+    struct RelationDictionaries {
+        std::string filePath;
+        uint64_t loadedSize = 0;
+        std::unordered_map<size_t, Dictionary> dictionaries;
+    };
+
+    std::unordered_map<Relation*, RelationDictionaries> relationDictionariesMap;
+
+    size_t findAttributeIndex(Relation *relation, const std::string &attribute) {
+        for (int index = 1 ; index <= relation->getAttributeNumber() ; index++) {
+            if (relation->getAttribute(index)->getName() == attribute) return index;
+        }
+        return 0;
+    }
+
+    std::string formatCode(uint32_t code) {
+        return dictionaryCodeMarker + std::to_string(code);
+    }
+}
+
+uint32_t Dictionary::add(const std::string &value) {
+    auto [codeIt, inserted] = codes.emplace(value, static_cast<uint32_t>(values.size()));
+    if (inserted) values.push_back(value);
+
+    return codeIt->second;
+}
+
+bool Dictionary::find(const std::string &value, uint32_t &code) const {
+    auto codeIt = codes.find(value);
+    if (codeIt == codes.end()) return false;
+
+    code = codeIt->second;
+    return true;
+}
+
+bool Dictionary::getCode(const std::string &token, uint32_t &code) const {
+    if (token.size() < 2 || token.size() > 10 || token[0] != dictionaryCodeMarker) return false;
+
+    uint32_t parsed = 0;
+    for (size_t position = 1 ; position < token.size() ; position++) {
+        if (token[position] < '0' || token[position] > '9') return false;
+        parsed = parsed * 10 + (token[position] - '0');
+    }
+    if (parsed >= values.size()) return false;
+
+    code = parsed;
+    return true;
+}
+
+const std::string &Dictionary::decode(const std::string &token) const {
+    uint32_t code;
+    return getCode(token, code) ? values[code] : token;
+}
+
+const std::string &Dictionary::getValue(uint32_t code) const {
+    return values[code];
+}
+
+size_t Dictionary::size() const {
+    return values.size();
+}
+
+void loadDictionaries(Relation *relation, const std::string &filePath) {
+    auto &relationDictionaries = relationDictionariesMap[relation];
+    relationDictionaries.filePath = filePath;
+
+    uint64_t size = getFileSize(filePath);
+    if (size == relationDictionaries.loadedSize) return;
+
+    // The file only shrinks when the database was removed, the dictionaries are then read again from scratch.
+    if (size < relationDictionaries.loadedSize) relationDictionaries.dictionaries.clear();
+    relationDictionaries.loadedSize = size;
+    if (size == 0) return;
+
+    // The lines already loaded are counted again, only the values past them are added.
+    std::unordered_map<size_t, size_t> readValues;
+    for (const auto &line : readLines(filePath)) {
+        size_t comma = line.find(',');
+        size_t index = findAttributeIndex(relation, line.substr(0, comma));
+        if (index == 0) continue;
+
+        Dictionary &dictionary = relationDictionaries.dictionaries[index];
+        if (comma == std::string::npos) continue;
+        if (readValues[index]++ >= dictionary.size()) dictionary.add(line.substr(comma + 1));
+    }
+}
+
+const Dictionary *findDictionary(Relation *relation, size_t index) {
+    auto relationIt = relationDictionariesMap.find(relation);
+    if (relationIt == relationDictionariesMap.end()) return nullptr;
+
+    auto dictionaryIt = relationIt->second.dictionaries.find(index);
+    return dictionaryIt == relationIt->second.dictionaries.end() ? nullptr : &dictionaryIt->second;
+}
+
+bool hasDictionaries(Relation *relation) {
+    auto relationIt = relationDictionariesMap.find(relation);
+    return relationIt != relationDictionariesMap.end() && !relationIt->second.dictionaries.empty();
+}
+
+void encodeAttributes(Relation *relation, const std::unordered_map<size_t, std::vector<std::string>> &attributeValues) {
+    const std::string filePath = relationDictionariesMap[relation].filePath;
+    std::filesystem::create_directories(std::filesystem::path(filePath).parent_path());
+    if (!validFile(filePath)) createFile(filePath);
+
+    int lock = acquireFileLock(filePath);
+    loadDictionaries(relation, filePath);
+
+    auto &relationDictionaries = relationDictionariesMap[relation];
+    std::vector<std::string> lines;
+    for (const auto &[index, values] : attributeValues) {
+        if (relationDictionaries.dictionaries.contains(index)) continue;
+
+        Dictionary &dictionary = relationDictionaries.dictionaries[index];
+        std::string attribute = relation->getAttribute(static_cast<int>(index))->getName();
+        lines.push_back(attribute);
+        for (const auto &value : values) {
+            uint32_t code;
+            if (Datatype::isNull(value) || dictionary.find(value, code)) continue;
+
+            dictionary.add(value);
+            lines.push_back(attribute + "," + value);
+        }
+    }
+    for (const auto &line : lines) relationDictionaries.loadedSize += line.size() + 1;
+    appendLines(filePath, lines);
+    recordWrittenFile(filePath);
+    releaseFileLock(lock);
+}
+
+std::string encodeValue(Relation *relation, size_t index, const std::string &value) {
+    const Dictionary *dictionary = findDictionary(relation, index);
+    if (dictionary == nullptr || Datatype::isNull(value)) return value;
+    if (value[0] == dictionaryCodeMarker) {
+        throw std::runtime_error("Value of " + relation->getAttribute(static_cast<int>(index))->getName() +
+                                 " can not start with the dictionary code marker!");
+    }
+
+    uint32_t code;
+    if (dictionary->find(value, code)) return formatCode(code);
+
+    // Another process may have added the value since the dictionary was loaded, it is read again under the lock.
+    auto &relationDictionaries = relationDictionariesMap[relation];
+    int lock = acquireFileLock(relationDictionaries.filePath);
+    loadDictionaries(relation, relationDictionaries.filePath);
+
+    auto dictionaryIt = relationDictionaries.dictionaries.find(index);
+    if (dictionaryIt == relationDictionaries.dictionaries.end()) {
+        releaseFileLock(lock);
+        return value;
+    }
+
+    Dictionary &lockedDictionary = dictionaryIt->second;
+    if (!lockedDictionary.find(value, code)) {
+        std::string line = relation->getAttribute(static_cast<int>(index))->getName() + "," + value;
+        appendLines(relationDictionaries.filePath, {line});
+        recordWrittenFile(relationDictionaries.filePath);
+        relationDictionaries.loadedSize += line.size() + 1;
+        code = lockedDictionary.add(value);
+    }
+    releaseFileLock(lock);
+
+    return formatCode(code);
+}
+
+void decodeRow(Relation *relation, std::vector<std::string> &row) {
+    auto relationIt = relationDictionariesMap.find(relation);
+    if (relationIt == relationDictionariesMap.end()) return;
+
+    for (const auto &[index, dictionary] : relationIt->second.dictionaries) {
+        if (index < row.size()) row[index] = dictionary.decode(row[index]);
+    }
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#ifndef FQL_DICTIONARY_H
+#define FQL_DICTIONARY_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "../../domain/relation/Relation.h"
+
+/**
+ * Highest share of distinct values (distinct values divided by rows) of a char or varchar attribute
+ * that is dictionary encoded by analyze.
+ */
+const double dictionaryDistinctRatio = 0.1;
+
+/**
+ * Least amount of rows a relation needs before analyze encodes any of its attributes.
+ */
+const size_t dictionaryMinimumRows = 256;
+
+/**
+ * Byte written before the code of an encoded value, so a code is never mistaken for a value made of
+ * digits. Values starting with it can not be stored in an encoded attribute.
+ */
+const char dictionaryCodeMarker = '\x1F';
+
+/**
+ * Dictionary of a dictionary encoded attribute. The rows of the relation hold the code of the value
+ * (its position in the dictionary, written in decimal after dictionaryCodeMarker) instead of the value
+ * itself, NULL is kept as it is. Codes are never reused or removed, so a code keeps its value for the lifetime of the relation.
+ */
+class Dictionary {
+private:
+    std::vector<std::string> values;
+    std::unordered_map<std::string, uint32_t> codes;
+
+public:
+    /**
+     * Adds a value to the dictionary.
+     * @param value Value to add.
+     * @return Code of the value, the one it already had if it was in the dictionary.
+     */
+    uint32_t add(const std::string &value);
+
+    /**
+     * Finds the code of a value.
+     * @param value Value to look for.
+     * @param code Code of the value, set when it is found.
+     * @return True if the value is in the dictionary, false otherwise.
+     */
+    bool find(const std::string &value, uint32_t &code) const;
+
+    /**
+     * Reads the code held by a token of a row.
+     * @param token Token of the encoded attribute in a row.
+     * @param code Code held by the token, set when it holds one.
+     * @return True if the token is a code of the dictionary, false if it is a value (NULL, or a value
+     * decoded before) or a code added after the dictionary was loaded.
+     */
+    bool getCode(const std::string &token, uint32_t &code) const;
+
+    /**
+     * Decodes a token of a row.
+     * @param token Token of the encoded attribute in a row.
+     * @return Value of the code held by the token, the token itself if it does not hold one.
+     */
+    const std::string &decode(const std::string &token) const;
+
+    /**
+     * Gets the value of a code.
+     * @param code Code of the dictionary.
+     * @return Value of the code.
+     */
+    const std::string &getValue(uint32_t code) const;
+
+    /**
+     * Gets the amount of values of the dictionary.
+     * @return Amount of values, every code is lower than it.
+     */
+    size_t size() const;
+};
+
+/**
+ * Loads the dictionaries of the encoded attributes of a relation, or the values added to them since
+ * they were last loaded. The dictionaries of a relation are kept in a single file that is only ever
+ * appended to: a line with the name of an attribute starts its encoding and every "attribute,value"
+ * line adds the next code of the attribute.
+ * @param relation Relation the dictionaries belong to.
+ * @param filePath Path of the dictionary file of the relation, which may not exist.
+ */
+void loadDictionaries(Relation *relation, const std::string &filePath);
+
+/**
+ * Finds the dictionary of an attribute, among the ones last loaded.
+ * @param relation Relation the attribute is in.
+ * @param index Index of the attribute in a row (1 is the first attribute).
+ * @return Dictionary of the attribute, nullptr if the attribute is not encoded.
+ */
+const Dictionary *findDictionary(Relation *relation, size_t index);
+
+/**
+ * Checks whether any attribute of a relation is encoded.
+ * @param relation Relation to check.
+ * @return True if the relation has dictionaries, false otherwise.
+ */
+bool hasDictionaries(Relation *relation);
+
+/**
+ * Starts encoding attributes of a relation, with a single write of the dictionary file. The rows
+ * already written still hold the values, they have to be rewritten with encodeValue.
+ * @param relation Relation the attributes are in.
+ * @param attributeValues Values every attribute starts with, by the index of the attribute in a row.
+ * The attributes that are already encoded are skipped.
+ */
+void encodeAttributes(Relation *relation, const std::unordered_map<size_t, std::vector<std::string>> &attributeValues);
+
+/**
+ * Encodes a value before it is written to a row. A value that is not in the dictionary yet is added to
+ * it and to the dictionary file, under a lock of the file, so writers of other processes agree on the codes.
+ * @param relation Relation the row is in.
+ * @param index Index of the attribute in the row.
+ * @param value Value to encode.
+ * @return Token to write: the code of the value, or the value itself if it is NULL or the attribute
+ * is not encoded.
+ */
+std::string encodeValue(Relation *relation, size_t index, const std::string &value);
+
+/**
+ * Decodes the tokens of the encoded attributes of a row in place.
+ * @param relation Relation the row is in.
+ * @param row Tokens of the row, the RID first and then the attributes in declaration order.
+ */
+void decodeRow(Relation *relation, std::vector<std::string> &row);
+
+#endif //FQL_DICTIONARY_H
@@ -1,9 +1,11 @@
 #include <string>
 #include <vector>
+#include <unordered_set>
 #include <iostream>
 #include <unistd.h>
 #include <chrono>
 #include <filesystem>
+#include <optional>
 
 #include "executor.h"
 #include "../../utils/algorithms/algorithms.h"
@@ -15,32 +17,70 @@
 #include "../../domain/datatype/datatypes/datetime/Datetime.h"
 #include "../../domain/datatype/datatypes/integer/Integer.h"
 #include "../../domain/datatype/datatypes/varchar/Varchar.h"
+#include "../../domain/datatype/datatypes/uuid/Uuid.h"
 #include "../../ui/ui.h"
-#include "../../utils/data_structures/BTree/BTree.h"
+#include "../../utils/data_structures/PKIndex/PKIndex.h"
+#include "../operators/sort/sort.h"
+#include "../operators/aggregate/aggregate.h"
+#include "../transaction/transaction.h"
+#include "../explain/explain.h"
+#include "../../utils/metrics/metrics.h"
 
 std::vector<Schema*> schemas;
 std::vector<Relation*> relations;
 
-std::unordered_map<std::string, std::vector<std::string>> relationPKMap;
-std::unordered_map<Relation*, BTree<std::string>*> relationBTreeMap;
-std::unordered_map<Relation*, std::unordered_map<std::string, std::string>> relationPKLineMap;
+std::unordered_map<Relation*, PKIndex*> relationBTreeMap;
+std::unordered_map<Relation*, std::unordered_map<Value, RowLocator>> relationPKLineMap;
+std::unordered_map<Relation*, size_t> relationDeadRowMap;
+std::unordered_map<Relation*, size_t> relationUnversionedRowMap;
+std::unordered_map<Relation*, size_t> relationNewerRowMap;
+std::unordered_map<Relation*, std::pair<uint64_t, uint64_t>> relationFileStateMap;
+// Statistics of the relations, std::nullopt for a relation that was never analyzed.
+std::unordered_map<Relation*, std::optional<RelationStatistics>> relationStatisticsMap;
+size_t savedMutationPasses = 0;
+
+bool explicitTransaction = false;
+std::vector<Relation*> pendingRelations;
+std::unordered_map<Relation*, std::vector<PendingWrite>> relationPendingWriteMap;
+std::unordered_set<Relation*> transactionRelations;
 
 std::vector<std::string> arrays;
-std::unordered_map<std::string, std::unordered_map<size_t, std::vector<std::string>>> arrayElementsMap;
+std::unordered_map<std::string, std::unordered_map<size_t, std::vector<Value>>> arrayElementsMap;
 
 int executeCode(const std::string &filePath) {
+    return executeCode(readLines(filePath));
+}
+
+int executeCode(const std::vector<std::string> &codeLines) {
     using namespace std::chrono;
     auto start = high_resolution_clock::now();
 
-    std::vector<std::string> codeLines = readLines(filePath);
+    // The whole execution is a single transaction, it sees the rows committed before it started.
+    beginTransaction();
 
     int index = 0;
+    try {
     while (index < codeLines.size()){
         auto tokens = split(codeLines[index], ":");
         std::string opCode = tokens[0];
         std::string command = tokens[1];
 
-        if (opCode == "createSchema") index = executeSchema(index, codeLines);
+        if (opCode == "explain") {
+            explainNextStatement();
+            index++;
+            continue;
+        }
+        OpcodeTimer opCodeTimer(opCode);
+        beginStatement(codeLines[index]);
+
+        // Reads see the writes of their own transaction, so the buffered writes are applied first.
+        if (opCode == "array" || opCode == "show" || opCode == "showSchema" || opCode == "compactRelation"
+            || opCode == "analyzeRelation" || opCode == "compressRelation") {
+            flushPendingWrites();
+        }
+
+        if (opCode == "transaction") index = executeTransaction(index, codeLines);
+        else if (opCode == "createSchema") index = executeSchema(index, codeLines);
         else if (opCode == "createRelation") index = executeRelation(index, codeLines);
         else if (opCode == "createRelationAttributes") index = executeRelationAttributes(index, codeLines);
         else if (opCode == "array") index = executeArray(index, codeLines);
@@ -49,6 +89,28 @@ int executeCode(const std::string &filePath) {
         else if (opCode == "showArray") index = executeShowArray(index, codeLines);
         else if (isMethodCall(opCode)) index = executeMethodCall(index, codeLines);
         else index++;
+
+        endStatement();
+    }
+    }
+    catch (...) {
+        // The writes of the failed transaction are discarded, so a session can go on with the next statement.
+        rollbackWrites();
+        explicitTransaction = false;
+        throw;
+    }
+
+    // A transaction that was begun but never committed is rolled back, like one that failed.
+    if (explicitTransaction) rollbackWrites();
+    else commitWrites();
+
+    // Old versions are reclaimed in a transaction of their own, once the versions replacing them are committed.
+    beginTransaction();
+    compactRelations();
+    commitTransaction();
+
+    if (savedMutationPasses > 0) {
+        std::cout << "Batched updates and deletes saved " << savedMutationPasses << " pass(es) over relation files" << std::endl;
     }
 
     auto end = high_resolution_clock::now();
@@ -78,7 +140,8 @@ int executeRelation(int index, const std::vector<std::string> &codeLines) {
     schema->addRelation(newRelation);
 
     relations.push_back(newRelation);
-    updateRID(relationName, getRID(relationName));
+    // Only a new relation gets a RID entry, rewriting an existing one could undo the inserts of another writer.
+    if (getRID(relationName) < 0) updateRID(relationName, 0);
     updateRelationPKLineMap(newRelation, schemaName, relationName);
 
     return index + 1;
@@ -91,17 +154,16 @@ int executeRelationAttributes(int index, const std::vector<std::string> &codeLin
 
     Relation *relation = getRelation(relationName);
     if (relationAlreadyDeclared(relation)) {
-        relationPKMap[relationName] = getRelationPK(relation);
         buildRelationBTree(relation);
 
-        tokens = split(codeLines[index], ":");
+        tokens = getBuildLineTokens(index, codeLines);
         while (tokens[0] == "createAttribute"){
             index++;
-            tokens = split(codeLines[index], ":");
+            tokens = getBuildLineTokens(index, codeLines);
         }
         return index;
     }
-    tokens = split(codeLines[index], ":");
+    tokens = getBuildLineTokens(index, codeLines);
 
     std::string schemaName = getSchemaFromRelation(relation)->getName();
     std::string relationFilePath = "DB/" + schemaName + "/" + "relationAttributes";
@@ -110,9 +172,9 @@ int executeRelationAttributes(int index, const std::vector<std::string> &codeLin
 
     while (tokens[0] == "createAttribute"){
         auto attributeTokens = split(tokens[1], ":");
-        std::string attributeName = split(attributeTokens[0], ",")[0];
-        std::string attributeDataType = split(attributeTokens[0], ",")[1];
-        std::string attributeConstraint = split(attributeTokens[0], ",")[2];
+        std::string attributeName = trim(split(attributeTokens[0], ",")[0]);
+        std::string attributeDataType = trim(split(attributeTokens[0], ",")[1]);
+        std::string attributeConstraint = trim(split(attributeTokens[0], ",")[2]);
 
         Datatype *datatype = getDataType(attributeDataType);
         auto *newAttribute = new Attribute(attributeName, datatype, attributeConstraint);
@@ -121,10 +183,9 @@ int executeRelationAttributes(int index, const std::vector<std::string> &codeLin
         writeLine(relationFilePath, tokens[1]);
 
         index++;
-        tokens = split(codeLines[index], ":");
+        tokens = getBuildLineTokens(index, codeLines);
     }
 
-    relationPKMap[relationName] = getRelationPK(relation);
     relation->storeRelation(getSchemaFromRelation(relation)->getName());
 
     buildRelationBTree(relation);
@@ -132,9 +193,16 @@ int executeRelationAttributes(int index, const std::vector<std::string> &codeLin
     return index;
 }
 
+std::vector<std::string> getBuildLineTokens(size_t index, const std::vector<std::string> &codeLines){
+    if (index >= codeLines.size()) return {""};
+
+    return split(codeLines[index], ":");
+}
+
 bool isMethodCall(const std::string &method){
     if (method == "addRelation" || method == "updateRelation" || method == "deleteRelation"
-        || method == "fetchRelation") return true;
+        || method == "fetchRelation" || method == "compactRelation" || method == "analyzeRelation"
+        || method == "compressRelation") return true;
 
     return false;
 }
@@ -143,107 +211,409 @@ int executeMethodCall(int index, const std::vector<std::string> &codeLines){
     auto tokens = split(codeLines[index], ":");
 
     if (tokens[0] == "addRelation") return executeAddRelation(index, codeLines);
-    else if (tokens[0] == "updateRelation") return executeUpdateRelation(index, codeLines);
-    else if (tokens[0] == "deleteRelation") return executeDeleteRelation(index, codeLines);
+    else if (tokens[0] == "updateRelation" || tokens[0] == "deleteRelation") return executeMutationRun(index, codeLines);
+    else if (tokens[0] == "compactRelation") return executeCompactRelation(index, codeLines);
+    else if (tokens[0] == "analyzeRelation") return executeAnalyzeRelation(index, codeLines);
+    else if (tokens[0] == "compressRelation") return executeCompressRelation(index, codeLines);
     else return index + 1;
 }
 
+int executeTransaction(int index, const std::vector<std::string> &codeLines){
+    std::string statement = split(codeLines[index], ":")[1];
+
+    if (statement == "begin") {
+        if (explicitTransaction) throw std::runtime_error("A transaction is already running!");
+
+        // The statements before the begin are committed on their own.
+        commitWrites();
+        explicitTransaction = true;
+    }
+    else if (statement == "commit") {
+        commitWrites();
+        explicitTransaction = false;
+    }
+    else if (statement == "rollback") {
+        rollbackWrites();
+        explicitTransaction = false;
+    }
+
+    beginTransaction();
+    return index + 1;
+}
+
+void commitWrites(){
+    flushPendingWrites();
+    commitTransaction();
+    transactionRelations.clear();
+}
+
+void rollbackWrites(){
+    for (auto *relation : pendingRelations) relationPendingWriteMap[relation].clear();
+    pendingRelations.clear();
+    abortTransaction();
+
+    // The PK index and the locators were changed by the writes, they are rebuilt from the committed rows.
+    for (auto *relation : transactionRelations) {
+        updateRelationPKLineMap(relation, getSchemaFromRelation(relation)->getName(), relation->getName());
+        buildRelationBTree(relation);
+    }
+    transactionRelations.clear();
+}
+
+void bufferWrite(Relation *relation, PendingWrite write){
+    auto &writes = relationPendingWriteMap[relation];
+    if (writes.empty()) pendingRelations.push_back(relation);
+
+    beginOperator(write.isAdd ? "add" : write.mutation.isDelete ? "delete" : "update", relation->getName(),
+                  AccessPath::Buffered);
+    writes.push_back(std::move(write));
+    endOperator();
+}
+
+void flushPendingWrites(Relation *relation){
+    auto &pendingWrites = relationPendingWriteMap[relation];
+    if (pendingWrites.empty()) return;
+
+    std::vector<PendingWrite> writes = std::move(pendingWrites);
+    pendingWrites.clear();
+
+    beginOperator("flush", relation->getName(), AccessPath::Buffered);
+    addRowsExamined(writes.size());
+
+    // Consecutive adds are appended with a single write and consecutive updates and deletes share a
+    // single pass, so a relation is usually written once per transaction.
+    size_t index = 0;
+    while (index < writes.size()){
+        std::vector<std::string> rows;
+        std::vector<std::string> PKs;
+        for ( ; index < writes.size() && writes[index].isAdd ; index++){
+            rows.push_back(std::move(writes[index].row));
+            PKs.push_back(std::move(writes[index].PK));
+        }
+        appendRows(relation, rows, PKs);
+
+        std::vector<Mutation> run;
+        for ( ; index < writes.size() && !writes[index].isAdd && !writes[index].mutation.where.isKeyedByPK ; index++){
+            run.push_back(std::move(writes[index].mutation));
+        }
+        applyMutationRun(run);
+
+        std::vector<Mutation> PKMutations;
+        for ( ; index < writes.size() && !writes[index].isAdd && writes[index].mutation.where.isKeyedByPK ; index++){
+            PKMutations.push_back(std::move(writes[index].mutation));
+        }
+        applyPKMutations(relation, PKMutations);
+    }
+    endOperator();
+}
+
+void applyPKMutations(Relation *relation, const std::vector<Mutation> &mutations){
+    if (mutations.empty()) return;
+    if (mutations.size() == 1) {
+        executeMutation(mutations[0]);
+        return;
+    }
+
+    beginOperator("update/delete batch", relation->getName(), AccessPath::PKPointLookup);
+    std::string filePath = lockRelation(relation);
+    auto *btree = relationBTreeMap[relation];
+    int PKIndex = getRelationPKIndex(relation);
+
+    // New versions of the rows in the order they were first changed, found by their current PK.
+    std::vector<std::vector<std::string>> newRows;
+    std::unordered_map<Value, size_t> newRowIndexes;
+    std::vector<std::pair<uint64_t, std::string>> endedRows;
+
+    for (const auto &mutation : mutations){
+        Value PK = decodePK(relation, mutation.where.PK);
+
+        auto newRowIndex = newRowIndexes.find(PK);
+        if (newRowIndex == newRowIndexes.end()) {
+            const RowLocator *locator = getPKLocator(relation, mutation.where.PK);
+            if (!btree->search(PK) || locator == nullptr) continue;
+
+            std::string line = readLineAt(filePath, locator->offset);
+            auto tokens = split(line, ",");
+            if (!mutation.where.residual.matches(tokens)) continue;
+
+            endedRows.emplace_back(locator->offset, line);
+            relationPKLineMap[relation].erase(PK);
+
+            newRows.push_back(std::move(tokens));
+            newRowIndex = newRowIndexes.emplace(PK, newRows.size() - 1).first;
+        }
+        else if (!mutation.where.residual.matches(newRows[newRowIndex->second])) continue;
+
+        std::vector<std::string> &tokens = newRows[newRowIndex->second];
+        if (mutation.isDelete) {
+            tokens.clear();
+            newRowIndexes.erase(newRowIndex);
+            btree->remove(PK);
+            continue;
+        }
+
+        std::string oldPK = tokens[PKIndex];
+        for (const auto &[attributeIndex, value] : mutation.attributeValueMap){
+            if (attributeIndex < tokens.size()) tokens[attributeIndex] = value;
+        }
+
+        size_t rowIndex = newRowIndex->second;
+        newRowIndexes.erase(newRowIndex);
+        newRowIndexes[decodePK(relation, tokens[PKIndex])] = rowIndex;
+        updatePKIndexForRow(relation, oldPK, tokens[PKIndex]);
+    }
+
+    // The old versions are ended with a single write and the new ones are appended with another.
+    endRowVersions(filePath, endedRows);
+    relationDeadRowMap[relation] += endedRows.size();
+
+    uint64_t offset = getFileSize(filePath);
+    std::vector<std::string> lines;
+    for (const auto &tokens : newRows){
+        if (tokens.empty()) continue;
+
+        std::string line = stampRow(join(tokens, ","));
+        addPKLineToRelationMap(relation, tokens[PKIndex], RowLocator{offset, static_cast<uint32_t>(line.size())});
+        offset += line.size() + 1;
+        lines.push_back(std::move(line));
+    }
+    appendLines(filePath, lines);
+    updateRelationFileState(relation, filePath);
+
+    addRowsExamined(endedRows.size());
+    addRowsProduced(endedRows.size());
+    endOperator();
+}
+
+void flushPendingWrites(){
+    std::vector<Relation*> relationsToFlush = std::move(pendingRelations);
+    pendingRelations.clear();
+
+    for (auto *relation : relationsToFlush) flushPendingWrites(relation);
+}
+
+void appendRows(Relation *relation, const std::vector<std::string> &rows, const std::vector<std::string> &PKs){
+    if (rows.empty()) return;
+
+    beginOperator("add", relation->getName(), AccessPath::Append);
+    std::string filePath = lockRelation(relation);
+    int RID = getRID(relation->getName());
+    uint64_t offset = getFileSize(filePath);
+
+    std::vector<std::string> entries;
+    entries.reserve(rows.size());
+    for (size_t index = 0 ; index < rows.size() ; index++){
+        std::string entry = stampRow(std::to_string(RID + index) + "," + rows[index]);
+        addPKLineToRelationMap(relation, PKs[index], RowLocator{offset, static_cast<uint32_t>(entry.size())});
+        offset += entry.size() + 1;
+        entries.push_back(std::move(entry));
+    }
+
+    appendLines(filePath, entries);
+    updateRelationFileState(relation, filePath);
+    updateRID(relation->getName(), RID + static_cast<int>(rows.size()));
+
+    addRowsProduced(rows.size());
+    endOperator();
+}
+
 int executeAddRelation(int index, const std::vector<std::string> &codeLines) {
     auto tokens = split(codeLines[index], ":");
     std::string relation = tokens[1];
-    std::string entry = std::to_string(getRID(relation)) + ",";
+    lockRelation(getRelation(relation));
+    refreshDictionaries(getRelation(relation));
+
+    // The PK index has to reflect the buffered updates and deletes before a new PK is checked against it.
+    auto &pendingWrites = relationPendingWriteMap[getRelation(relation)];
+    if (!pendingWrites.empty() && !pendingWrites.back().isAdd) flushPendingWrites(getRelation(relation));
+
+    std::string entry;
     int PKIndex = getRelationPKIndex(getRelation(relation));
     std::string PK;
     index++;
 
     int currentIndex = 1;
-    tokens = split(codeLines[index], ":");
+    tokens = getBuildLineTokens(index, codeLines);
 
     while (tokens[0] == "addArgument") {
-        std::string value = tokens[1];
+        // Datetime values hold ':' themselves, so the value is everything after the opcode.
+        std::string value = codeLines[index].substr(codeLines[index].find(':') + 1);
         if (value == "rand") value = generateUUID();
 
         if (currentIndex == PKIndex) {
-            if (std::find(relationPKMap[relation].begin(), relationPKMap[relation].end(), value) != relationPKMap[relation].end()) {
+            if (relationBTreeMap[getRelation(relation)]->search(decodePK(getRelation(relation), value))) {
                 std::cout << "Warning: Duplicate primary key detected: " << value << std::endl;
-                addPKLineToRelationMap(getRelation(relation), PK, entry);
 
                 while (tokens[0] == "addArgument"){
                     index++;
-                    tokens = split(codeLines[index], ":");
+                    tokens = getBuildLineTokens(index, codeLines);
                 }
 
                 return index;
             }
 
-            relationPKMap[relation].push_back(value);
             updateRelationBTree(getRelation(relation), value);
             PK = value;
         }
-        entry += (split(codeLines[index + 1], ":")[0] == "addArgument") ? value + "," : value;
+        value = encodeValue(getRelation(relation), currentIndex, value);
+        entry += (getBuildLineTokens(index + 1, codeLines)[0] == "addArgument") ? value + "," : value;
 
         index++;
-        tokens = split(codeLines[index], ":");
+        tokens = getBuildLineTokens(index, codeLines);
         currentIndex++;
     }
 
-    std::string filePath = "DB/" + getSchemaFromRelation(getRelation(relation))->getName() + "/relations/" + relation;
-    writeLine(filePath, entry);
-    addPKLineToRelationMap(getRelation(relation), PK, entry);
-    updateRID(relation, getRID(relation) + 1);
+    if (explicitTransaction) {
+        PendingWrite write;
+        write.isAdd = true;
+        write.row = entry;
+        write.PK = PK;
+        bufferWrite(getRelation(relation), std::move(write));
+    }
+    else appendRows(getRelation(relation), {entry}, {PK});
 
     return index;
 }
 
 int executeUpdateRelation(int index, const std::vector<std::string> &codeLines){
+    Mutation mutation;
+    index = readMutation(index, codeLines, mutation);
+    executeMutation(mutation);
+
+    return index;
+}
+
+int executeCompactRelation(int index, const std::vector<std::string> &codeLines){
     auto tokens = split(codeLines[index], ":");
-    std::string relation = tokens[1];
-    index++;
+    compactRelation(getRelation(tokens[1]));
 
-    tokens = split(codeLines[index], ":");
-    std::string expression = tokens[1];
-    std::vector<std::string> expressionTokens = tokenizeExpression(getRelation(relation), expression);
-    index++;
+    return index + 1;
+}
 
-    tokens = split(codeLines[index], ":");
-    std::string statement = tokens[1];
-    std::vector<std::string> statementTokens = tokenizeExpression(getRelation(relation), statement);
+int executeAnalyzeRelation(int index, const std::vector<std::string> &codeLines){
+    auto tokens = split(codeLines[index], ":");
+    analyzeRelation(getRelation(tokens[1]));
 
-    if (isPKQueried(getRelation(relation), expressionTokens)){
-        std::vector<std::string> info = getPKQueryInformation(getRelation(relation), expressionTokens);
-        handlePKInfoForUpdate(getRelation(relation), info,
-                              getAttributeValueMap(getRelation(relation), statementTokens));
-    }
-    else{
-        std::vector<std::string> validExpressions = getValidExpressions(expressionTokens);
-        std::string filePath = "DB/" + getSchemaFromRelation(getRelation(relation))->getName() + "/relations/" + relation;
-        updateLinesByNonPK(filePath, getRelation(relation), validExpressions,
-                           getAttributeValueMap(getRelation(relation), statementTokens));
-    }
+    return index + 1;
+}
 
-    return index;
+int executeCompressRelation(int index, const std::vector<std::string> &codeLines){
+    auto tokens = split(split(codeLines[index], ":")[1], ",");
+    Relation *relation = getRelation(tokens[0]);
+    setCompressionLevel(relation, std::stoi(tokens[1]));
+
+    // Writing the locked relation decompresses it, it is then written with the new level.
+    std::string filePath = lockRelation(relation);
+    rewriteRelation(relation, filePath, getCompressionLevel(relation));
+
+    return index + 1;
 }
 
 int executeDeleteRelation(int index, const std::vector<std::string> &codeLines){
+    Mutation mutation;
+    index = readMutation(index, codeLines, mutation);
+    executeMutation(mutation);
+
+    return index;
+}
+
+int readMutation(int index, const std::vector<std::string> &codeLines, Mutation &mutation){
     auto tokens = split(codeLines[index], ":");
-    std::string relation = tokens[1];
+    mutation.isDelete = tokens[0] == "deleteRelation";
+    mutation.relation = getRelation(tokens[1]);
+    index++;
+
+    // Constants can hold ':' themselves, so the clause is everything after the opcode.
+    std::string whereText = codeLines[index].substr(codeLines[index].find(':') + 1);
+    mutation.where = compileWhereClause(mutation.relation, whereText, false);
     index++;
 
-    tokens = split(codeLines[index], ":");
-    std::string expression = tokens[1];
-    std::vector<std::string> expressionTokens = tokenizeExpression(getRelation(relation), expression);
+    if (!mutation.isDelete) {
+        std::string setText = codeLines[index].substr(codeLines[index].find(':') + 1);
+        mutation.attributeValueMap = getAttributeValueMap(mutation.relation,
+                                                          readClauseExpression(mutation.relation, setText, true));
+        index++;
+    }
 
-    if (isPKQueried(getRelation(relation), expressionTokens)){
-        std::vector<std::string> info = getPKQueryInformation(getRelation(relation), expressionTokens);
-        handlePKInfoForDelete(getRelation(relation), info);
+    return index;
+}
+
+void executeMutation(const Mutation &mutation){
+    Relation *relation = mutation.relation;
+    if (mutation.where.isKeyedByPK) {
+        if (mutation.isDelete) handlePKInfoForDelete(relation, mutation.where);
+        else handlePKInfoForUpdate(relation, mutation.where, mutation.attributeValueMap);
+        return;
     }
-    else{
-        std::vector<std::string> validExpressions = getValidExpressions(expressionTokens);
-        std::string filePath = "DB/" + getSchemaFromRelation(getRelation(relation))->getName() + "/relations/" + relation;
-        deleteLinesByNonPK(filePath, getRelation(relation), validExpressions);
+
+    if (mutation.isDelete) deleteLinesByNonPK(relation, mutation.where.predicate);
+    else updateLinesByNonPK(relation, mutation.where.predicate, mutation.attributeValueMap);
+}
+
+int executeMutationRun(int index, const std::vector<std::string> &codeLines){
+    std::string relationName = split(codeLines[index], ":")[1];
+    std::vector<Mutation> run;
+
+    if (explicitTransaction) {
+        PendingWrite write;
+        index = readMutation(index, codeLines, write.mutation);
+        lockRelation(write.mutation.relation);
+        bufferWrite(write.mutation.relation, std::move(write));
+        return index;
     }
 
-    return index + 1;
+    // The run ends at the first statement that is not an update or delete of the same relation. A statement
+    // keyed by the PK also ends it, since it only touches a single row and needs no pass over the file.
+    while (static_cast<size_t>(index) < codeLines.size()){
+        auto tokens = split(codeLines[index], ":");
+        if ((tokens[0] != "updateRelation" && tokens[0] != "deleteRelation") || tokens[1] != relationName) break;
+
+        Mutation mutation;
+        index = readMutation(index, codeLines, mutation);
+        if (mutation.where.isKeyedByPK) {
+            applyMutationRun(run);
+            executeMutation(mutation);
+            return index;
+        }
+        run.push_back(std::move(mutation));
+    }
+
+    applyMutationRun(run);
+    return index;
+}
+
+void applyMutationRun(const std::vector<Mutation> &run){
+    if (run.empty()) return;
+    if (run.size() == 1) {
+        executeMutation(run[0]);
+        return;
+    }
+
+    // Every row goes through the statements in order, so it sees the changes of the earlier ones.
+    beginOperator("update/delete run", run[0].relation->getName(), AccessPath::FullScan);
+    mutateVisibleRows(run[0].relation, [&run](std::vector<std::vector<std::string>> &rows, std::vector<uint8_t> &deleted) {
+        std::vector<uint32_t> selection;
+        for (const auto &mutation : run){
+            selection.clear();
+            for (uint32_t row = 0 ; row < rows.size() ; row++){
+                if (!deleted[row]) selection.push_back(row);
+            }
+            mutation.where.predicate.filter(rows, selection);
+
+            for (uint32_t row : selection){
+                if (mutation.isDelete) {
+                    deleted[row] = true;
+                    continue;
+                }
+                for (const auto &[attributeIndex, value] : mutation.attributeValueMap){
+                    if (attributeIndex < rows[row].size()) rows[row][attributeIndex] = value;
+                }
+            }
+        }
+    });
+    endOperator();
+
+    savedMutationPasses += run.size() - 1;
 }
 
 int executeArray(int index, const std::vector<std::string>& codeLines) {
@@ -256,62 +626,87 @@ int executeArray(int index, const std::vector<std::string>& codeLines) {
     index++;
 
     int originalIndex = index;
-    while (split(codeLines[index], ":")[0] != "where"){
-        if (split(codeLines[index], ":")[0] == "fetchRelation")
-            relation = split(codeLines[index], ":")[1];
-
-        index++;
-        if (codeLines.size() < index) break;
-    }
+    WhereClause where;
+    std::vector<std::string> orderKeys;
+    std::vector<std::string> groupKeys;
 
-    std::vector<std::string> expressionTokens;
-    std::vector<std::string> validExpressions;
+    // Only look at the lines belonging to this array declaration.
+    while (static_cast<size_t>(index) < codeLines.size()){
+        tokens = split(codeLines[index], ":");
+        if (tokens[0] == "fetchRelation") relation = tokens[1];
+        else if (tokens[0] == "where"){
+            where = compileWhereClause(getRelation(relation), codeLines[index].substr(codeLines[index].find(':') + 1), true);
+        }
+        else if (tokens[0] == "orderBy") orderKeys.push_back(tokens[1]);
+        else if (tokens[0] == "groupBy") groupKeys.push_back(tokens[1]);
+        else if (tokens[0] != "fetchAttribute" && tokens[0] != "fetchAggregate" && tokens[0] != "concatenate") break;
 
-    if (split(codeLines[index], ":")[0] == "where"){
-        std::string expression = split(codeLines[index], ":")[1];
-        expressionTokens = tokenizeExpression(getRelation(relation), expression);
-        validExpressions = getValidExpressions(expressionTokens);
+        index++;
     }
 
-    return executeFetchRelation(originalIndex, array, codeLines, validExpressions);
+    return executeFetchRelation(originalIndex, array, codeLines, where, orderKeys, groupKeys);
 }
 
 int executeFetchRelation(int index, const std::string &array,
                          const std::vector<std::string> &codeLines,
-                         const std::vector<std::string> &validExpressions) {
+                         const WhereClause &where,
+                         const std::vector<std::string> &orderKeys,
+                         const std::vector<std::string> &groupKeys) {
     auto tokens = split(codeLines[index], ":");
     std::string relation;
     bool isConcatenation = false;
+    std::vector<std::vector<std::string>> orderedRows;
+    std::vector<std::vector<std::string>> aggregatedColumns;
 
-    std::unordered_map<size_t, std::vector<std::string>> tempMap;
+    std::unordered_map<size_t, std::vector<Value>> tempMap;
 
-    while (tokens[0] == "fetchRelation" || tokens[0] == "fetchAttribute" || tokens[0] == "concatenate") {
+    while (tokens[0] == "fetchRelation" || tokens[0] == "fetchAttribute" || tokens[0] == "fetchAggregate"
+           || tokens[0] == "concatenate") {
         if (tokens[0] == "fetchRelation") {
             relation = tokens[1];
+            std::vector<std::string> fetchItems = getFetchItems(index + 1, codeLines);
+
+            aggregatedColumns.clear();
+            if (isAggregatedFetch(getRelation(relation), fetchItems, groupKeys)) {
+                aggregatedColumns = getAggregatedColumns(getRelation(relation), fetchItems, groupKeys, orderKeys, where);
+            }
+            else if (!orderKeys.empty()) orderedRows = getOrderedRows(getRelation(relation), where.predicate, orderKeys);
             index++;
-            tokens = split(codeLines[index], ":");
+            tokens = getBuildLineTokens(index, codeLines);
             continue;
         }
 
         if (tokens[0] == "concatenate") {
             isConcatenation = true;
             index++;
-            tokens = split(codeLines[index], ":");
+            tokens = getBuildLineTokens(index, codeLines);
             continue;
         }
 
         size_t attributeIndex = 0;
-        while (tokens[0] == "fetchAttribute") {
-            auto elements = getElementsByAttribute(getRelation(relation), tokens[1], validExpressions);
+        while (tokens[0] == "fetchAttribute" || tokens[0] == "fetchAggregate") {
+            std::vector<Value> elements;
+            if (!aggregatedColumns.empty()) {
+                Datatype *datatype = getFetchItemDataType(getRelation(relation), codeLines[index]);
+                for (const auto &element : aggregatedColumns[attributeIndex]) {
+                    elements.push_back(datatype == nullptr ? Value::fromString(element) : datatype->decode(element));
+                }
+            }
+            else if (orderKeys.empty()) elements = getElementsByAttribute(getRelation(relation), tokens[1], where);
+            else {
+                size_t elementIndex = getIndexOfAttribute(getRelation(relation), tokens[1]);
+                Datatype *datatype = getAttributeDataType(getRelation(relation), tokens[1]);
+                for (const auto &row : orderedRows) elements.push_back(datatype->decode(row[elementIndex]));
+            }
 
             if (!isConcatenation) tempMap[attributeIndex] = elements;
             else {
                 if (tempMap.find(attributeIndex) != tempMap.end()) {
                     auto &targetVector = tempMap[attributeIndex];
-                    std::vector<std::string> concatenatedVector;
+                    std::vector<Value> concatenatedVector;
 
                     for (size_t i = 0; i < targetVector.size(); ++i) {
-                        concatenatedVector.push_back(targetVector[i] + " " + elements[i]);
+                        concatenatedVector.push_back(Value::fromString(targetVector[i].toString() + " " + elements[i].toString()));
                     }
                     tempMap[attributeIndex] = concatenatedVector;
                 }
@@ -320,7 +715,7 @@ int executeFetchRelation(int index, const std::string &array,
 
             attributeIndex++;
             index++;
-            tokens = split(codeLines[index], ":");
+            tokens = getBuildLineTokens(index, codeLines);
         }
     }
 
@@ -331,7 +726,7 @@ int executeFetchRelation(int index, const std::string &array,
         else {
             auto &existingVector = arrayElementsMap[array][key];
             for (size_t i = 0; i < vec.size(); ++i) {
-                existingVector[i] += " " + vec[i];
+                existingVector[i] = Value::fromString(existingVector[i].toString() + " " + vec[i].toString());
             }
         }
     }
@@ -342,7 +737,7 @@ int executeFetchRelation(int index, const std::string &array,
 int executeConcatenate(int index, const std::string &array, const std::string &constant) {
     auto &innerMap = arrayElementsMap[array];
     for (auto &[key, vec] : innerMap) {
-        vec.push_back(constant);
+        vec.push_back(Value::fromString(constant));
     }
 
     return index + 1;
@@ -351,7 +746,12 @@ int executeConcatenate(int index, const std::string &array, const std::string &c
 int executeShow(int index, const std::vector<std::string> &codeLines){
     auto tokens = split(codeLines[index], ":");
     std::string filePath = "DB/" + getSchemaFromRelation(getRelation(tokens[1]))->getName() + "/relations/" + tokens[1];
-    showRelation(filePath, tokens[1]);
+
+    beginOperator("show", tokens[1], AccessPath::FullScan);
+    size_t rows = showRelation(readDecodedLines(filePath, tokens[1]), tokens[1]);
+    addRowsExamined(rows);
+    addRowsProduced(rows);
+    endOperator();
 
     return index + 1;
 }
@@ -367,7 +767,11 @@ int executeShowSchema(int index, const std::vector<std::string> &codeLines) {
             std::string fullFilePath = entry.path().string();
             std::string relationName = entry.path().filename().string();
 
-            showRelation(fullFilePath, relationName);
+            beginOperator("show", relationName, AccessPath::FullScan);
+            size_t rows = showRelation(readDecodedLines(fullFilePath, relationName), relationName);
+            addRowsExamined(rows);
+            addRowsProduced(rows);
+            endOperator();
         }
     }
     return index + 1;
@@ -377,7 +781,7 @@ int executeShowArray(int index, const std::vector<std::string> &codeLines){
     auto tokens = split(codeLines[index], ":");
 
     std::string array = tokens[1];
-    std::unordered_map<size_t, std::vector<std::string>> indexVectorMap = arrayElementsMap[array];
+    const std::unordered_map<size_t, std::vector<Value>> &indexVectorMap = arrayElementsMap[array];
 
     for (const auto &[mapIndex, vec] : indexVectorMap) {
         std::cout << "Index: " << mapIndex << "\n";
@@ -393,40 +797,75 @@ int executeShowArray(int index, const std::vector<std::string> &codeLines){
     return index + 1;
 }
 
-void handlePKInfoForUpdate(Relation* relation, const std::vector<std::string> &info,
+void handlePKInfoForUpdate(Relation* relation, const WhereClause &where,
                            const std::unordered_map<size_t, std::string> &attributeValueMap){
-    std::string op = info[0];
-    std::string constant = info[1];
     auto *btree = relationBTreeMap[relation];
 
-    if (op == "==" && btree->search(constant)) {
-        std::string line = getPKLineForConstant(relation, constant);
-        if (!line.empty()) {
+    beginOperator("update", relation->getName(), AccessPath::PKPointLookup);
+    std::vector<std::string> row;
+    lockRelation(relation);
+    if (btree->search(decodePK(relation, where.PK)) && readRowByPK(relation, where.PK, row)) {
+        addRowsExamined(1);
+        // The rest of the where clause is checked on the only row the PK can match.
+        if (where.residual.matches(row)) {
             std::string filePath = "DB/" + getSchemaFromRelation(getRelation(relation->getName()))->getName() + "/relations/" + relation->getName();
-            updateLinesByPK(filePath, relation, constant, attributeValueMap);
+            updateLinesByPK(filePath, relation, where.PK, attributeValueMap);
+            addRowsProduced(1);
         }
     }
-    else {
-        //TODO Handle other cases of expressions.
-    }
+    endOperator();
 }
 
-void handlePKInfoForDelete(Relation *relation, const std::vector<std::string> &info) {
-    std::string op = info[0];
-    std::string constant = info[1];
+void handlePKInfoForDelete(Relation *relation, const WhereClause &where) {
     auto *btree = relationBTreeMap[relation];
 
-    if (op == "==" && btree->search(constant)) {
-        std::string line = getPKLineForConstant(relation, constant);
-        if (!line.empty()) {
-            std::string filePath = "DB/" + getSchemaFromRelation(getRelation(relation->getName()))->getName() + "/relations/" + relation->getName();
-            deleteLine(filePath, line);
-            relationPKLineMap[relation].erase(constant);
+    beginOperator("delete", relation->getName(), AccessPath::PKPointLookup);
+    if (btree->search(decodePK(relation, where.PK))) {
+        std::string filePath = lockRelation(relation);
+        const RowLocator *locator = getPKLocator(relation, where.PK);
+        if (locator != nullptr) {
+            std::string line = readLineAt(filePath, locator->offset);
+            addRowsExamined(1);
+
+            if (where.residual.matches(split(line, ","))) {
+                // The version of the row is ended in place, readers that started before still see it.
+                endRowVersions(filePath, {{locator->offset, line}});
+                relationPKLineMap[relation].erase(decodePK(relation, where.PK));
+                relationDeadRowMap[relation]++;
+                btree->remove(decodePK(relation, where.PK));
+                addRowsProduced(1);
+            }
         }
     }
-    else {
-        //TODO handle other cases of expressions
+    endOperator();
+}
+
+bool readRowByPK(Relation *relation, const std::string &PK, std::vector<std::string> &row){
+    refreshRelationIndex(relation);
+    std::string filePath = "DB/" + getSchemaFromRelation(relation)->getName() + "/relations/" + relation->getName();
+
+    // A file changed in place by another process keeps its size, so the line is checked to still hold the PK.
+    for (int attempt = 0 ; attempt < 2 ; attempt++) {
+        const RowLocator *locator = getPKLocator(relation, PK);
+        if (locator == nullptr) return false;
+
+        std::string line = readLineAt(filePath, locator->offset);
+        if (!isFreeLine(line) && isLineOfPK(relation, line, PK)) {
+            if (!isVisibleRow(line)) return false;
+
+            row = split(line, ",");
+            return true;
+        }
+        rebuildRelationIndex(relation);
     }
+    return false;
+}
+
+bool isLineOfPK(Relation *relation, const std::string &line, const std::string &PK){
+    auto tokens = split(line, ",");
+    auto PKIndex = static_cast<size_t>(getRelationPKIndex(relation));
+
+    return PKIndex < tokens.size() && decodePK(relation, tokens[PKIndex]) == decodePK(relation, PK);
 }
 
 bool isRelationInSchema(Relation* relation, Schema* schema){
@@ -470,7 +909,8 @@ Datatype *getDataType(const std::string &dataType){
     if (dataType == "boolean") return new Boolean();
     else if (dataType == "date") return new Date();
     else if (dataType == "datetime") return new Datetime();
-    else if (dataType == "integer") return new Integer();
+    else if (dataType == "int" || dataType == "integer") return new Integer();
+    else if (dataType == "UUID" || dataType == "uuid") return new Uuid();
     else if (dataType.rfind("varchar(", 0) == 0 && dataType.back() == ')') {
         int size = std::stoi(dataType.substr(8, dataType.size() - 9));
         auto _varchar = new Varchar();
@@ -502,6 +942,9 @@ int getRID(const std::string &relationName){
 void updateRID(const std::string &relationName, int newRID){
     std::string filePath = "DB/" + getSchemaFromRelation(getRelation(relationName))->getName()
                            + "/currentRID";
+
+    // The RIDs of all the relations of a schema share a file, so writers of other relations are kept out.
+    int lock = acquireFileLock(filePath);
     std::vector<std::string> lines = readLines(filePath);
 
     bool found = false;
@@ -516,6 +959,8 @@ void updateRID(const std::string &relationName, int newRID){
 
     if (!found) lines.push_back(relationName + ":0");
     writeLines(filePath, lines);
+    recordWrittenFile(filePath);
+    releaseFileLock(lock);
 }
 
 int getRelationPKIndex(Relation *relation){
@@ -532,7 +977,7 @@ std::vector<std::string> getRelationPK(Relation *relation){
 
     std::string filePath = "DB/" + getSchemaFromRelation(getRelation(relation->getName()))->getName() + "/relations/" + relation->getName();
     if (!validFile(filePath)) return {};
-    std::vector<std::string> lines = readLines(filePath);
+    std::vector<std::string> lines = readVisibleLines(filePath);
 
     for (size_t index = 1 ; index < lines.size() ; index++){
         auto tokens = split(lines[index], ",");
@@ -555,7 +1000,7 @@ std::unordered_map<std::string, std::string> getPKLineMap(Relation *relation){
 
     std::string filePath = "DB/" + getSchemaFromRelation(getRelation(relation->getName()))->getName() + "/relations/" + relation->getName();
     if (!validFile(filePath)) return {};
-    std::vector<std::string> lines = readLines(filePath);
+    std::vector<std::string> lines = readVisibleLines(filePath);
 
     for (const auto &line : lines){
         auto tokens = split(line, ",");
@@ -566,27 +1011,40 @@ std::unordered_map<std::string, std::string> getPKLineMap(Relation *relation){
 }
 
 void buildRelationBTree(Relation *relation){
-    const long pageSize = sysconf(_SC_PAGESIZE); // UNIX only
-    const long overhead = sizeof(BTreeNode<std::string>);
-    const long keySize = sizeof(std::string);
-    const long pointerSize = sizeof(int*);
-
-    const long degree = (pageSize + overhead) / (keySize + pointerSize);
-    auto *btree = new BTree<std::string>(degree);
+    auto *btree = createPKIndex(relation);
 
     std::vector<std::string> relationPKs = getRelationPK(relation);
     for (auto const &PK : relationPKs){
-        btree->insert(PK);
+        btree->insert(decodePK(relation, PK));
     }
 
+    delete relationBTreeMap[relation];
     relationBTreeMap[relation] = btree;
 }
 
-void updateRelationBTree(Relation *relation, const std::string &newKey){
-    auto *btree = relationBTreeMap[relation];
-    btree->insert(newKey);
+PKIndex *createPKIndex(Relation *relation){
+    const long pageSize = sysconf(_SC_PAGESIZE); // UNIX only
 
-    relationBTreeMap[relation] = btree;
+    int PKIndex = getRelationPKIndex(relation);
+    if (PKIndex < 0) return new BTreePKIndex<Value>(pageSize);
+
+    Datatype &datatype = relation->getAttribute(PKIndex)->getDataType();
+    std::string name = datatype.getName();
+
+    if (name == "UUID" || name == "int" || name == "bool" || name == "date" || name == "datetime") {
+        return new BTreePKIndex<int64_t>(pageSize);
+    }
+    if (name == "char" || name == "varchar") {
+        if (datatype.getMaxLength() <= 16) return new BTreePKIndex<FixedKey<16>>(pageSize);
+        if (datatype.getMaxLength() <= 32) return new BTreePKIndex<FixedKey<32>>(pageSize);
+        if (datatype.getMaxLength() <= 64) return new BTreePKIndex<FixedKey<64>>(pageSize);
+    }
+
+    return new BTreePKIndex<Value>(pageSize);
+}
+
+void updateRelationBTree(Relation *relation, const std::string &newKey){
+    relationBTreeMap[relation]->insert(decodePK(relation, newKey));
 }
 
 std::vector<std::string> tokenizeExpression(Relation *relation, const std::string &expression) {
@@ -604,101 +1062,422 @@ std::vector<std::string> tokenizeExpression(Relation *relation, const std::strin
     return optimizedTokens;
 }
 
-bool isPKQueried(Relation *relation, const std::vector<std::string> &tokens){
-    std::string PK = getRelationPKAttribute(relation);
-    bool found = false;
-    bool disjunction = false;
-    for (auto const &token : tokens){
-        auto parts = split(token, ";");
-        if (parts[0] == "Identifier" && parts[1] != PK && found)
-            std::cout << "Warning: Primary key " + PK + " uniquely identifies a tuple! " +
-            "Querying " + parts[1] + " is redundant!" << std::endl;
-        if (parts[0] == "Identifier" && parts[1] == PK) found = true;
-        if (parts[0] == "Separator" && parts[1] == "or") disjunction = true;
+Expression readClauseExpression(Relation *relation, const std::string &text, bool isSetClause){
+    if (isSerializedExpression(text)) return deserializeExpression(text);
+
+    // Build files written before the trees hold the clause as infix text without its quotes.
+    std::unordered_map<std::string, std::string> dataTypes;
+    for (int index = 1 ; index <= relation->getAttributeNumber() ; index++){
+        dataTypes[relation->getAttribute(index)->getName()] = "";
     }
 
-    return (found && !disjunction);
+    std::vector<std::string> tokens = tokenizeExpression(relation, text);
+    if (tokens.empty()) return Expression{};
+    return isSetClause ? parseAssignments(tokens, dataTypes) : parseExpression(tokens, dataTypes);
 }
 
-std::vector<std::string> getPKQueryInformation(Relation *relation, const std::vector<std::string> &tokens) {
-    std::string PK = getRelationPKAttribute(relation);
-    std::vector<std::string> info;
+WhereClause compileWhereClause(Relation *relation, const std::string &text, bool emptyMatchesAll){
+    refreshDictionaries(relation);
 
-    for (size_t i = 1; i < tokens.size() - 1; ++i) {
-        auto currentToken = split(tokens[i], ";");
-        auto previousToken = split(tokens[i - 1], ";");
-        auto nextToken = split(tokens[i + 1], ";");
+    Expression expression;
+    if (!text.empty()) expression = readClauseExpression(relation, text, false);
+    else if (!emptyMatchesAll) expression = Expression{ExpressionKind::Or, "or", {}};
 
-        if (currentToken[0] == "Separator" && currentToken[1] != "(" && currentToken[1] != ")"
-            && previousToken[0] == "Identifier" && previousToken[1] == PK) {
+    WhereClause where;
+    where.predicate = Predicate(expression, relation);
 
-            info.push_back(currentToken[1]);
-            info.push_back(nextToken[1]);
-            break;
-        }
+    Expression residual;
+    if (splitKeyComparison(expression, getRelationPKAttribute(relation), where.PK, residual)) {
+        where.isKeyedByPK = true;
+        where.residual = Predicate(residual, relation);
+        return where;
     }
 
-    return info;
+    for (const auto &bound : getKeyBounds(expression, getRelationPKAttribute(relation))) {
+        Value constant = decodePK(relation, bound.children[1].value);
+        if (constant.isNull()) continue;
+
+        // The bounds are inclusive, the predicate drops the PKs equal to a strict bound.
+        if (bound.value[0] == '>' && (!where.hasPKLow || constant.compare(where.PKLow) > 0)) {
+            where.hasPKLow = true;
+            where.PKLow = constant;
+        }
+        else if (bound.value[0] == '<' && (!where.hasPKHigh || constant.compare(where.PKHigh) < 0)) {
+            where.hasPKHigh = true;
+            where.PKHigh = constant;
+        }
+    }
+    return where;
 }
 
 void createPKLineToRelationMap(Relation* relation){
-    std::string filePath = "DB/" + getSchemaFromRelation(relation)->getName() + "/relations/" + relation->getName();
-    std::vector<std::string> lines = readLines(filePath);
-
-    int PKIndex = getRelationPKIndex(relation);
-    for (int index = 1 ; index <= lines.size() ; index++){
-        auto tokens = split(lines[index], ",");
-        std::string pk = tokens[PKIndex];
-
-        addPKLineToRelationMap(relation, pk, lines[index]);
-    }
+    updateRelationPKLineMap(relation, getSchemaFromRelation(relation)->getName(), relation->getName());
 }
 
-void addPKLineToRelationMap(Relation* relation, const std::string& pk, const std::string& line) {
-    if (relationPKLineMap.find(relation) == relationPKLineMap.end()) {
-        relationPKLineMap[relation] = std::unordered_map<std::string, std::string>();
-    }
-    relationPKLineMap[relation][pk] = line;
+void addPKLineToRelationMap(Relation* relation, const std::string& pk, const RowLocator &locator) {
+    relationPKLineMap[relation][decodePK(relation, pk)] = locator;
 }
 
 void updateRelationPKLineMap(Relation* relation, const std::string& schemaName, const std::string& relationName) {
     std::string filePath = "DB/" + schemaName + "/relations/" + relationName;
     if (!validFile(filePath)) return;
 
-    std::vector<std::string> lines = readLines(filePath);
     int pkIndex = getRelationPKIndex(relation);
     if (pkIndex < 0) return;
 
-    if (relationPKLineMap.find(relation) == relationPKLineMap.end()) {
-        relationPKLineMap[relation] = std::unordered_map<std::string, std::string>();
-    }
+    auto &locators = relationPKLineMap[relation];
+    size_t &deadRows = relationDeadRowMap[relation];
+    size_t &unversionedRows = relationUnversionedRowMap[relation];
+    size_t &newerRows = relationNewerRowMap[relation];
+    locators.clear();
+    deadRows = 0;
+    unversionedRows = 0;
+    newerRows = 0;
+    updateRelationFileState(relation, filePath);
+
+    forEachLine(filePath, [&](uint64_t offset, const std::string &line) {
+        // The header starts at offset 0 and is not a row.
+        if (offset == 0) return;
+        countMetric(Metric::RowsScanned);
+        if (isFreeLine(line) || !isVisibleRow(line)) {
+            if (!isFreeLine(line) && isNewerRow(line)) newerRows++;
+            deadRows++;
+            return;
+        }
+        if (!isVersionedRow(line)) unversionedRows++;
 
-    for (const auto& line : lines) {
         auto lineTokens = split(line, ",");
         if (pkIndex < lineTokens.size()) {
-            std::string pk = lineTokens[pkIndex];
-            relationPKLineMap[relation][pk] = line;
+            locators[decodePK(relation, lineTokens[pkIndex])] = RowLocator{offset, static_cast<uint32_t>(line.size())};
+        }
+    });
+}
+
+void refreshRelationIndex(Relation *relation){
+    std::string filePath = "DB/" + getSchemaFromRelation(relation)->getName() + "/relations/" + relation->getName();
+    std::pair<uint64_t, uint64_t> fileState{getFileId(filePath), getFileSize(filePath)};
+    if (fileState != relationFileStateMap[relation]) rebuildRelationIndex(relation);
+}
+
+void rebuildRelationIndex(Relation *relation){
+    updateRelationPKLineMap(relation, getSchemaFromRelation(relation)->getName(), relation->getName());
+    buildRelationBTree(relation);
+}
+
+std::string lockRelation(Relation *relation){
+    std::string filePath = "DB/" + getSchemaFromRelation(relation)->getName() + "/relations/" + relation->getName();
+    transactionRelations.insert(relation);
+    if (lockForWrite(filePath)) {
+        // Another writer may have changed or compacted the relation since the locators were built.
+        refreshRelationIndex(relation);
+
+        // The first writer to commit wins, the PKs and rows this transaction sees are outdated.
+        if (relationNewerRowMap[relation] > 0) {
+            throw std::runtime_error("Write conflict: relation " + relation->getName() +
+                                     " was changed by a transaction committed after this one started!");
         }
     }
+    inflateRelation(relation, filePath);
+    if (relationUnversionedRowMap[relation] > 0) rewriteRelation(relation, filePath);
+
+    return filePath;
 }
 
-std::string getPKLineForConstant(Relation *relation, const std::string &primaryKey) {
-    auto relationPKMapIt = relationPKLineMap.find(relation);
+void updateRelationFileState(Relation *relation, const std::string &filePath){
+    relationFileStateMap[relation] = {getFileId(filePath), getFileSize(filePath)};
+}
 
-    if (relationPKMapIt == relationPKLineMap.end() || relationPKMapIt->second.empty()) {
-        std::cerr << "No PK lines found for the relation: " << relation->getName() << std::endl;
-        return "";
+void rewriteRelation(Relation *relation, const std::string &filePath, int level){
+    beginOperator(level > 0 ? "compress" : "compact", relation->getName(), AccessPath::Rewrite);
+    std::vector<std::string> lines = readRelationLines(filePath);
+    std::vector<std::string> keptLines = collectGarbage(lines);
+    addRowsExamined(lines.empty() ? 0 : lines.size() - 1);
+
+    if (level > 0) {
+        writeCompressedLines(filePath, keptLines, level);
+        recordWrittenFile(filePath);
+        updateRelationPKLineMap(relation, getSchemaFromRelation(relation)->getName(), relation->getName());
     }
+    else if (keptLines != lines) {
+        writeLines(filePath, keptLines);
+        recordWrittenFile(filePath);
+        updateRelationPKLineMap(relation, getSchemaFromRelation(relation)->getName(), relation->getName());
+    }
+    addRowsProduced(keptLines.empty() ? 0 : keptLines.size() - 1);
+    endOperator();
+}
+
+double getDeadRowRatio(Relation *relation){
+    size_t deadRows = relationDeadRowMap[relation];
+    size_t liveRows = relationPKLineMap[relation].size();
+    if (deadRows + liveRows == 0) return 0;
 
-    auto pkLineMap = relationPKMapIt->second;
-    auto lineIt = pkLineMap.find(primaryKey);
-    if (lineIt != pkLineMap.end()) {
-        return lineIt->second;
+    return static_cast<double>(deadRows) / static_cast<double>(deadRows + liveRows);
+}
+
+void compactRelation(Relation *relation){
+    if (relation == nullptr || (relationDeadRowMap[relation] == 0 && !isCompressionPending(relation))) return;
+
+    std::string filePath = lockRelation(relation);
+    rewriteRelation(relation, filePath, getCompressionLevel(relation));
+}
+
+void compactRelations(){
+    for (auto *relation : relations){
+        if (getDeadRowRatio(relation) >= compactionThreshold || isCompressionPending(relation)) compactRelation(relation);
     }
-    else {
+}
+
+std::string getCompressionPath(Relation *relation){
+    return "DB/" + getSchemaFromRelation(relation)->getName() + "/compression";
+}
+
+int getCompressionLevel(Relation *relation){
+    std::string filePath = getCompressionPath(relation);
+    if (!validFile(filePath)) return 0;
+
+    for (const auto &line : readLines(filePath)){
+        auto tokens = split(line, ":");
+        if (tokens.size() == 2 && tokens[0] == relation->getName()) return std::stoi(tokens[1]);
+    }
+    return 0;
+}
+
+void setCompressionLevel(Relation *relation, int level){
+    std::string filePath = getCompressionPath(relation);
+    if (!validFile(filePath)) createFile(filePath);
+
+    // The levels of all the relations of a schema share a file, like their RIDs.
+    int lock = acquireFileLock(filePath);
+    std::vector<std::string> lines;
+    for (const auto &line : readLines(filePath)){
+        if (split(line, ":")[0] != relation->getName()) lines.push_back(line);
+    }
+    if (level > 0) lines.push_back(relation->getName() + ":" + std::to_string(level));
+    writeLines(filePath, lines);
+    recordWrittenFile(filePath);
+    releaseFileLock(lock);
+}
+
+bool isCompressionPending(Relation *relation){
+    std::string filePath = "DB/" + getSchemaFromRelation(relation)->getName() + "/relations/" + relation->getName();
+    if (!validFile(filePath)) return false;
+
+    return (getCompressionLevel(relation) > 0) != isCompressedFile(filePath);
+}
+
+void inflateRelation(Relation *relation, const std::string &filePath){
+    if (!isCompressedFile(filePath)) return;
+
+    // readLines keeps the free lines, so every line is written back at the offset it had.
+    beginOperator("decompress", relation->getName(), AccessPath::Rewrite);
+    std::vector<std::string> lines = readLines(filePath);
+    writeLines(filePath, lines);
+    recordWrittenFile(filePath);
+    updateRelationFileState(relation, filePath);
+    addRowsExamined(lines.empty() ? 0 : lines.size() - 1);
+    addRowsProduced(lines.empty() ? 0 : lines.size() - 1);
+    endOperator();
+}
+
+std::string getStatisticsPath(Relation *relation){
+    return "DB/" + getSchemaFromRelation(relation)->getName() + "/statistics/" + relation->getName();
+}
+
+void analyzeRelation(Relation *relation){
+    beginOperator("analyze", relation->getName(), AccessPath::FullScan);
+    std::string filePath = "DB/" + getSchemaFromRelation(relation)->getName() + "/relations/" + relation->getName();
+    std::vector<std::string> lines = readDecodedLines(filePath, relation->getName());
+    if (!lines.empty()) lines.erase(lines.begin());
+
+    RelationStatistics statistics = collectStatistics(relation, lines);
+    writeStatistics(getStatisticsPath(relation), statistics);
+    addRowsExamined(lines.size());
+    endOperator();
+
+    std::vector<size_t> encodedAttributes = chooseEncodedAttributes(relation, statistics);
+    relationStatisticsMap[relation] = std::move(statistics);
+    if (!encodedAttributes.empty()) encodeRelationAttributes(relation, encodedAttributes);
+}
+
+std::string getDictionaryPath(Relation *relation){
+    return "DB/" + getSchemaFromRelation(relation)->getName() + "/dictionaries/" + relation->getName();
+}
+
+void refreshDictionaries(Relation *relation){
+    loadDictionaries(relation, getDictionaryPath(relation));
+}
+
+std::vector<size_t> chooseEncodedAttributes(Relation *relation, const RelationStatistics &statistics){
+    std::vector<size_t> indexes;
+    if (statistics.rowCount < dictionaryMinimumRows) return indexes;
+
+    int PKIndex = getRelationPKIndex(relation);
+    for (int index = 1 ; index <= relation->getAttributeNumber() ; index++){
+        std::string datatype = relation->getAttribute(index)->getDataType().getName();
+        if (index == PKIndex || (datatype != "char" && datatype != "varchar")) continue;
+        if (findDictionary(relation, index) != nullptr) continue;
+
+        const AttributeStatistics *attribute = findAttributeStatistics(statistics, relation->getAttribute(index)->getName());
+        if (attribute == nullptr) continue;
+        if (static_cast<double>(attribute->distinctCount) <= static_cast<double>(statistics.rowCount) * dictionaryDistinctRatio) {
+            indexes.push_back(index);
+        }
+    }
+    return indexes;
+}
+
+void encodeRelationAttributes(Relation *relation, const std::vector<size_t> &indexes){
+    // Buffered writes hold the values themselves, they are written before the rows are encoded.
+    flushPendingWrites(relation);
+    std::string filePath = lockRelation(relation);
+    refreshDictionaries(relation);
+
+    beginOperator("encode", relation->getName(), AccessPath::Rewrite);
+    std::vector<std::string> lines = readRelationLines(filePath);
+    std::vector<std::vector<std::string>> rows;
+    for (size_t line = 1 ; line < lines.size() ; line++) rows.push_back(split(lines[line], ","));
+
+    // The dictionaries start with the values of every version of the rows, in the order they were written.
+    std::unordered_map<size_t, std::vector<std::string>> attributeValues;
+    for (size_t index : indexes){
+        auto &values = attributeValues[index];
+        for (const auto &row : rows){
+            if (index < row.size()) values.push_back(row[index]);
+        }
+    }
+    encodeAttributes(relation, attributeValues);
+
+    for (size_t row = 0 ; row < rows.size() ; row++){
+        for (size_t index : indexes){
+            if (index < rows[row].size()) rows[row][index] = encodeValue(relation, index, rows[row][index]);
+        }
+        lines[row + 1] = join(rows[row], ",");
+    }
+    writeLines(filePath, lines);
+    recordWrittenFile(filePath);
+    updateRelationPKLineMap(relation, getSchemaFromRelation(relation)->getName(), relation->getName());
+
+    addRowsExamined(rows.size());
+    addRowsProduced(rows.size());
+    endOperator();
+}
+
+std::vector<std::string> readDecodedLines(const std::string &filePath, const std::string &relationName){
+    std::vector<std::string> lines = readVisibleLines(filePath);
+
+    for (auto *relation : relations){
+        if (relation->getName() != relationName) continue;
+
+        refreshDictionaries(relation);
+        if (!hasDictionaries(relation)) break;
+        for (size_t line = 1 ; line < lines.size() ; line++){
+            auto tokens = split(lines[line], ",");
+            decodeRow(relation, tokens);
+            lines[line] = join(tokens, ",");
+        }
+        break;
+    }
+    return lines;
+}
+
+const RelationStatistics *getRelationStatistics(Relation *relation){
+    auto statisticsIt = relationStatisticsMap.find(relation);
+    if (statisticsIt == relationStatisticsMap.end()) {
+        RelationStatistics statistics;
+        std::optional<RelationStatistics> readStatisticsFile;
+        if (readStatistics(getStatisticsPath(relation), statistics)) readStatisticsFile = std::move(statistics);
+        statisticsIt = relationStatisticsMap.emplace(relation, std::move(readStatisticsFile)).first;
+    }
+
+    return statisticsIt->second ? &*statisticsIt->second : nullptr;
+}
+
+AccessPath chooseAccessPath(Relation *relation, const WhereClause &where){
+    if (where.isKeyedByPK) return AccessPath::PKPointLookup;
+    if (!where.hasPKLow && !where.hasPKHigh) return AccessPath::FullScan;
+
+    const RelationStatistics *statistics = getRelationStatistics(relation);
+    if (statistics == nullptr || !relationBTreeMap.contains(relation)) return AccessPath::FullScan;
+    refreshRelationIndex(relation);
+
+    const AttributeStatistics *PKStatistics = findAttributeStatistics(*statistics, getRelationPKAttribute(relation));
+    if (PKStatistics == nullptr) return AccessPath::FullScan;
+
+    // The histogram gives the share of the rows in the range, the locators give the current amount of rows.
+    size_t rowCount = relationPKLineMap[relation].size();
+    Datatype *datatype = &relation->getAttribute(getRelationPKIndex(relation))->getDataType();
+    double fraction = estimateRangeFraction(*statistics, *PKStatistics, datatype,
+                                            where.hasPKLow ? &where.PKLow : nullptr,
+                                            where.hasPKHigh ? &where.PKHigh : nullptr);
+
+    if (estimatePKRangeCost(rowCount, fraction) < estimateFullScanCost(rowCount)) return AccessPath::PKRange;
+    return AccessPath::FullScan;
+}
+
+std::vector<std::string> readPKRangeLines(Relation *relation, const WhereClause &where){
+    const Value *low = where.hasPKLow ? &where.PKLow : nullptr;
+    const Value *high = where.hasPKHigh ? &where.PKHigh : nullptr;
+    ValueType type = low != nullptr ? low->getType() : high->getType();
+    std::string filePath = "DB/" + getSchemaFromRelation(relation)->getName() + "/relations/" + relation->getName();
+    auto PKIndex = static_cast<size_t>(getRelationPKIndex(relation));
+    refreshRelationIndex(relation);
+
+    std::vector<std::string> lines;
+    for (int attempt = 0 ; attempt < 2 ; attempt++) {
+        auto &locators = relationPKLineMap[relation];
+        std::vector<std::pair<uint64_t, Value>> located;
+        relationBTreeMap[relation]->forEachInRange(low, high, type, [&locators, &located](const Value &PK) {
+            auto locatorIt = locators.find(PK);
+            if (locatorIt != locators.end()) located.emplace_back(locatorIt->second.offset, PK);
+            return true;
+        });
+
+        // The rows are read forward through the file, in the order a full scan returns them.
+        std::sort(located.begin(), located.end(), [](const auto &left, const auto &right) { return left.first < right.first; });
+        std::vector<uint64_t> offsets;
+        for (const auto &[offset, PK] : located) offsets.push_back(offset);
+        std::vector<std::string> rangeLines = readLinesAt(filePath, offsets);
+        countMetric(Metric::RowsScanned, offsets.size());
+
+        // A line that no longer holds its PK means another process changed the file in place.
+        bool stale = false;
+        lines.clear();
+        for (size_t index = 0 ; index < rangeLines.size() && !stale ; index++) {
+            const std::string &line = rangeLines[index];
+            auto tokens = split(line, ",");
+            if (isFreeLine(line) || PKIndex >= tokens.size() || decodePK(relation, tokens[PKIndex]) != located[index].second) {
+                stale = true;
+            }
+            else if (isVisibleRow(line)) lines.push_back(getRowData(line));
+        }
+        if (!stale) return lines;
+        rebuildRelationIndex(relation);
+    }
+    return lines;
+}
+
+const RowLocator *getPKLocator(Relation *relation, const std::string &primaryKey){
+    countMetric(Metric::IndexProbes);
+    auto relationPKMapIt = relationPKLineMap.find(relation);
+    if (relationPKMapIt == relationPKLineMap.end()) return nullptr;
+
+    auto locatorIt = relationPKMapIt->second.find(decodePK(relation, primaryKey));
+    if (locatorIt == relationPKMapIt->second.end()) return nullptr;
+
+    return &locatorIt->second;
+}
+
+std::string getPKLineForConstant(Relation *relation, const std::string &primaryKey) {
+    const RowLocator *locator = getPKLocator(relation, primaryKey);
+
+    if (locator == nullptr) {
         std::cerr << "Primary Key not found: " << primaryKey << " in relation: " << relation->getName() << std::endl;
         return "";
     }
+
+    std::string filePath = "DB/" + getSchemaFromRelation(relation)->getName() + "/relations/" + relation->getName();
+    return getRowData(readLineAt(filePath, locator->offset));
 }
 
 bool relationAlreadyDeclared(Relation *relation){
@@ -712,9 +1491,9 @@ bool relationAlreadyDeclared(Relation *relation){
         else if (tokens[0] == "Relation" && tokens[1] != relation->getName() && foundRelation) break;
 
         if (foundRelation && split(tokens[0], ",")[0] != "Relation"){
-            std::string attributeName = tokens[0];
-            std::string attributeDataType = tokens[1];
-            std::string attributeConstraint = tokens[2];
+            std::string attributeName = trim(tokens[0]);
+            std::string attributeDataType = trim(tokens[1]);
+            std::string attributeConstraint = trim(tokens[2]);
 
             Datatype *datatype = getDataType(attributeDataType);
             auto *newAttribute = new Attribute(attributeName, datatype, attributeConstraint);
@@ -732,142 +1511,469 @@ bool relationAlreadyDeclared(Relation *relation){
 void updateLinesByPK(const std::string &filePath, Relation *relation,
                      const std::string &PK,
                      std::unordered_map<size_t, std::string> attributeValueMap) {
-    std::vector<std::string> lines = readLines(filePath);
+    lockRelation(relation);
+    const RowLocator *locator = getPKLocator(relation, PK);
+    if (locator == nullptr) return;
+
+    RowLocator oldLocator = *locator;
     int PKIndex = getRelationPKIndex(relation);
 
-    for (auto &line : lines) {
-        auto tokens = split(line, ",");
-        if (tokens[PKIndex] == PK) {
-            for (int index = 0; index < tokens.size(); index++) {
-                if (attributeValueMap.find(index) != attributeValueMap.end()) {
-                    tokens[index] = attributeValueMap[index];
-                }
-            }
-            line = join(tokens, ",");
+    // Only the row itself is read, it is found through its locator instead of scanning the file.
+    std::string oldLine = readLineAt(filePath, oldLocator.offset);
+    auto tokens = split(oldLine, ",");
+    std::string oldPK = tokens[PKIndex];
+    for (size_t index = 0; index < tokens.size(); index++) {
+        if (attributeValueMap.find(index) != attributeValueMap.end()) {
+            tokens[index] = attributeValueMap[index];
         }
     }
-    writeLines(filePath, lines);
+    std::string line = stampRow(join(tokens, ","));
+
+    // The old version is ended in place and the new one is appended, so readers that started before keep the old one.
+    endRowVersions(filePath, {{oldLocator.offset, oldLine}});
+    RowLocator newLocator{getFileSize(filePath), static_cast<uint32_t>(line.size())};
+    writeLine(filePath, line);
+    updateRelationFileState(relation, filePath);
+    relationDeadRowMap[relation]++;
+
+    updatePKIndexForRow(relation, oldPK, tokens[PKIndex]);
+    addPKLineToRelationMap(relation, tokens[PKIndex], newLocator);
 }
 
-void updateLinesByNonPK(const std::string &filePath, Relation* relation,
-                        const std::vector<std::string> &validExpressions,
+void updateLinesByNonPK(Relation* relation, const Predicate &predicate,
                         std::unordered_map<size_t, std::string> attributeValueMap){
-    std::vector<std::string> lines = readLines(filePath);
-
-    for (auto &line : lines){
-        auto tokens = split(line, ",");
-        if (checkValidExpressions(relation, tokens, validExpressions)){
-            for (int index = 0; index < tokens.size(); index++) {
-                if (attributeValueMap.find(index) != attributeValueMap.end()) {
-                    tokens[index] = attributeValueMap[index];
-                }
+    beginOperator("update", relation->getName(), AccessPath::FullScan);
+    mutateVisibleRows(relation, [&](std::vector<std::vector<std::string>> &rows, std::vector<uint8_t> &) {
+        std::vector<uint32_t> selection(rows.size());
+        for (uint32_t row = 0 ; row < rows.size() ; row++) selection[row] = row;
+        predicate.filter(rows, selection);
+
+        for (uint32_t row : selection){
+            for (const auto &[attributeIndex, value] : attributeValueMap){
+                if (attributeIndex < rows[row].size()) rows[row][attributeIndex] = value;
             }
-            line = join(tokens, ",");
         }
-    }
-    writeLines(filePath, lines);
+    });
+    endOperator();
 }
 
-void deleteLinesByNonPK(const std::string &filePath, Relation* relation,
-                       const std::vector<std::string> &validExpressions){
-    std::vector<std::string> lines = readLines(filePath);
-    std::vector<std::string> newLines;
+void updatePKIndexForRow(Relation *relation, const std::string &oldPK, const std::string &newPK){
+    Value oldKey = decodePK(relation, oldPK);
+    Value newKey = decodePK(relation, newPK);
+    if (oldKey == newKey) return;
 
-    for (auto &line : lines){
-        auto tokens = split(line, ",");
-        if (!checkValidExpressions(relation, tokens, validExpressions)){
-            newLines.push_back(line);
-        }
-    }
-
-    writeLines(filePath, newLines);
+    relationPKLineMap[relation].erase(oldKey);
+    relationBTreeMap[relation]->remove(oldKey);
+    relationBTreeMap[relation]->insert(newKey);
 }
 
-bool checkValidExpressions(Relation *relation, const std::vector<std::string> &tokens,
-                           const std::vector<std::string> &validExpressions){
+void deleteLinesByNonPK(Relation* relation, const Predicate &predicate){
+    beginOperator("delete", relation->getName(), AccessPath::FullScan);
+    mutateVisibleRows(relation, [&](std::vector<std::vector<std::string>> &rows, std::vector<uint8_t> &deleted) {
+        std::vector<uint32_t> selection(rows.size());
+        for (uint32_t row = 0 ; row < rows.size() ; row++) selection[row] = row;
+        predicate.filter(rows, selection);
 
-    for (const auto &expression : validExpressions){
-        bool validUpdateLine = true;
+        for (uint32_t row : selection) deleted[row] = true;
+    });
+    endOperator();
+}
 
-        auto expressions = split(expression, ",");
-        for (const auto &expr : expressions){
-            auto expressionTokens = split(expr, "==");
-            //TODO Also add other operations
-            if (tokens[getIndexOfAttribute(relation, expressionTokens[0])] != expressionTokens[1]){
-                validUpdateLine = false;
-            }
+void mutateVisibleRows(Relation *relation, const RowMutator &mutate){
+    std::string filePath = lockRelation(relation);
+    std::vector<std::pair<uint64_t, std::string>> endedRows;
+    std::vector<std::string> newRows;
+    std::vector<std::string> newPKs;
+    std::vector<Value> deletedPKs;
+    int PKIndex = getRelationPKIndex(relation);
+
+    std::vector<std::pair<uint64_t, std::string>> batch;
+    std::vector<std::vector<std::string>> rows;
+    std::vector<uint8_t> deleted;
+    std::vector<std::string> oldPKs;
+    auto mutateBatch = [&]() {
+        rows.clear();
+        oldPKs.clear();
+        for (const auto &[offset, line] : batch) {
+            rows.push_back(split(line, ","));
+            oldPKs.push_back(rows.back()[PKIndex]);
         }
+        deleted.assign(batch.size(), false);
+        mutate(rows, deleted);
+
+        for (size_t row = 0 ; row < batch.size() ; row++){
+            const auto &[offset, line] = batch[row];
+            std::vector<std::string> &tokens = rows[row];
+            const std::string &oldPK = oldPKs[row];
+            if (deleted[row]) {
+                endedRows.emplace_back(offset, line);
+                deletedPKs.push_back(decodePK(relation, oldPK));
+                continue;
+            }
+
+            std::string newRow = join(tokens, ",");
+            if (newRow == line) continue;
 
-        if (validUpdateLine) return true;
+            endedRows.emplace_back(offset, line);
+            newRows.push_back(stampRow(newRow));
+            newPKs.push_back(tokens[PKIndex]);
+            updatePKIndexForRow(relation, oldPK, tokens[PKIndex]);
+        }
+        batch.clear();
+    };
+
+    forEachLine(filePath, [&](uint64_t offset, const std::string &line) {
+        if (offset == 0) return;
+        countMetric(Metric::RowsScanned);
+        if (isFreeLine(line) || !isVisibleRow(line)) return;
+        addRowsExamined(1);
+
+        batch.emplace_back(offset, line);
+        if (batch.size() == scanBatchRows) mutateBatch();
+    });
+    mutateBatch();
+
+    // Only the changed rows are written: their versions are ended in place and the new versions are
+    // appended once the scan is over, so the scan never reads them.
+    endRowVersions(filePath, endedRows);
+
+    uint64_t offset = getFileSize(filePath);
+    for (size_t index = 0 ; index < newRows.size() ; index++){
+        addPKLineToRelationMap(relation, newPKs[index], RowLocator{offset, static_cast<uint32_t>(newRows[index].size())});
+        offset += newRows[index].size() + 1;
     }
-    return false;
+    appendLines(filePath, newRows);
+    updateRelationFileState(relation, filePath);
+    relationDeadRowMap[relation] += endedRows.size();
+    addRowsProduced(endedRows.size());
+
+    // The deleted PKs leave the index at once, so they can be added again right away.
+    for (const auto &PK : deletedPKs) relationPKLineMap[relation].erase(PK);
+    relationBTreeMap[relation]->removeBatch(deletedPKs);
 }
 
-std::unordered_map<size_t, std::string> getAttributeValueMap(Relation *relation,
-                                                             const std::vector<std::string> &statementTokens){
+std::unordered_map<size_t, std::string> getAttributeValueMap(Relation *relation, const Expression &assignments){
     std::unordered_map<size_t, std::string> attributeValueMap;
-    std::unordered_map<std::string, size_t> attributeIndexMap;
+    refreshDictionaries(relation);
 
-    std::string filePath = "DB/" + getSchemaFromRelation(relation)->getName() + "/relations/" + relation->getName();
-    std::string header = getLine(filePath, 0);
-    auto headerTokens = split(header, ",");
-    for (int index = 0 ; index < headerTokens.size() ; index++) attributeIndexMap[headerTokens[index]] = index;
-
-    for (size_t index = 0 ; index < statementTokens.size() ; index++){
-        auto tokens = split(statementTokens[index], ";");
-        if (tokens[0] == "Separator" && (tokens[1] == "(" || tokens[1] == ")")) continue;
-        if (tokens[0] == "Separator" && tokens[1] == "=") {
-            auto prevTokens = split(statementTokens[index - 1], ";");
-            auto nextTokens = split(statementTokens[index + 1], ";");
-
-            if (prevTokens[0] == "Identifier" && isAttributeInRelation(relation, prevTokens[1])){
-                attributeValueMap[attributeIndexMap[prevTokens[1]]] = nextTokens[1];
-            }
-            else if (nextTokens[0] == "Identifier" && isAttributeInRelation(relation, nextTokens[1])){
-                attributeValueMap[attributeIndexMap[nextTokens[1]]] = prevTokens[1];
-            }
-        }
-    }
+    auto addAssignment = [&](const Expression &assignment) {
+        if (assignment.kind != ExpressionKind::Assignment) return;
+        if (!isAttributeInRelation(relation, assignment.children[0].value)) return;
+
+        // The values are written to the rows as they are, so the ones of encoded attributes are encoded here.
+        size_t attributeIndex = getIndexOfAttribute(relation, assignment.children[0].value);
+        attributeValueMap[attributeIndex] = encodeValue(relation, attributeIndex, assignment.children[1].value);
+    };
+
+    if (assignments.kind == ExpressionKind::Assignment) addAssignment(assignments);
+    else for (const auto &assignment : assignments.children) addAssignment(assignment);
 
     return attributeValueMap;
 }
 
-std::vector<std::string> getElementsByAttribute(Relation *relation, const std::string &attribute,
-                                                const std::vector<std::string> &validExpressions){
-    std::vector<std::string> elements;
+std::vector<Value> getElementsByAttribute(Relation *relation, const std::string &attribute,
+                                          const WhereClause &where){
+    std::vector<Value> elements;
+    Datatype *datatype = getAttributeDataType(relation, attribute);
 
     std::string filePath = "DB/" + getSchemaFromRelation(relation)->getName() + "/relations/" + relation->getName();
-    std::string header = getLine(filePath, 0);
-    auto headerTokens = split(header, ",");
-
-    int attributeIndex;
-    for (int index = 0 ; index < headerTokens.size() ; index++) {
-        if (headerTokens[index] == attribute) {
-            attributeIndex = index;
-            break;
+    size_t attributeIndex = getIndexOfAttribute(relation, attribute);
+
+    // Encoded values are only decoded for the rows the where clause keeps.
+    refreshDictionaries(relation);
+    const Dictionary *dictionary = findDictionary(relation, attributeIndex);
+    auto decodeElement = [datatype, dictionary](const std::string &token) {
+        return datatype->decode(dictionary == nullptr ? token : dictionary->decode(token));
+    };
+
+    // A where clause keyed by the PK matches at most the row the PK index points to.
+    if (where.isKeyedByPK) {
+        beginOperator("fetch " + attribute, relation->getName(), AccessPath::PKPointLookup);
+        std::vector<std::string> row;
+        if (readRowByPK(relation, where.PK, row)) {
+            addRowsExamined(1);
+            if (where.residual.matches(row)) elements.push_back(decodeElement(row[attributeIndex]));
         }
+        addRowsProduced(elements.size());
+        endOperator();
+        return elements;
     }
 
-    std::vector<std::string> lines = readLines(filePath);
-    for (int index = 1 ; index <= lines.size() ; index++){
-        auto tokens = split(lines[index], ",");
-        if (validExpressions.empty()) elements.push_back(tokens[attributeIndex]);
-        else if (checkValidExpressions(relation, tokens, validExpressions)){
-            elements.push_back(tokens[attributeIndex]);
+    AccessPath accessPath = chooseAccessPath(relation, where);
+    beginOperator("fetch " + attribute, relation->getName(), accessPath);
+    std::vector<std::string> lines;
+    if (accessPath == AccessPath::PKRange) lines = readPKRangeLines(relation, where);
+    else {
+        lines = readVisibleLines(filePath);
+        if (!lines.empty()) lines.erase(lines.begin());
+    }
+
+    std::vector<std::vector<std::string>> rows;
+    std::vector<uint32_t> selection;
+    for (size_t start = 0 ; start < lines.size() ; start += scanBatchRows){
+        rows.clear();
+        selection.clear();
+        for (size_t line = start ; line < std::min(lines.size(), start + scanBatchRows) ; line++){
+            selection.push_back(static_cast<uint32_t>(rows.size()));
+            rows.push_back(split(lines[line], ","));
         }
+
+        where.predicate.filter(rows, selection);
+        for (uint32_t row : selection) elements.push_back(decodeElement(rows[row][attributeIndex]));
     }
+    addRowsExamined(lines.size());
+    addRowsProduced(elements.size());
+    endOperator();
 
     return elements;
 }
 
 size_t getIndexOfAttribute(Relation *relation, const std::string &attribute){
+    // The header of a relation is "RID," followed by the attributes in declaration order.
+    for (int index = 1 ; index <= relation->getAttributeNumber() ; index++){
+        if (relation->getAttribute(index)->getName() == attribute) return index;
+    }
+
+    return 0;
+}
+
+Datatype *getAttributeDataType(Relation *relation, const std::string &attribute){
+    for (int index = 1 ; index <= relation->getAttributeNumber() ; index++){
+        if (relation->getAttribute(index)->getName() == attribute) return &relation->getAttribute(index)->getDataType();
+    }
+
+    return nullptr;
+}
+
+Value decodePK(Relation *relation, const std::string &PK){
+    int PKIndex = getRelationPKIndex(relation);
+    if (PKIndex < 0) return Value::fromString(PK);
+
+    return relation->getAttribute(PKIndex)->getDataType().decode(PK);
+}
+
+Datatype *getFetchItemDataType(Relation *relation, const std::string &fetchItem){
+    static Integer integer;
+
+    auto tokens = split(fetchItem, ":");
+    if (tokens[0] == "fetchAttribute") return getAttributeDataType(relation, tokens[1]);
+
+    auto parts = split(tokens[1], ",");
+    AggregateFunction function = getAggregateFunction(parts[0]);
+    if (function == AggregateFunction::Count || function == AggregateFunction::Sum) return &integer;
+    if (function == AggregateFunction::Min || function == AggregateFunction::Max) return getAttributeDataType(relation, parts[1]);
+
+    // Averages are not integral, they are kept as they are printed.
+    return nullptr;
+}
+
+std::vector<SortKey> getSortKeys(Relation *relation, const std::vector<std::string> &orderKeys){
+    std::vector<SortKey> sortKeys;
+
+    for (const auto &orderKey : orderKeys){
+        auto tokens = split(orderKey, ",");
+        if (!isAttributeInRelation(relation, tokens[0])) continue;
+
+        size_t attributeIndex = getIndexOfAttribute(relation, tokens[0]);
+        Datatype *datatype = getAttributeDataType(relation, tokens[0]);
+
+        bool descending = tokens.size() > 1 && tokens[1] == "desc";
+        sortKeys.push_back(SortKey{attributeIndex, datatype, descending});
+    }
+
+    return sortKeys;
+}
+
+std::vector<std::vector<std::string>> getOrderedRows(Relation *relation,
+                                                     const Predicate &predicate,
+                                                     const std::vector<std::string> &orderKeys){
     std::string filePath = "DB/" + getSchemaFromRelation(relation)->getName() + "/relations/" + relation->getName();
-    std::string header = getLine(filePath, 0);
-    auto headerTokens = split(header, ",");
+    std::string sortedPath = createTemporaryPath("fql_fetch");
+
+    // The relation file is sorted directly, so the row versions the transaction does not see are filtered out here.
+    beginOperator("sort", relation->getName(), AccessPath::ExternalSort);
+    // The sort keys compare values, so the rows the predicate keeps are decoded before they are sorted.
+    refreshDictionaries(relation);
+    bool isEncoded = hasDictionaries(relation);
+    RowFilter filter = [&predicate, relation, isEncoded](std::vector<std::string> &row) {
+        addRowsExamined(1);
+        countMetric(Metric::RowsScanned);
+        if (!isVisibleRID(row[0])) return false;
+        if (!predicate.matchesAll() && !predicate.matches(row)) return false;
+
+        if (isEncoded) decodeRow(relation, row);
+        return true;
+    };
+    externalSort(filePath, sortedPath, getSortKeys(relation, orderKeys), true, filter);
+
+    std::vector<std::vector<std::string>> orderedRows;
+    for (const auto &line : readLines(sortedPath)) orderedRows.push_back(split(line, ","));
+    std::filesystem::remove(sortedPath);
+    addRowsProduced(orderedRows.size());
+    endOperator();
+
+    return orderedRows;
+}
 
-    for (int index = 1 ; index < headerTokens.size() ; index++){
-        if (headerTokens[index] == attribute) return index;
+std::vector<std::string> getFetchItems(int index, const std::vector<std::string> &codeLines){
+    std::vector<std::string> fetchItems;
+
+    while (static_cast<size_t>(index) < codeLines.size()){
+        std::string opCode = split(codeLines[index], ":")[0];
+        if (opCode != "fetchAttribute" && opCode != "fetchAggregate") break;
+
+        fetchItems.push_back(codeLines[index]);
+        index++;
     }
 
-    return 0;
-}
\ No newline at end of file
+    return fetchItems;
+}
+
+bool isAggregatedFetch(Relation *relation, const std::vector<std::string> &fetchItems,
+                       const std::vector<std::string> &groupKeys){
+    for (const auto &fetchItem : fetchItems){
+        if (split(fetchItem, ":")[0] == "fetchAggregate") return true;
+    }
+
+    for (const auto &groupKey : groupKeys){
+        if (isAttributeInRelation(relation, groupKey)) return true;
+    }
+
+    return false;
+}
+
+std::vector<std::vector<std::string>> getAggregatedColumns(Relation *relation,
+                                                           const std::vector<std::string> &fetchItems,
+                                                           const std::vector<std::string> &groupKeys,
+                                                           const std::vector<std::string> &orderKeys,
+                                                           const WhereClause &where){
+    std::vector<std::string> groupAttributes;
+    std::vector<size_t> groupIndexes;
+    for (const auto &groupKey : groupKeys){
+        if (!isAttributeInRelation(relation, groupKey)) continue;
+
+        groupAttributes.push_back(groupKey);
+        groupIndexes.push_back(getIndexOfAttribute(relation, groupKey));
+    }
+
+    // Every fetched item is mapped to a column of the aggregated rows (group values, then aggregates).
+    std::vector<AggregateSpec> aggregates;
+    std::vector<size_t> itemColumns;
+    for (const auto &fetchItem : fetchItems){
+        auto tokens = split(fetchItem, ":");
+
+        if (tokens[0] == "fetchAttribute"){
+            auto it = std::find(groupAttributes.begin(), groupAttributes.end(), tokens[1]);
+            itemColumns.push_back(it - groupAttributes.begin());
+        }
+        else {
+            auto parts = split(tokens[1], ",");
+            std::string attribute = parts.size() > 1 ? parts[1] : "";
+
+            itemColumns.push_back(groupAttributes.size() + aggregates.size());
+            aggregates.push_back(AggregateSpec{getAggregateFunction(parts[0]),
+                                               attribute.empty() ? 0 : getIndexOfAttribute(relation, attribute),
+                                               attribute.empty() ? nullptr : getAttributeDataType(relation, attribute)});
+        }
+    }
+
+    std::vector<std::vector<std::string>> aggregatedRows;
+    beginOperator("aggregate", relation->getName(), AccessPath::PKIndex);
+    if (!countFromPKIndex(relation, aggregates, groupIndexes, where, aggregatedRows)){
+        AccessPath accessPath = chooseAccessPath(relation, where);
+        std::vector<std::string> lines;
+        if (accessPath == AccessPath::PKRange) lines = readPKRangeLines(relation, where);
+        else {
+            // Aggregates keyed by the PK that the PK index can not answer are computed over every row.
+            accessPath = AccessPath::FullScan;
+            std::string filePath = "DB/" + getSchemaFromRelation(relation)->getName() + "/relations/" + relation->getName();
+            lines = readVisibleLines(filePath);
+            if (!lines.empty()) lines.erase(lines.begin());
+        }
+        setAccessPath(accessPath);
+
+        // Rows are grouped by the codes of encoded attributes, only the aggregates other than count
+        // look at the values themselves. The where clause compares the codes, so these values are
+        // only decoded for the rows it keeps.
+        refreshDictionaries(relation);
+        std::unordered_map<size_t, const Dictionary*> decodedAttributes;
+        for (const auto &aggregate : aggregates){
+            const Dictionary *dictionary = findDictionary(relation, aggregate.index);
+            if (aggregate.function != AggregateFunction::Count && dictionary != nullptr) {
+                decodedAttributes[aggregate.index] = dictionary;
+            }
+        }
+
+        SelectionFilter filter = nullptr;
+        if (!where.predicate.matchesAll() || !decodedAttributes.empty()) {
+            // Every partition copies the filter, so each thread adapts a predicate of its own.
+            filter = [predicate = where.predicate, decodedAttributes](std::vector<std::vector<std::string>> &rows,
+                                                                      std::vector<uint32_t> &selection) {
+                if (!predicate.matchesAll()) predicate.filter(rows, selection);
+                for (uint32_t row : selection){
+                    for (const auto &[index, dictionary] : decodedAttributes){
+                        if (index < rows[row].size()) rows[row][index] = dictionary->decode(rows[row][index]);
+                    }
+                }
+            };
+        }
+        aggregatedRows = aggregateRows(lines, groupIndexes, aggregates, filter);
+        addRowsExamined(lines.size());
+
+        for (size_t column = 0 ; column < groupIndexes.size() ; column++){
+            const Dictionary *dictionary = findDictionary(relation, groupIndexes[column]);
+            if (dictionary == nullptr) continue;
+
+            for (auto &row : aggregatedRows) row[column] = dictionary->decode(row[column]);
+        }
+    }
+    addRowsProduced(aggregatedRows.size());
+    endOperator();
+
+    // Groups are ordered by the group attributes of the order by clause, then by the remaining ones.
+    std::vector<SortKey> sortKeys;
+    std::vector<bool> ordered(groupAttributes.size(), false);
+    for (const auto &orderKey : orderKeys){
+        auto tokens = split(orderKey, ",");
+        auto it = std::find(groupAttributes.begin(), groupAttributes.end(), tokens[0]);
+        if (it == groupAttributes.end()) continue;
+
+        size_t column = it - groupAttributes.begin();
+        ordered[column] = true;
+        sortKeys.push_back(SortKey{column, getAttributeDataType(relation, tokens[0]),
+                                   tokens.size() > 1 && tokens[1] == "desc"});
+    }
+    for (size_t column = 0 ; column < groupAttributes.size() ; column++){
+        if (!ordered[column]) sortKeys.push_back(SortKey{column, getAttributeDataType(relation, groupAttributes[column]), false});
+    }
+    sortRows(aggregatedRows, sortKeys);
+
+    std::vector<std::vector<std::string>> columns(fetchItems.size());
+    for (const auto &row : aggregatedRows){
+        for (size_t item = 0 ; item < fetchItems.size() ; item++) columns[item].push_back(row[itemColumns[item]]);
+    }
+
+    return columns;
+}
+
+bool countFromPKIndex(Relation *relation, const std::vector<AggregateSpec> &aggregates,
+                      const std::vector<size_t> &groupIndexes, const WhereClause &where,
+                      std::vector<std::vector<std::string>> &aggregatedRows){
+    if (!groupIndexes.empty()) return false;
+
+    auto PKIndex = static_cast<size_t>(getRelationPKIndex(relation));
+    for (const auto &aggregate : aggregates){
+        if (aggregate.function != AggregateFunction::Count) return false;
+        if (aggregate.index != 0 && aggregate.index != PKIndex) return false;
+    }
+
+    // Only a where clause made of a single comparison of the PK can be answered from the PK index.
+    auto btreeIt = relationBTreeMap.find(relation);
+    if (!where.isKeyedByPK || !where.residual.matchesAll() || btreeIt == relationBTreeMap.end()) return false;
+
+    // The row is still read, another process may have ended its version in place since the index was built.
+    std::vector<std::string> row;
+    bool found = readRowByPK(relation, where.PK, row);
+    aggregatedRows = {std::vector<std::string>(aggregates.size(), found ? "1" : "0")};
+    return true;
+}
@@ -3,9 +3,78 @@
 #ifndef FQL_EXECUTOR_H
 #define FQL_EXECUTOR_H
 
+#include <functional>
 #include <unordered_map>
 #include "../../domain/schema/Schema.h"
+#include "../../domain/value/Value.h"
+#include "../../utils/data_structures/PKIndex/PKIndex.h"
 #include "../../interpretor/validator/validator.h"
+#include "../expression/expression.h"
+#include "../explain/explain.h"
+#include "../statistics/statistics.h"
+#include "../dictionary/dictionary.h"
+#include "../operators/sort/sort.h"
+#include "../operators/aggregate/aggregate.h"
+
+/**
+ * Location of a row in the file of its relation, so the row can be read or rewritten
+ * without scanning the file.
+ */
+struct RowLocator {
+    uint64_t offset;
+    uint32_t length;
+};
+
+/**
+ * Changes the tokens of a batch of rows in place, and sets the deleted flag of the rows it deletes.
+ */
+using RowMutator = std::function<void(std::vector<std::vector<std::string>> &rows, std::vector<uint8_t> &deleted)>;
+
+/**
+ * Where clause of a statement, compiled against its relation.
+ */
+struct WhereClause {
+    // Rows the statement applies to.
+    Predicate predicate;
+    // Set when the clause compares the PK to a constant, the only row it can match is then found through the PK index.
+    bool isKeyedByPK = false;
+    std::string PK;
+    // Rest of the clause, checked on the row found through the PK index.
+    Predicate residual;
+    // Tightest bounds the clause puts on the PK with '<', '<=', '>' and '>=', the rows between them are
+    // still checked against the predicate.
+    bool hasPKLow = false;
+    Value PKLow;
+    bool hasPKHigh = false;
+    Value PKHigh;
+};
+
+/**
+ * Update or delete statement read from the parsed code.
+ */
+struct Mutation {
+    bool isDelete = false;
+    Relation *relation = nullptr;
+    WhereClause where;
+    std::unordered_map<size_t, std::string> attributeValueMap;
+};
+
+/**
+ * Write of an explicit transaction, kept in memory until the transaction commits or reads.
+ */
+struct PendingWrite {
+    bool isAdd = false;
+    // Values of an added row without its RID, and its PK.
+    std::string row;
+    std::string PK;
+    // Update or delete, when the write is not an add.
+    Mutation mutation;
+};
+
+/**
+ * Share of dead rows (see getDeadRowRatio) from which a relation is compacted at the end of the execution.
+ */
+const double compactionThreshold = 0.25;
 
 /**
  * Executes the code after it has been parsed.
@@ -14,6 +83,22 @@
  */
 int executeCode(const std::string &filePath);
 
+/**
+ * Executes the build lines handed over by the builder, without going through a build file.
+ * @param codeLines Build lines to execute.
+ * @return Index of the next executed line.
+ */
+int executeCode(const std::vector<std::string> &codeLines);
+
+/**
+ * Splits a build line into its opcode and its argument.
+ * @param index Index of the line.
+ * @param codeLines Lines of the build file.
+ * @return Tokens of the line, a single empty opcode past the last line, which ends the loops over
+ * the lines of a statement.
+ */
+std::vector<std::string> getBuildLineTokens(size_t index, const std::vector<std::string> &codeLines);
+
 /**
  * Checks whether a given string is a method call.
  * @param method String to check for.
@@ -53,6 +138,61 @@ int executeRelationAttributes(int index, const std::vector<std::string> &codeLin
  */
 int executeMethodCall(int index, const std::vector<std::string> &codeLines);
 
+/**
+ * Executes a begin, commit or rollback statement. The statements outside of an explicit transaction
+ * run in an implicit one, which is committed at the next begin or at the end of the execution.
+ * @param index Index of the line that is executed.
+ * @param codeLines Lines of code to be executed.
+ * @return Index of the next executed line.
+ */
+int executeTransaction(int index, const std::vector<std::string> &codeLines);
+
+/**
+ * Applies the buffered writes and commits the current transaction.
+ */
+void commitWrites();
+
+/**
+ * Discards the buffered writes, aborts the current transaction and rebuilds the PK indexes and
+ * locators of the relations it wrote to.
+ */
+void rollbackWrites();
+
+/**
+ * Buffers a write of an explicit transaction.
+ * @param relation Relation the write is on.
+ * @param write Add, update or delete to buffer.
+ */
+void bufferWrite(Relation *relation, PendingWrite write);
+
+/**
+ * Applies the buffered writes of a relation, in the order they were made.
+ * @param relation Relation to write to.
+ */
+void flushPendingWrites(Relation *relation);
+
+/**
+ * Applies consecutive updates and deletes keyed by the PK of a relation. The rows are found through
+ * their locators, their old versions are ended with a single write and their new versions are
+ * appended with another, however many statements change them.
+ * @param relation Relation the statements are on.
+ * @param mutations Statements keyed by the PK, in the order they were written.
+ */
+void applyPKMutations(Relation *relation, const std::vector<Mutation> &mutations);
+
+/**
+ * Applies the buffered writes of every relation.
+ */
+void flushPendingWrites();
+
+/**
+ * Appends new rows to a relation with a single write, giving them consecutive RIDs.
+ * @param relation Relation to add to.
+ * @param rows Values of the rows, without their RIDs.
+ * @param PKs PKs of the rows.
+ */
+void appendRows(Relation *relation, const std::vector<std::string> &rows, const std::vector<std::string> &PKs);
+
 /**
  * Executes the relation add method in the parsed code.
  * @param index Index of the line that is executed.
@@ -69,6 +209,62 @@ int executeAddRelation(int index, const std::vector<std::string> &codeLines);
  */
 int executeUpdateRelation(int index, const std::vector<std::string> &codeLines);
 
+/**
+ * Reads an update or delete statement from the parsed code without executing it.
+ * @param index Index of the first line of the statement.
+ * @param codeLines Lines of code to be executed.
+ * @param mutation Statement that is read.
+ * @return Index of the line after the statement.
+ */
+int readMutation(int index, const std::vector<std::string> &codeLines, Mutation &mutation);
+
+/**
+ * Executes a single update or delete statement.
+ * @param mutation Statement to execute.
+ */
+void executeMutation(const Mutation &mutation);
+
+/**
+ * Executes a run of consecutive update and delete statements on the same relation. Statements that
+ * scan the relation are applied together in a single pass over its file.
+ * @param index Index of the first line of the run.
+ * @param codeLines Lines of code to be executed.
+ * @return Index of the line after the run.
+ */
+int executeMutationRun(int index, const std::vector<std::string> &codeLines);
+
+/**
+ * Applies update and delete statements on the same relation in a single read and write of its file.
+ * Each row goes through the statements in order, so it is matched against the values set by the
+ * previous ones, and a deleted row is not seen by the statements after the delete.
+ * @param run Statements to apply, in execution order.
+ */
+void applyMutationRun(const std::vector<Mutation> &run);
+
+/**
+ * Executes the relation compaction in the parsed code.
+ * @param index Index of the line that is executed.
+ * @param codeLines Lines of code to be executed.
+ * @return Index of the next executed line.
+ */
+int executeCompactRelation(int index, const std::vector<std::string> &codeLines);
+
+/**
+ * Executes the relation analysis in the parsed code.
+ * @param index Index of the line that is executed.
+ * @param codeLines Lines of code to be executed.
+ * @return Index of the next executed line.
+ */
+int executeAnalyzeRelation(int index, const std::vector<std::string> &codeLines);
+
+/**
+ * Executes the change of the compression level of a relation in the parsed code.
+ * @param index Index of the line that is executed.
+ * @param codeLines Lines of code to be executed.
+ * @return Index of the next executed line.
+ */
+int executeCompressRelation(int index, const std::vector<std::string> &codeLines);
+
 /**
  * Executes the relation deletion in the parsed code.
  * @param index Index of the line that is executed.
@@ -90,13 +286,16 @@ int executeArray(int index, const std::vector<std::string> &codeLines);
  * @param index Index of the line that is executed.
  * @param array Array to put the result in.
  * @param codeLines Lines of code to be executed.
- * @param validExpressions Set of expressions that can disjunctive true for the update to be executed.
- * (i.e. If either of the expressions is true, the update is executed)
+ * @param where Where clause the fetched rows satisfy.
+ * @param orderKeys Keys the fetched elements are ordered by, each of the form "attribute,direction".
+ * @param groupKeys Attributes the fetched elements are grouped by.
  * @return Index of the next executed line.
  */
 int executeFetchRelation(int index, const std::string &array,
                          const std::vector<std::string> &codeLines,
-                         const std::vector<std::string> &validExpressions);
+                         const WhereClause &where,
+                         const std::vector<std::string> &orderKeys,
+                         const std::vector<std::string> &groupKeys);
 
 /**
  * Executes the concatenation in the parsed code.
@@ -226,6 +425,15 @@ std::unordered_map<std::string, std::string> getPKLineMap(Relation *relation);
  */
 void buildRelationBTree(Relation *relation);
 
+/**
+ * Creates an empty PK index for a relation. The keys are stored as 64-bit integers for
+ * UUID, int, boolean, date and datetime PKs, inline for short char and varchar PKs and as
+ * values otherwise.
+ * @param relation Relation to create for.
+ * @return The created PK index.
+ */
+PKIndex *createPKIndex(Relation *relation);
+
 /**
  * Updates the Btree with a new value.
  * @param relation Relation to update for.
@@ -242,45 +450,67 @@ void updateRelationBTree(Relation *relation, const std::string &newKey);
 std::vector<std::string> tokenizeExpression(Relation *relation, const std::string &expression);
 
 /**
- * Checks if a query can be uniquely identified by the PK.
- * @param relation Relation to check in.
- * @param tokens Tokens of the expression.
- * @return True if the PK uniquely identifies the query, false otherwise.
+ * Reads the tree of a where or set clause from a build line. Build files written before the trees
+ * hold the infix text of the clause, which is parsed again.
+ * @param relation Relation the clause is on.
+ * @param text Text of the build line after its opcode.
+ * @param isSetClause True for a set clause, false for a where clause.
+ * @return Tree of the clause.
  */
-bool isPKQueried(Relation *relation, const std::vector<std::string> &tokens);
+Expression readClauseExpression(Relation *relation, const std::string &text, bool isSetClause);
 
 /**
- * Fetches the operation and the constant a PK is used for if the query is
- * uniquely identified by the PK.
- * @param relation Relation to check in.
- * @param tokens Tokens of the expression.
- * @return Vector of exactly two strings, first one is the operator, second is the constant.
+ * Compiles the where clause of a statement and matches it against the PK index.
+ * @param relation Relation the clause is on.
+ * @param text Text of the where build line after its opcode.
+ * @param emptyMatchesAll True if an empty clause matches every row (fetches), false if it matches none
+ * (updates and deletes).
+ * @return The compiled where clause.
  */
-std::vector<std::string> getPKQueryInformation(Relation *relation, const std::vector<std::string> &tokens);
+WhereClause compileWhereClause(Relation *relation, const std::string &text, bool emptyMatchesAll);
 
 /**
- * Handles the information of the PK if the query is uniquely identified by the PK for deletion.
- * @param relation Relation to check in.
- * @param info Vector of exactly two strings representing Information about the operation.
+ * Deletes the row found through the PK index for a where clause keyed by the PK.
+ * @param relation Relation to delete from.
+ * @param where Where clause keyed by the PK.
  */
-void handlePKInfoForDelete(Relation* relation, const std::vector<std::string> &info);
+void handlePKInfoForDelete(Relation* relation, const WhereClause &where);
 
 /**
- * Handles the information of the PK if the query is uniquely identified by the PK for updating.
- * @param relation Relation to check in.
- * @param info Vector of exactly two strings representing Information about the operation.
+ * Updates the row found through the PK index for a where clause keyed by the PK.
+ * @param relation Relation to update in.
+ * @param where Where clause keyed by the PK.
  * @param attributeValueMap Map that maps the index of the attribute to the new value it receives.
  */
-void handlePKInfoForUpdate(Relation* relation, const std::vector<std::string> &info,
+void handlePKInfoForUpdate(Relation* relation, const WhereClause &where,
                            const std::unordered_map<size_t, std::string> &attributeValueMap);
 
+/**
+ * Reads the row of a PK through the PK index. The locators are rebuilt first if another process changed
+ * the relation file, and the relation is scanned again if the located line does not hold the PK anymore.
+ * @param relation Relation the row is in.
+ * @param PK PK of the row.
+ * @param row Tokens of the row, set when it is found.
+ * @return True if the PK has a row the transaction sees, false otherwise.
+ */
+bool readRowByPK(Relation *relation, const std::string &PK, std::vector<std::string> &row);
+
+/**
+ * Checks whether a line of a relation file is a version of the row of a PK.
+ * @param relation Relation the line is in.
+ * @param line Line of the relation file.
+ * @param PK PK to look for.
+ * @return True if the PK attribute of the line holds the PK, false otherwise.
+ */
+bool isLineOfPK(Relation *relation, const std::string &line, const std::string &PK);
+
 /**
  * Adds a PK to the relationPKLineMap of a given relation.
  * @param relation Relation object.
  * @param pk Name of the PK.
- * @param line Line the PK is on.
+ * @param locator Location of the line the PK is on.
  */
-void addPKLineToRelationMap(Relation* relation, const std::string& pk, const std::string& line);
+void addPKLineToRelationMap(Relation* relation, const std::string& pk, const RowLocator &locator);
 
 /**
  * Creates the PKLineToRelation map for a relation.
@@ -296,6 +526,182 @@ void createPKLineToRelationMap(Relation* relation);
  */
 void updateRelationPKLineMap(Relation* relation, const std::string& schemaName, const std::string& relationName);
 
+/**
+ * Gets the share of the rows of a relation file that are old versions, ended by updates and deletes or never committed.
+ * @param relation Relation object.
+ * @return Amount of dead rows divided by the amount of dead and live rows, 0 for an empty relation.
+ */
+double getDeadRowRatio(Relation *relation);
+
+/**
+ * Rewrites the file of a relation without its dead rows and recomputes the locators of the live ones.
+ * The file is written compressed if the relation has a compression level.
+ * @param relation Relation to compact.
+ */
+void compactRelation(Relation *relation);
+
+/**
+ * Compacts every relation whose dead row ratio reached compactionThreshold, or whose file has to be
+ * compressed again after a write.
+ */
+void compactRelations();
+
+/**
+ * Gets the path of the file that holds the compression levels of the relations of a schema.
+ * @param relation Relation object.
+ * @return Path of the compression file of the schema of the relation, lines of "relation:level".
+ */
+std::string getCompressionPath(Relation *relation);
+
+/**
+ * Gets the compression level of a relation, kept in the compression file of its schema.
+ * @param relation Relation object.
+ * @return Compression level, 0 if the relation is not compressed.
+ */
+int getCompressionLevel(Relation *relation);
+
+/**
+ * Sets the compression level of a relation. The file of the relation is compressed the next time it is rewritten.
+ * @param relation Relation object.
+ * @param level Compression level, 0 to stop compressing the relation.
+ */
+void setCompressionLevel(Relation *relation, int level);
+
+/**
+ * Checks whether the file of a relation is compressed or not while its compression level says otherwise,
+ * which happens after a write decompressed it.
+ * @param relation Relation object.
+ * @return True if the file has to be rewritten, false otherwise.
+ */
+bool isCompressionPending(Relation *relation);
+
+/**
+ * Decompresses the file of a locked relation, so rows can be appended to it and stamped in place. The
+ * offsets of the lines do not change, so the locators stay valid.
+ * @param relation Relation object.
+ * @param filePath Path of the relation file.
+ */
+void inflateRelation(Relation *relation, const std::string &filePath);
+
+/**
+ * Collects the statistics of a relation from the rows the transaction sees and writes them to the
+ * statistics directory of its schema. The attributes the statistics show to have few distinct
+ * values are then dictionary encoded.
+ * @param relation Relation to analyze.
+ */
+void analyzeRelation(Relation *relation);
+
+/**
+ * Gets the path of the file that holds the dictionaries of the encoded attributes of a relation.
+ * @param relation Relation object.
+ * @return Path of the file in the dictionaries directory of the schema of the relation.
+ */
+std::string getDictionaryPath(Relation *relation);
+
+/**
+ * Loads the values other writers added to the dictionaries of a relation since they were last loaded,
+ * so the rows they wrote can be decoded. Every statement refreshes the dictionaries of its relation.
+ * @param relation Relation object.
+ */
+void refreshDictionaries(Relation *relation);
+
+/**
+ * Chooses the attributes of a relation to dictionary encode from its statistics: the char and
+ * varchar attributes other than the PK whose share of distinct values is at most dictionaryDistinctRatio.
+ * @param relation Relation object.
+ * @param statistics Statistics of the relation.
+ * @return Indexes of the attributes in a row, the ones already encoded excluded.
+ */
+std::vector<size_t> chooseEncodedAttributes(Relation *relation, const RelationStatistics &statistics);
+
+/**
+ * Dictionary encodes attributes of a relation: the dictionaries are started and every row of the
+ * relation file, old versions included, is rewritten with the codes of its values.
+ * @param relation Relation object.
+ * @param indexes Indexes of the attributes in a row.
+ */
+void encodeRelationAttributes(Relation *relation, const std::vector<size_t> &indexes);
+
+/**
+ * Reads the header and the visible rows of a relation file with the encoded attributes decoded.
+ * @param filePath Path of the relation file.
+ * @param relationName Name of the relation.
+ * @return Header of the relation followed by its rows.
+ */
+std::vector<std::string> readDecodedLines(const std::string &filePath, const std::string &relationName);
+
+/**
+ * Gets the statistics of a relation, read from its schema the first time they are needed.
+ * @param relation Relation to get the statistics of.
+ * @return Statistics of the relation, nullptr if it was never analyzed.
+ */
+const RelationStatistics *getRelationStatistics(Relation *relation);
+
+/**
+ * Chooses how the rows a where clause matches are reached: through the PK index for a single PK,
+ * through a PK range when its estimated cost is lower than the one of a full scan, or by a full scan.
+ * A PK range is only chosen for an analyzed relation.
+ * @param relation Relation the clause is on.
+ * @param where Compiled where clause.
+ * @return PKPointLookup, PKRange or FullScan.
+ */
+AccessPath chooseAccessPath(Relation *relation, const WhereClause &where);
+
+/**
+ * Reads the rows whose PK is in the PK bounds of a where clause, through the PK index and their locators.
+ * The rows are read in the order of the relation file and are not checked against the predicate. If a
+ * located line does not hold its PK anymore, the locators are rebuilt and the rows are read again.
+ * @param relation Relation the rows are in.
+ * @param where Where clause with PK bounds.
+ * @return Lines of the rows the transaction sees.
+ */
+std::vector<std::string> readPKRangeLines(Relation *relation, const WhereClause &where);
+
+/**
+ * Rebuilds the locators and the PK index of a relation if another process changed or replaced its file
+ * since they were built. A session keeps them between statements, so every read through them checks first.
+ * @param relation Relation object.
+ */
+void refreshRelationIndex(Relation *relation);
+
+/**
+ * Rebuilds the locators and the PK index of a relation from its file.
+ * @param relation Relation object.
+ */
+void rebuildRelationIndex(Relation *relation);
+
+/**
+ * Takes the write lock of a relation for the current transaction. The locators are rebuilt if another
+ * writer rewrote the file, and rows written before versioning are given a stamp.
+ * @param relation Relation object.
+ * @return Path of the relation file.
+ */
+std::string lockRelation(Relation *relation);
+
+/**
+ * Records the identity and size of a relation file after this process wrote to it, so that
+ * lockRelation only rebuilds the locators when another process changed the file.
+ * @param relation Relation object.
+ * @param filePath Path of the relation file.
+ */
+void updateRelationFileState(Relation *relation, const std::string &filePath);
+
+/**
+ * Rewrites the file of a locked relation without the row versions no transaction can see anymore.
+ * @param relation Relation object.
+ * @param filePath Path of the relation file.
+ * @param level Compression level the file is written with, the file is always rewritten when it is not 0.
+ */
+void rewriteRelation(Relation *relation, const std::string &filePath, int level = 0);
+
+/**
+ * Gets the location of the row that is uniquely identified by a PK in a relation.
+ * @param relation Relation to check in.
+ * @param primaryKey Primary key to check for.
+ * @return Pointer to the locator of the row, nullptr if the PK is not in the relation.
+ */
+const RowLocator *getPKLocator(Relation *relation, const std::string &primaryKey);
+
 /**
  * Returns the line that is uniquely identified by a PK in a relation.
  * @param relation Relation to check in.
@@ -322,46 +728,56 @@ void updateLinesByPK(const std::string &filePath, Relation* relation,
                      const std::string &PK, std::unordered_map<size_t, std::string> attributeValueMap);
 
 /**
- * Updates the lines from a file with the given specifications.
- * @param filePath Path to the file.
+ * Updates the lines of a relation with the given specifications.
  * @param relation Relation the update was called form.
- * @param validExpressions Set of expressions that can disjunctive true for the update to be executed.
- * (i.e. If either of the expressions is true, the update is executed)
+ * @param predicate Predicate the updated rows satisfy.
  * @param attributeValueMap Map that maps the index of the attribute to the new value it receives.
  */
-void updateLinesByNonPK(const std::string &filePath, Relation* relation,
-                        const std::vector<std::string> &validExpressions,
+void updateLinesByNonPK(Relation* relation, const Predicate &predicate,
                         std::unordered_map<size_t, std::string> attributeValueMap);
 
 /**
- * Deletes the lines from a file with the given specifications.
- * @param filePath Path to the file.
+ * Moves an updated row to its new key in the PK index and the PK line map when its PK changed.
+ * @param relation Relation the row is in.
+ * @param oldPK PK of the row before the update.
+ * @param newPK PK of the row after the update.
+ */
+void updatePKIndexForRow(Relation *relation, const std::string &oldPK, const std::string &newPK);
+
+/**
+ * Deletes the lines of a relation with the given specifications.
  * @param relation Relation the delete was called from.
- * @param validExpressions Set of expressions that can disjunctive true for the update to be executed.
- * (i.e. If either of the expressions is true, the update is executed)
+ * @param predicate Predicate the deleted rows satisfy.
+ */
+void deleteLinesByNonPK(Relation* relation, const Predicate &predicate);
+
+/**
+ * Passes every visible row of a relation through a mutator in a single scan, in batches of
+ * scanBatchRows rows. The versions of the changed and deleted rows are ended in place and the new
+ * versions are appended to the file.
+ * @param relation Relation to mutate.
+ * @param mutate Mutator applied to the tokens of every batch of rows.
  */
-void deleteLinesByNonPK(const std::string &filePath, Relation* relation,
-                        const std::vector<std::string> &validExpressions);
+void mutateVisibleRows(Relation *relation, const RowMutator &mutate);
 
 /**
  * Builds the attributeValueMap for a given relation.
  * @param relation Relation to build the map for.
- * @param statementTokens Tokens of the statement.
+ * @param assignments Tree of the set clause.
  * @return Map that maps the attribute to the value it will be replaced with in an update.
  */
-std::unordered_map<size_t, std::string> getAttributeValueMap(Relation *relation,
-                                                             const std::vector<std::string> &statementTokens);
+std::unordered_map<size_t, std::string> getAttributeValueMap(Relation *relation, const Expression &assignments);
 
 /**
  * Gets all the elements (entries) from a relation belonging to a given attribute.
  * @param relation Relation to get the elements from.
  * @param attribute Attribute of the elements.
- * @param validExpressions Set of expressions that can disjunctive true for the update to be executed.
- * (i.e. If either of the expressions is true, the update is executed)
- * @return Vector of strings representing the elements.
+ * @param where Where clause the rows of the elements satisfy, the row is read through the PK index
+ * when the clause is keyed by the PK.
+ * @return Vector of the decoded elements.
  */
-std::vector<std::string> getElementsByAttribute(Relation *relation, const std::string &attribute,
-                                                const std::vector<std::string> &validExpressions);
+std::vector<Value> getElementsByAttribute(Relation *relation, const std::string &attribute,
+                                          const WhereClause &where);
 
 /**
  * Gets the index of an attribute in a relation.
@@ -372,15 +788,91 @@ std::vector<std::string> getElementsByAttribute(Relation *relation, const std::s
 size_t getIndexOfAttribute(Relation *relation, const std::string &attribute);
 
 /**
- * Checks if any of the valid expressions can be applied to the given expression tokens.
- * @param relation Relation to check for.
- * @param tokens Expression tokens.
- * @param validExpressions Set of expressions that can disjunctive true for the update to be executed.
- * (i.e. If either of the expressions is true, the update is executed)
- * @return
+ * Gets the data type of an attribute in a relation.
+ * @param relation Relation the attribute is in.
+ * @param attribute Attribute to get the data type for.
+ * @return The data type of the attribute, nullptr if the attribute is not in the relation.
+ */
+Datatype *getAttributeDataType(Relation *relation, const std::string &attribute);
+
+/**
+ * Decodes a PK of a relation with the data type of its PK attribute.
+ * @param relation Relation the PK belongs to.
+ * @param PK Stored value of the PK.
+ * @return The decoded PK.
  */
-bool checkValidExpressions(Relation *relation, const std::vector<std::string> &tokens,
-                           const std::vector<std::string> &validExpressions);
+Value decodePK(Relation *relation, const std::string &PK);
 
+/**
+ * Gets the data type of the elements produced by a fetched item.
+ * @param relation Relation the item is fetched from.
+ * @param fetchItem Line describing the fetched item.
+ * @return The data type of the elements, nullptr if they are kept as strings.
+ */
+Datatype *getFetchItemDataType(Relation *relation, const std::string &fetchItem);
+
+/**
+ * Builds the sort keys of a relation from the keys of an order by clause.
+ * @param relation Relation the keys belong to.
+ * @param orderKeys Keys of the form "attribute,direction".
+ * @return Vector of sort keys, typed by the data type of each attribute.
+ */
+std::vector<SortKey> getSortKeys(Relation *relation, const std::vector<std::string> &orderKeys);
+
+/**
+ * Gets the rows of a relation that satisfy a predicate, ordered with the external sort.
+ * @param relation Relation to get the rows from.
+ * @param predicate Predicate the fetched rows satisfy.
+ * @param orderKeys Keys of the form "attribute,direction" to order by.
+ * @return Vector of rows, each split into its tokens.
+ */
+std::vector<std::vector<std::string>> getOrderedRows(Relation *relation,
+                                                     const Predicate &predicate,
+                                                     const std::vector<std::string> &orderKeys);
+/**
+ * Gets the fetched items (attributes and aggregates) of a relation in a fetch.
+ * @param index Index of the first line after the fetched relation.
+ * @param codeLines Lines of code to be executed.
+ * @return Vector of the lines describing the fetched items.
+ */
+std::vector<std::string> getFetchItems(int index, const std::vector<std::string> &codeLines);
+
+/**
+ * Checks whether a fetch from a relation has to be aggregated.
+ * @param relation Relation to fetch from.
+ * @param fetchItems Lines describing the fetched items.
+ * @param groupKeys Attributes of the group by clause.
+ * @return True if the fetch contains aggregates or is grouped, false otherwise.
+ */
+bool isAggregatedFetch(Relation *relation, const std::vector<std::string> &fetchItems,
+                       const std::vector<std::string> &groupKeys);
+
+/**
+ * Computes the aggregated fetch of a relation with the hash aggregation operator.
+ * @param relation Relation to fetch from.
+ * @param fetchItems Lines describing the fetched items.
+ * @param groupKeys Attributes of the group by clause.
+ * @param orderKeys Keys of the order by clause, applied to the group attributes.
+ * @param where Where clause the aggregated rows satisfy.
+ * @return One vector of elements for every fetched item.
+ */
+std::vector<std::vector<std::string>> getAggregatedColumns(Relation *relation,
+                                                           const std::vector<std::string> &fetchItems,
+                                                           const std::vector<std::string> &groupKeys,
+                                                           const std::vector<std::string> &orderKeys,
+                                                           const WhereClause &where);
+
+/**
+ * Answers a count over a where clause made of a single PK comparison straight from the PK index.
+ * @param relation Relation to count in.
+ * @param aggregates Aggregates of the fetch.
+ * @param groupIndexes Indexes of the group by attributes.
+ * @param where Where clause of the fetch.
+ * @param aggregatedRows Result of the count, if it could be answered.
+ * @return True if the count was answered from the index, false otherwise.
+ */
+bool countFromPKIndex(Relation *relation, const std::vector<AggregateSpec> &aggregates,
+                      const std::vector<size_t> &groupIndexes, const WhereClause &where,
+                      std::vector<std::vector<std::string>> &aggregatedRows);
 
 #endif //FQL_EXECUTOR_H
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "explain.h"
+#include "../../io/io.h"
+
+namespace {
+    struct OperatorProfile {
+        std::string name;
+        std::string relation;
+        AccessPath accessPath;
+        size_t depth;
+        size_t rowsExamined;
+        size_t rowsProduced;
+        uint64_t bytesRead;
+        uint64_t bytesWritten;
+        std::chrono::steady_clock::time_point start;
+        double time;
+    };
+
+    bool explainAll = false;
+    bool explainNext = false;
+
+    // Set while an explained statement runs, operators of other statements are not recorded.
+    bool explaining = false;
+    bool explicitlyExplained = false;
+    std::string currentStatement;
+    std::chrono::steady_clock::time_point statementStart;
+    uint64_t statementBytesRead = 0;
+    uint64_t statementBytesWritten = 0;
+
+    std::vector<OperatorProfile> operators;
+    std::vector<size_t> openOperators;
+
+    double elapsedMilliseconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void showPlan(double time, uint64_t bytesRead, uint64_t bytesWritten) {
+        std::cout << "Plan of " << currentStatement << "\n";
+        if (operators.empty()) std::cout << "  (no operator)\n";
+        else {
+            std::cout << std::left << std::setw(26) << "  operator" << std::setw(16) << "relation"
+                      << std::setw(18) << "access path" << std::right << std::setw(12) << "examined"
+                      << std::setw(12) << "produced" << std::setw(12) << "read(B)" << std::setw(12) << "written(B)"
+                      << std::setw(12) << "time(ms)" << "\n";
+        }
+
+        for (const auto &profile : operators) {
+            std::string name = "  " + std::string(2 * profile.depth, ' ') + profile.name;
+            std::cout << std::left << std::setw(26) << name << std::setw(16) << profile.relation
+                      << std::setw(18) << getAccessPathName(profile.accessPath) << std::right
+                      << std::setw(12) << profile.rowsExamined << std::setw(12) << profile.rowsProduced
+                      << std::setw(12) << profile.bytesRead << std::setw(12) << profile.bytesWritten
+                      << std::setw(12) << std::fixed << std::setprecision(3) << profile.time << "\n";
+        }
+
+        std::cout << std::left << std::setw(84) << "  statement" << std::right << std::setw(12) << bytesRead
+                  << std::setw(12) << bytesWritten << std::setw(12) << std::fixed << std::setprecision(3) << time
+                  << std::endl;
+    }
+}
+
+std::string getAccessPathName(AccessPath accessPath) {
+    switch (accessPath) {
+        case AccessPath::Append: return "append";
+        case AccessPath::PKPointLookup: return "PK point lookup";
+        case AccessPath::PKRange: return "PK range";
+        case AccessPath::PKIndex: return "PK index";
+        case AccessPath::FullScan: return "full scan";
+        case AccessPath::ExternalSort: return "external sort";
+        case AccessPath::Rewrite: return "rewrite";
+        case AccessPath::Buffered: return "buffered";
+    }
+    return "unknown";
+}
+
+void setExplainAll(bool enabled) {
+    explainAll = enabled;
+}
+
+void explainNextStatement() {
+    explainNext = true;
+}
+
+void beginStatement(const std::string &statement) {
+    explicitlyExplained = explainNext;
+    explaining = explainAll || explainNext;
+    explainNext = false;
+    if (!explaining) return;
+
+    currentStatement = statement;
+    operators.clear();
+    openOperators.clear();
+    statementStart = std::chrono::steady_clock::now();
+    statementBytesRead = getBytesRead();
+    statementBytesWritten = getBytesWritten();
+}
+
+void endStatement() {
+    if (!explaining) return;
+    explaining = false;
+
+    // With --explain, the statements that run no operator (declarations, arrays of constants) are not shown.
+    if (operators.empty() && !explicitlyExplained) return;
+    showPlan(elapsedMilliseconds(statementStart), getBytesRead() - statementBytesRead,
+             getBytesWritten() - statementBytesWritten);
+}
+
+void beginOperator(const std::string &name, const std::string &relation, AccessPath accessPath) {
+    if (!explaining) return;
+
+    operators.push_back(OperatorProfile{name, relation, accessPath, openOperators.size(), 0, 0,
+                                        getBytesRead(), getBytesWritten(), std::chrono::steady_clock::now(), 0});
+    openOperators.push_back(operators.size() - 1);
+}
+
+void setAccessPath(AccessPath accessPath) {
+    if (!explaining || openOperators.empty()) return;
+
+    operators[openOperators.back()].accessPath = accessPath;
+}
+
+void addRowsExamined(size_t rows) {
+    if (!explaining || openOperators.empty()) return;
+
+    operators[openOperators.back()].rowsExamined += rows;
+}
+
+void addRowsProduced(size_t rows) {
+    if (!explaining || openOperators.empty()) return;
+
+    operators[openOperators.back()].rowsProduced += rows;
+}
+
+void endOperator() {
+    if (!explaining || openOperators.empty()) return;
+
+    // The counters hold the totals until now, the operator gets the difference since it started.
+    OperatorProfile &profile = operators[openOperators.back()];
+    profile.bytesRead = getBytesRead() - profile.bytesRead;
+    profile.bytesWritten = getBytesWritten() - profile.bytesWritten;
+    profile.time = elapsedMilliseconds(profile.start);
+    openOperators.pop_back();
+}
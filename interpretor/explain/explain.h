@@ -0,0 +1,92 @@
+#pragma once
+
+#ifndef FQL_EXPLAIN_H
+#define FQL_EXPLAIN_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Way an operator reaches the rows of a relation.
+ */
+enum class AccessPath {
+    // Rows are appended to the end of the relation file.
+    Append,
+    // A single row is found through the PK index and its locator.
+    PKPointLookup,
+    // The rows whose PK is in a range are found through the PK index and read by their locators.
+    PKRange,
+    // The answer is read from the PK index alone, without reading rows.
+    PKIndex,
+    // Every row of the relation file is read.
+    FullScan,
+    // The rows are read and sorted in runs that are merged.
+    ExternalSort,
+    // The relation file is rewritten.
+    Rewrite,
+    // The write is kept in memory until the transaction commits or reads.
+    Buffered
+};
+
+/**
+ * Gets the name of an access path as it is shown in a plan.
+ * @param accessPath Access path.
+ * @return Name of the access path.
+ */
+std::string getAccessPathName(AccessPath accessPath);
+
+/**
+ * Explains every statement that runs an operator, used by the --explain flag of run.
+ * @param enabled True to explain every statement, false otherwise.
+ */
+void setExplainAll(bool enabled);
+
+/**
+ * Explains the next statement, used by the explain keyword.
+ */
+void explainNextStatement();
+
+/**
+ * Starts a statement. If the statement is explained, its operators are recorded until endStatement.
+ * @param statement First build line of the statement.
+ */
+void beginStatement(const std::string &statement);
+
+/**
+ * Ends the current statement and shows its plan if it is explained: the operators it ran with their
+ * access paths, the rows they examined and produced, the bytes they read and wrote and their wall time.
+ */
+void endStatement();
+
+/**
+ * Starts an operator of the current statement. Operators started before this one ends are nested in it.
+ * @param name Name of the operator.
+ * @param relation Name of the relation the operator works on.
+ * @param accessPath Way the operator reaches the rows.
+ */
+void beginOperator(const std::string &name, const std::string &relation, AccessPath accessPath);
+
+/**
+ * Changes the access path of the current operator, once it is known.
+ * @param accessPath Way the operator reaches the rows.
+ */
+void setAccessPath(AccessPath accessPath);
+
+/**
+ * Counts rows examined by the current operator.
+ * @param rows Amount of rows.
+ */
+void addRowsExamined(size_t rows);
+
+/**
+ * Counts rows produced (returned, written or deleted) by the current operator.
+ * @param rows Amount of rows.
+ */
+void addRowsProduced(size_t rows);
+
+/**
+ * Ends the current operator, measuring its wall time and the bytes it read and wrote.
+ */
+void endOperator();
+
+#endif //FQL_EXPLAIN_H
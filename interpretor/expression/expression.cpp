@@ -0,0 +1,803 @@
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "expression.h"
+#include "../dictionary/dictionary.h"
+#include "../../domain/datatype/Datatype.h"
+#include "../../utils/algorithms/algorithms.h"
+#include "../../utils/metrics/metrics.h"
+
+namespace {
+    struct Token {
+        std::string type;
+        std::string value;
+    };
+
+    const int orPrecedence = 1;
+    const int andPrecedence = 2;
+    const int comparisonPrecedence = 3;
+
+    bool isComparisonOperator(const std::string &op) {
+        return op == "==" || op == "!=" || op == "<" || op == "<=" || op == ">" || op == ">=";
+    }
+
+    bool isNumeric(const std::string &constant) {
+        if (!constant.empty() && constant[0] == '-') return isNumber(constant.substr(1));
+        return isNumber(constant);
+    }
+
+    bool isBooleanConstant(const Expression &expression) {
+        return (expression.kind == ExpressionKind::And || expression.kind == ExpressionKind::Or)
+               && expression.children.empty();
+    }
+
+    Expression makeBoolean(bool value) {
+        return value ? Expression{ExpressionKind::And, "and", {}} : Expression{ExpressionKind::Or, "or", {}};
+    }
+
+    /**
+     * Gets the operator that gives the same result with its operands swapped.
+     */
+    std::string flipOperator(const std::string &op) {
+        if (op == "<") return ">";
+        if (op == "<=") return ">=";
+        if (op == ">") return "<";
+        if (op == ">=") return "<=";
+        return op;
+    }
+
+    void checkConstant(const std::string &attribute, const std::string &dataType, const std::string &constant) {
+        if (dataType.empty() || Datatype::isNull(constant)) return;
+
+        bool valid = true;
+        if (dataType == "int" || dataType == "integer") valid = isNumeric(constant);
+        else if (dataType == "boolean") valid = isBoolean(constant);
+        else if (dataType == "date") valid = isDate(constant);
+        else if (dataType == "datetime") valid = isDateTime(constant);
+        else if (dataType == "UUID" || dataType == "uuid") valid = isUUID(constant);
+
+        if (!valid) {
+            throw std::runtime_error("Expected type '" + dataType + "' for the constant " + constant +
+                                     " used with " + attribute + "!");
+        }
+    }
+
+    /**
+     * Decides a comparison of two constants, as numbers when both are numbers and as text otherwise.
+     * An ordering with NULL is false, like in Predicate::compareValues.
+     */
+    bool compareConstants(const std::string &op, const std::string &first, const std::string &second) {
+        if (op != "==" && op != "!=" && (Datatype::isNull(first) || Datatype::isNull(second))) return false;
+
+        int result;
+        if (isNumeric(first) && isNumeric(second)) {
+            long long firstNumber = std::stoll(first);
+            long long secondNumber = std::stoll(second);
+            result = firstNumber < secondNumber ? -1 : firstNumber > secondNumber ? 1 : 0;
+        }
+        else result = first.compare(second);
+
+        if (op == "==") return result == 0;
+        if (op == "!=") return result != 0;
+        if (op == "<") return result < 0;
+        if (op == "<=") return result <= 0;
+        if (op == ">") return result > 0;
+        return result >= 0;
+    }
+
+    /**
+     * Precedence climbing parser over the scanned tokens of a where or set clause.
+     */
+    class ExpressionParser {
+    public:
+        ExpressionParser(const std::vector<std::string> &scannedTokens,
+                         const std::unordered_map<std::string, std::string> &dataTypes, bool isSetClause)
+            : dataTypes(dataTypes), isSetClause(isSetClause) {
+            for (const auto &scannedToken : scannedTokens) {
+                auto parts = split(scannedToken, ";");
+                tokens.push_back(Token{parts[0], parts.size() > 1 ? parts[1] : ""});
+            }
+        }
+
+        Expression parse() {
+            if (tokens.empty()) throw std::runtime_error("Expected an expression!");
+
+            Expression expression = parseBinary(orPrecedence);
+            if (position < tokens.size()) throw std::runtime_error("Unexpected '" + tokens[position].value + "'!");
+            return expression;
+        }
+
+    private:
+        std::vector<Token> tokens;
+        size_t position = 0;
+        const std::unordered_map<std::string, std::string> &dataTypes;
+        bool isSetClause;
+
+        bool isSeparator(const std::string &value) const {
+            return position < tokens.size() && tokens[position].type == "Separator" && tokens[position].value == value;
+        }
+
+        int getPrecedence() const {
+            if (position >= tokens.size() || tokens[position].type != "Separator") return 0;
+
+            const std::string &op = tokens[position].value;
+            if (op == "or") return orPrecedence;
+            if (op == "and") return andPrecedence;
+            if (isComparisonOperator(op) || op == "=") return comparisonPrecedence;
+            return 0;
+        }
+
+        Expression parseBinary(int minimumPrecedence) {
+            Expression left = parsePrimary();
+
+            int precedence;
+            while ((precedence = getPrecedence()) >= minimumPrecedence) {
+                std::string op = tokens[position].value;
+                if (op == "or" && isSetClause) throw std::runtime_error("Assignments can only be joined by 'and'!");
+                if (op == "=" && !isSetClause) throw std::runtime_error("Expected '==' instead of '=' in a where clause!");
+                if (isComparisonOperator(op) && isSetClause) {
+                    throw std::runtime_error("Expected '=' instead of '" + op + "' in a set clause!");
+                }
+                position++;
+
+                // Comparisons do not chain, so their right operand only takes tighter operators.
+                Expression right = parseBinary(precedence + 1);
+                if (precedence == comparisonPrecedence) {
+                    left = Expression{op == "=" ? ExpressionKind::Assignment : ExpressionKind::Comparison, op,
+                                      {std::move(left), std::move(right)}};
+                    if (getPrecedence() == comparisonPrecedence) {
+                        throw std::runtime_error("Comparisons cannot be chained, use 'and' between them!");
+                    }
+                    continue;
+                }
+
+                ExpressionKind kind = op == "and" ? ExpressionKind::And : ExpressionKind::Or;
+                Expression combined{kind, op, {}};
+                for (auto *operand : {&left, &right}) {
+                    if (operand->kind == kind && !operand->children.empty()) {
+                        for (auto &child : operand->children) combined.children.push_back(std::move(child));
+                    }
+                    else combined.children.push_back(std::move(*operand));
+                }
+                left = std::move(combined);
+            }
+
+            return left;
+        }
+
+        Expression parsePrimary() {
+            if (position >= tokens.size()) throw std::runtime_error("Unexpected end of expression!");
+
+            const Token &token = tokens[position];
+            if (isSeparator("(")) {
+                position++;
+                Expression expression = parseBinary(orPrecedence);
+                if (!isSeparator(")")) throw std::runtime_error("Expected ')' to close '('!");
+                position++;
+                return expression;
+            }
+
+            // A negative number is scanned as '-' followed by the number.
+            if (isSeparator("-") && position + 1 < tokens.size() && tokens[position + 1].type == "Constant"
+                && isNumeric(tokens[position + 1].value)) {
+                position += 2;
+                return Expression{ExpressionKind::Constant, "-" + tokens[position - 1].value, {}};
+            }
+
+            if (token.type == "Constant") {
+                position++;
+                return Expression{ExpressionKind::Constant, token.value, {}};
+            }
+
+            if (token.type == "Identifier") {
+                position++;
+                if (dataTypes.contains(token.value)) return Expression{ExpressionKind::Attribute, token.value, {}};
+                if (Datatype::isNull(token.value)) return Expression{ExpressionKind::Constant, "NULL", {}};
+                throw std::runtime_error("Unknown attribute " + token.value + "!");
+            }
+
+            throw std::runtime_error("Unexpected '" + token.value + "'!");
+        }
+    };
+
+    std::string getDataType(const std::unordered_map<std::string, std::string> &dataTypes,
+                            const std::string &attribute) {
+        auto it = dataTypes.find(attribute);
+        return it == dataTypes.end() ? "" : it->second;
+    }
+
+    /**
+     * Puts the attribute of a comparison or an assignment on the left and checks its constant.
+     */
+    void normalizeOperands(Expression &expression, const std::unordered_map<std::string, std::string> &dataTypes) {
+        Expression &left = expression.children[0];
+        Expression &right = expression.children[1];
+        for (const auto *operand : {&left, &right}) {
+            if (operand->kind != ExpressionKind::Attribute && operand->kind != ExpressionKind::Constant) {
+                throw std::runtime_error("Expected an attribute or a constant around '" + expression.value + "'!");
+            }
+        }
+
+        if (left.kind == ExpressionKind::Constant && right.kind == ExpressionKind::Attribute) {
+            std::swap(left, right);
+            expression.value = flipOperator(expression.value);
+        }
+
+        if (left.kind == ExpressionKind::Attribute && right.kind == ExpressionKind::Constant) {
+            checkConstant(left.value, getDataType(dataTypes, left.value), right.value);
+        }
+        else if (left.kind == ExpressionKind::Attribute && right.kind == ExpressionKind::Attribute
+                 && getDataType(dataTypes, left.value) != getDataType(dataTypes, right.value)) {
+            throw std::runtime_error("Cannot compare " + left.value + " and " + right.value +
+                                     " because their data types differ!");
+        }
+    }
+
+    Expression normalizeWhere(Expression expression, const std::unordered_map<std::string, std::string> &dataTypes) {
+        switch (expression.kind) {
+            case ExpressionKind::Attribute:
+                throw std::runtime_error("Expected a comparison instead of the attribute " + expression.value + "!");
+            case ExpressionKind::Constant:
+                if (!isBoolean(expression.value)) {
+                    throw std::runtime_error("Expected a comparison instead of the constant " + expression.value + "!");
+                }
+                return makeBoolean(expression.value == "true" || expression.value == "True" || expression.value == "1");
+            case ExpressionKind::Assignment:
+                throw std::runtime_error("Expected '==' instead of '=' in a where clause!");
+            case ExpressionKind::Comparison:
+                normalizeOperands(expression, dataTypes);
+                if (expression.children[0].kind == ExpressionKind::Constant) {
+                    return makeBoolean(compareConstants(expression.value, expression.children[0].value,
+                                                        expression.children[1].value));
+                }
+                return expression;
+            default:
+                break;
+        }
+
+        // A conjunction is decided by a false operand and a disjunction by a true one, the other constants are dropped.
+        bool isAnd = expression.kind == ExpressionKind::And;
+        Expression folded{expression.kind, expression.value, {}};
+        for (auto &child : expression.children) {
+            Expression normalized = normalizeWhere(std::move(child), dataTypes);
+            if (isBooleanConstant(normalized)) {
+                bool value = normalized.kind == ExpressionKind::And;
+                if (value != isAnd) return makeBoolean(value);
+                continue;
+            }
+
+            if (normalized.kind == expression.kind) {
+                for (auto &grandChild : normalized.children) folded.children.push_back(std::move(grandChild));
+            }
+            else folded.children.push_back(std::move(normalized));
+        }
+
+        if (folded.children.size() == 1) return std::move(folded.children[0]);
+        return folded;
+    }
+
+    Expression readExpression(const std::string &text, size_t &position) {
+        while (position < text.size() && text[position] == ' ') position++;
+        if (position >= text.size()) throw std::runtime_error("Unexpected end of serialized expression: " + text);
+
+        if (text[position] == '"') {
+            std::string constant;
+            for (position++ ; position < text.size() && text[position] != '"' ; position++) {
+                if (text[position] == '\\' && position + 1 < text.size()) position++;
+                constant += text[position];
+            }
+            if (position >= text.size()) throw std::runtime_error("Unterminated constant in serialized expression: " + text);
+            position++;
+            return Expression{ExpressionKind::Constant, constant, {}};
+        }
+
+        if (text[position] != '(') {
+            size_t start = position;
+            while (position < text.size() && text[position] != ' ' && text[position] != ')') position++;
+            return Expression{ExpressionKind::Attribute, text.substr(start, position - start), {}};
+        }
+
+        size_t start = ++position;
+        while (position < text.size() && text[position] != ' ' && text[position] != ')') position++;
+        std::string op = text.substr(start, position - start);
+
+        Expression expression{ExpressionKind::Comparison, op, {}};
+        if (op == "and") expression.kind = ExpressionKind::And;
+        else if (op == "or") expression.kind = ExpressionKind::Or;
+        else if (op == "=") expression.kind = ExpressionKind::Assignment;
+        else if (!isComparisonOperator(op)) throw std::runtime_error("Unknown operator " + op + " in serialized expression!");
+
+        while (true) {
+            while (position < text.size() && text[position] == ' ') position++;
+            if (position >= text.size()) throw std::runtime_error("Missing ')' in serialized expression: " + text);
+            if (text[position] == ')') break;
+            expression.children.push_back(readExpression(text, position));
+        }
+        position++;
+
+        bool isBinary = expression.kind == ExpressionKind::Comparison || expression.kind == ExpressionKind::Assignment;
+        if (isBinary && expression.children.size() != 2) {
+            throw std::runtime_error("Operator " + op + " takes two operands in serialized expression: " + text);
+        }
+        return expression;
+    }
+
+    // Observations kept per expression, older ones weigh less so the pass rates follow changing data.
+    const double selectivityWindow = 4096;
+    // Rows matched before the first reordering, the interval then grows up to the maximum.
+    const size_t firstAdaptInterval = 64;
+    const size_t maxAdaptInterval = 1024;
+
+    struct Selectivity {
+        double evaluated = 0;
+        double passed = 0;
+    };
+
+    // Pass rates of the where clause expressions of every relation, by serialized expression.
+    std::unordered_map<std::string, std::unordered_map<std::string, Selectivity>> relationSelectivities;
+    std::mutex selectivityMutex;
+
+    bool lookupPassRate(const std::string &relation, const std::string &key, double &passRate) {
+        std::lock_guard<std::mutex> lock(selectivityMutex);
+        auto relationIt = relationSelectivities.find(relation);
+        if (relationIt == relationSelectivities.end()) return false;
+
+        auto it = relationIt->second.find(key);
+        if (it == relationIt->second.end() || it->second.evaluated == 0) return false;
+
+        passRate = it->second.passed / it->second.evaluated;
+        return true;
+    }
+
+    double recordPassRate(const std::string &relation, const std::string &key, size_t evaluated, size_t passed) {
+        std::lock_guard<std::mutex> lock(selectivityMutex);
+        Selectivity &selectivity = relationSelectivities[relation][key];
+        selectivity.evaluated += evaluated;
+        selectivity.passed += passed;
+        if (selectivity.evaluated > selectivityWindow) {
+            selectivity.passed *= selectivityWindow / selectivity.evaluated;
+            selectivity.evaluated = selectivityWindow;
+        }
+        return selectivity.passed / selectivity.evaluated;
+    }
+
+    /**
+     * Gets the pass rate assumed for a comparison no row was evaluated against yet.
+     */
+    double getDefaultPassRate(const std::string &op) {
+        if (op == "==") return 0.1;
+        if (op == "!=") return 0.9;
+        return 1.0 / 3;
+    }
+
+    /**
+     * Checks if the values of a data type are decoded to integers, which is the case for int, bool, date and datetime.
+     */
+    bool isIntegralDatatype(Datatype *datatype) {
+        std::string name = datatype->getName();
+        return name == "int" || name == "bool" || name == "date" || name == "datetime";
+    }
+
+    /**
+     * Gets the cost of decoding and comparing a value of a data type, relative to an integer.
+     */
+    double getComparisonCost(Datatype *datatype) {
+        if (!isIntegralDatatype(datatype)) return 3;
+
+        std::string name = datatype->getName();
+        return name == "date" || name == "datetime" ? 2 : 1;
+    }
+}
+
+Expression parseExpression(const std::vector<std::string> &expressionTokens,
+                           const std::unordered_map<std::string, std::string> &dataTypes) {
+    return normalizeWhere(ExpressionParser(expressionTokens, dataTypes, false).parse(), dataTypes);
+}
+
+Expression parseAssignments(const std::vector<std::string> &statementTokens,
+                            const std::unordered_map<std::string, std::string> &dataTypes) {
+    Expression expression = ExpressionParser(statementTokens, dataTypes, true).parse();
+
+    std::vector<Expression *> assignments;
+    if (expression.kind == ExpressionKind::And) {
+        for (auto &child : expression.children) assignments.push_back(&child);
+    }
+    else assignments.push_back(&expression);
+
+    for (auto *assignment : assignments) {
+        if (assignment->kind != ExpressionKind::Assignment) {
+            throw std::runtime_error("Expected an assignment of a constant to an attribute!");
+        }
+
+        normalizeOperands(*assignment, dataTypes);
+        if (assignment->children[0].kind != ExpressionKind::Attribute
+            || assignment->children[1].kind != ExpressionKind::Constant) {
+            throw std::runtime_error("Expected an assignment of a constant to an attribute!");
+        }
+    }
+
+    return expression;
+}
+
+std::string serializeExpression(const Expression &expression) {
+    if (expression.kind == ExpressionKind::Attribute) return expression.value;
+    if (expression.kind == ExpressionKind::Constant) {
+        std::string quoted = "\"";
+        for (char character : expression.value) {
+            if (character == '"' || character == '\\') quoted += '\\';
+            quoted += character;
+        }
+        return quoted + "\"";
+    }
+
+    std::string serialized = "(" + expression.value;
+    for (const auto &child : expression.children) serialized += " " + serializeExpression(child);
+    return serialized + ")";
+}
+
+bool isSerializedExpression(const std::string &text) {
+    if (text.empty() || text[0] != '(') return false;
+
+    size_t end = text.find_first_of(" )", 1);
+    if (end == std::string::npos) return false;
+
+    std::string op = text.substr(1, end - 1);
+    return op == "and" || op == "or" || op == "=" || isComparisonOperator(op);
+}
+
+Expression deserializeExpression(const std::string &text) {
+    size_t position = 0;
+    Expression expression = readExpression(text, position);
+
+    while (position < text.size() && text[position] == ' ') position++;
+    if (position != text.size()) throw std::runtime_error("Unexpected text after serialized expression: " + text);
+    return expression;
+}
+
+bool splitKeyComparison(const Expression &expression, const std::string &attribute,
+                        std::string &constant, Expression &residual) {
+    auto isKeyComparison = [&attribute](const Expression &node) {
+        return node.kind == ExpressionKind::Comparison && node.value == "=="
+               && node.children[0].kind == ExpressionKind::Attribute && node.children[0].value == attribute
+               && node.children[1].kind == ExpressionKind::Constant;
+    };
+
+    if (isKeyComparison(expression)) {
+        constant = expression.children[1].value;
+        residual = makeBoolean(true);
+        return true;
+    }
+    if (expression.kind != ExpressionKind::And) return false;
+
+    for (size_t index = 0 ; index < expression.children.size() ; index++) {
+        if (!isKeyComparison(expression.children[index])) continue;
+
+        constant = expression.children[index].children[1].value;
+        residual = makeBoolean(true);
+        for (size_t other = 0 ; other < expression.children.size() ; other++) {
+            if (other != index) residual.children.push_back(expression.children[other]);
+        }
+        if (residual.children.size() == 1) residual = Expression(residual.children[0]);
+        return true;
+    }
+
+    return false;
+}
+
+std::vector<Expression> getKeyBounds(const Expression &expression, const std::string &attribute) {
+    auto isKeyBound = [&attribute](const Expression &node) {
+        return node.kind == ExpressionKind::Comparison
+               && (node.value == "<" || node.value == "<=" || node.value == ">" || node.value == ">=")
+               && node.children[0].kind == ExpressionKind::Attribute && node.children[0].value == attribute
+               && node.children[1].kind == ExpressionKind::Constant;
+    };
+
+    std::vector<Expression> bounds;
+    if (isKeyBound(expression)) bounds.push_back(expression);
+    else if (expression.kind == ExpressionKind::And) {
+        for (const auto &child : expression.children) {
+            if (isKeyBound(child)) bounds.push_back(child);
+        }
+    }
+    return bounds;
+}
+
+Predicate::Predicate() : adaptInterval(firstAdaptInterval) {}
+
+Predicate::Predicate(const Expression &expression, Relation *relation)
+    : relationName(relation->getName()), root(compile(expression, relation)), adaptInterval(firstAdaptInterval) {}
+
+Predicate::Node Predicate::compile(const Expression &expression, Relation *relation) {
+    Node node;
+    node.kind = expression.kind;
+    node.key = serializeExpression(expression);
+
+    if (expression.kind == ExpressionKind::And || expression.kind == ExpressionKind::Or) {
+        double otherRate = 1;
+        for (const auto &child : expression.children) {
+            node.children.push_back(compile(child, relation));
+            node.cost += node.children.back().cost;
+            otherRate *= expression.kind == ExpressionKind::And ? node.children.back().passRate
+                                                                : 1 - node.children.back().passRate;
+        }
+        // Without observations the operands are taken as independent.
+        if (!lookupPassRate(relation->getName(), node.key, node.passRate)) {
+            node.passRate = expression.kind == ExpressionKind::And ? otherRate : 1 - otherRate;
+        }
+        orderChildren(node);
+        return node;
+    }
+    if (expression.kind != ExpressionKind::Comparison) {
+        throw std::runtime_error("Expected a comparison in the where clause of " + relation->getName() + "!");
+    }
+
+    const std::string &op = expression.value;
+    if (op == "==") node.op = Operator::Equal;
+    else if (op == "!=") node.op = Operator::NotEqual;
+    else if (op == "<") node.op = Operator::Less;
+    else if (op == "<=") node.op = Operator::LessEqual;
+    else if (op == ">") node.op = Operator::Greater;
+    else node.op = Operator::GreaterEqual;
+
+    auto findAttribute = [relation](const std::string &attribute, Datatype *&datatype) -> size_t {
+        for (int index = 1 ; index <= relation->getAttributeNumber() ; index++) {
+            if (relation->getAttribute(index)->getName() != attribute) continue;
+
+            datatype = &relation->getAttribute(index)->getDataType();
+            return index;
+        }
+        throw std::runtime_error("Attribute " + attribute + " is not in relation " + relation->getName() + "!");
+    };
+
+    node.index = findAttribute(expression.children[0].value, node.datatype);
+    node.cost = getComparisonCost(node.datatype);
+    node.isIntegral = isIntegralDatatype(node.datatype);
+    if (expression.children[1].kind == ExpressionKind::Attribute) {
+        Datatype *otherDatatype;
+        node.otherIndex = findAttribute(expression.children[1].value, otherDatatype);
+        node.cost *= 2;
+    }
+    else node.constant = node.datatype->decode(expression.children[1].value);
+
+    node.dictionary = findDictionary(relation, node.index);
+    if (node.otherIndex != 0) node.otherDictionary = findDictionary(relation, node.otherIndex);
+    else if (node.dictionary != nullptr) {
+        // Every value of the dictionary is compared once, a row is then matched by looking up its code.
+        node.codePasses.resize(node.dictionary->size());
+        for (uint32_t code = 0 ; code < node.dictionary->size() ; code++) {
+            node.codePasses[code] = compareValues(node.op, node.datatype->decode(node.dictionary->getValue(code)), node.constant);
+        }
+        node.cost = 1;
+    }
+
+    if (!lookupPassRate(relation->getName(), node.key, node.passRate)) node.passRate = getDefaultPassRate(op);
+    return node;
+}
+
+void Predicate::orderChildren(Node &node) {
+    // A conjunction runs first the operands that reject the most rows for their cost, a disjunction
+    // the ones that accept the most. An operand that never decides the result goes last.
+    bool isAnd = node.kind == ExpressionKind::And;
+    auto getRank = [isAnd](const Node &child) {
+        double decidingRate = isAnd ? 1 - child.passRate : child.passRate;
+        return decidingRate <= 0 ? std::numeric_limits<double>::infinity() : child.cost / decidingRate;
+    };
+
+    std::stable_sort(node.children.begin(), node.children.end(), [&getRank](const Node &first, const Node &second) {
+        return getRank(first) < getRank(second);
+    });
+}
+
+void Predicate::adapt(Node &node, const std::string &relationName) {
+    if (node.evaluated > 0) {
+        node.passRate = recordPassRate(relationName, node.key, node.evaluated, node.passed);
+        node.evaluated = 0;
+        node.passed = 0;
+    }
+    if (node.children.empty()) return;
+
+    for (auto &child : node.children) adapt(child, relationName);
+    orderChildren(node);
+}
+
+bool Predicate::evaluate(Node &node, const std::vector<std::string> &row) {
+    bool result = false;
+    if (node.kind == ExpressionKind::And) {
+        result = true;
+        for (auto &child : node.children) {
+            if (!evaluate(child, row)) {
+                result = false;
+                break;
+            }
+        }
+    }
+    else if (node.kind == ExpressionKind::Or) {
+        for (auto &child : node.children) {
+            if (evaluate(child, row)) {
+                result = true;
+                break;
+            }
+        }
+    }
+    else result = compareRow(node, row);
+
+    node.evaluated++;
+    if (result) node.passed++;
+    return result;
+}
+
+bool Predicate::compareValues(Operator op, const Value &value, const Value &other) {
+    // NULL is only equal or not equal to a value, it is neither lower nor greater than any.
+    if (op != Operator::Equal && op != Operator::NotEqual && (value.isNull() || other.isNull())) return false;
+
+    int comparison = value.compare(other);
+    switch (op) {
+        case Operator::Equal: return comparison == 0;
+        case Operator::NotEqual: return comparison != 0;
+        case Operator::Less: return comparison < 0;
+        case Operator::LessEqual: return comparison <= 0;
+        case Operator::Greater: return comparison > 0;
+        case Operator::GreaterEqual: return comparison >= 0;
+    }
+    return false;
+}
+
+bool Predicate::compareRow(const Node &node, const std::vector<std::string> &row) {
+    if (node.index >= row.size() || node.otherIndex >= row.size()) return false;
+
+    const std::string &token = row[node.index];
+    uint32_t code;
+    if (node.otherIndex == 0 && node.dictionary != nullptr && node.dictionary->getCode(token, code)
+        && code < node.codePasses.size()) return node.codePasses[code];
+
+    Value value = node.datatype->decode(node.dictionary == nullptr ? token : node.dictionary->decode(token));
+    if (node.otherIndex == 0) return compareValues(node.op, value, node.constant);
+
+    const std::string &otherToken = row[node.otherIndex];
+    return compareValues(node.op, value, node.datatype->decode(node.otherDictionary == nullptr ? otherToken
+                                                               : node.otherDictionary->decode(otherToken)));
+}
+
+void Predicate::select(Node &node, const std::vector<std::vector<std::string>> &rows, std::vector<uint32_t> &selection) {
+    size_t evaluated = selection.size();
+
+    if (node.kind == ExpressionKind::And) {
+        // Every operand only looks at the rows the previous ones kept.
+        for (auto &child : node.children) {
+            if (selection.empty()) break;
+            select(child, rows, selection);
+        }
+    }
+    else if (node.kind == ExpressionKind::Or) {
+        // Every operand only looks at the rows the previous ones did not keep.
+        std::vector<uint32_t> remaining = std::move(selection);
+        selection.clear();
+        std::vector<uint32_t> passed, merged;
+        for (auto &child : node.children) {
+            if (remaining.empty()) break;
+
+            passed = remaining;
+            select(child, rows, passed);
+
+            merged.clear();
+            std::set_union(selection.begin(), selection.end(), passed.begin(), passed.end(), std::back_inserter(merged));
+            selection.swap(merged);
+
+            merged.clear();
+            std::set_difference(remaining.begin(), remaining.end(), passed.begin(), passed.end(), std::back_inserter(merged));
+            remaining.swap(merged);
+        }
+    }
+    else if (node.isIntegral && node.otherIndex == 0) selectIntegral(node, rows, selection);
+    else if (node.dictionary != nullptr && node.otherIndex == 0) selectEncoded(node, rows, selection);
+    else {
+        size_t kept = 0;
+        for (uint32_t row : selection) {
+            if (compareRow(node, rows[row])) selection[kept++] = row;
+        }
+        selection.resize(kept);
+    }
+
+    node.evaluated += evaluated;
+    node.passed += selection.size();
+}
+
+void Predicate::selectIntegral(const Node &node, const std::vector<std::vector<std::string>> &rows,
+                               std::vector<uint32_t> &selection) {
+    // The column of the batch is decoded first, rows without the attribute never match.
+    std::vector<int64_t> values(selection.size());
+    std::vector<uint8_t> nulls(selection.size());
+    size_t count = 0;
+    for (uint32_t row : selection) {
+        if (node.index >= rows[row].size()) continue;
+
+        Value value = node.datatype->decode(rows[row][node.index]);
+        selection[count] = row;
+        values[count] = value.getInteger();
+        nulls[count] = value.isNull();
+        count++;
+    }
+
+    // NULL equals NULL and differs from any other value, like in compareValues, but an ordering never matches it.
+    const int64_t constant = node.constant.getInteger();
+    const bool isConstantNull = node.constant.isNull();
+    const bool isOrdering = node.op != Operator::Equal && node.op != Operator::NotEqual;
+    std::vector<uint8_t> keep(count);
+    auto compareColumn = [&](auto test) {
+        for (size_t index = 0 ; index < count ; index++) {
+            int comparison = (values[index] > constant) - (values[index] < constant);
+            comparison = isConstantNull ? 1 : comparison;
+            comparison = nulls[index] ? (isConstantNull ? 0 : -1) : comparison;
+            keep[index] = test(comparison) & !(isOrdering & (nulls[index] | isConstantNull));
+        }
+    };
+    switch (node.op) {
+        case Operator::Equal: compareColumn([](int comparison) { return comparison == 0; }); break;
+        case Operator::NotEqual: compareColumn([](int comparison) { return comparison != 0; }); break;
+        case Operator::Less: compareColumn([](int comparison) { return comparison < 0; }); break;
+        case Operator::LessEqual: compareColumn([](int comparison) { return comparison <= 0; }); break;
+        case Operator::Greater: compareColumn([](int comparison) { return comparison > 0; }); break;
+        case Operator::GreaterEqual: compareColumn([](int comparison) { return comparison >= 0; }); break;
+    }
+
+    // Every row is written and the position only moves past the kept ones, so the loop has no branch.
+    size_t kept = 0;
+    for (size_t index = 0 ; index < count ; index++) {
+        selection[kept] = selection[index];
+        kept += keep[index];
+    }
+    selection.resize(kept);
+}
+
+void Predicate::selectEncoded(const Node &node, const std::vector<std::vector<std::string>> &rows,
+                              std::vector<uint32_t> &selection) {
+    // NULL and the codes added to the dictionary after the predicate was compiled are compared by their value.
+    size_t kept = 0;
+    for (uint32_t row : selection) {
+        if (node.index >= rows[row].size()) continue;
+
+        uint32_t code;
+        bool passed = node.dictionary->getCode(rows[row][node.index], code) && code < node.codePasses.size()
+                      ? node.codePasses[code] : compareRow(node, rows[row]);
+        selection[kept] = row;
+        kept += passed;
+    }
+    selection.resize(kept);
+}
+
+void Predicate::countRows(size_t rows) const {
+    if (relationName.empty()) return;
+
+    rowsSinceAdapt += rows;
+    if (rowsSinceAdapt >= adaptInterval) {
+        adapt(root, relationName);
+        rowsSinceAdapt = 0;
+        adaptInterval = std::min(adaptInterval * 4, maxAdaptInterval);
+    }
+}
+
+bool Predicate::matches(const std::vector<std::string> &row) const {
+    countMetric(Metric::PredicateEvaluations);
+    bool result = evaluate(root, row);
+    countRows(1);
+    return result;
+}
+
+void Predicate::filter(const std::vector<std::vector<std::string>> &rows, std::vector<uint32_t> &selection) const {
+    if (matchesAll()) return;
+
+    countMetric(Metric::PredicateEvaluations, selection.size());
+    size_t selected = selection.size();
+    select(root, rows, selection);
+    countRows(selected);
+}
+
+bool Predicate::matchesAll() const {
+    return root.kind == ExpressionKind::And && root.children.empty();
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+#ifndef FQL_EXPRESSION_H
+#define FQL_EXPRESSION_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "../../domain/relation/Relation.h"
+#include "../../domain/value/Value.h"
+
+class Dictionary;
+
+enum class ExpressionKind { Attribute, Constant, Comparison, And, Or, Assignment };
+
+/**
+ * Node of the tree of a where or set clause.
+ * kind Kind of the node.
+ * value Name of an attribute, text of a constant, or operator of a comparison, an assignment ("="),
+ * a conjunction ("and") or a disjunction ("or").
+ * children Operands of a comparison, an assignment, a conjunction or a disjunction. A conjunction
+ * without operands is always true and a disjunction without operands is always false.
+ */
+struct Expression {
+    ExpressionKind kind = ExpressionKind::And;
+    std::string value = "and";
+    std::vector<Expression> children;
+};
+
+/**
+ * Parses the tokens of a where clause with precedence climbing ('or' binds looser than 'and', which
+ * binds looser than the comparisons). Comparisons are rewritten so the attribute is on the left,
+ * comparisons of two constants and the conjunctions and disjunctions they decide are folded, and
+ * constants are checked against the data type of the attribute they are compared to.
+ * @param expressionTokens Scanned tokens of the where clause.
+ * @param dataTypes Data type of every attribute of the relation, an empty data type is not checked.
+ * @return Tree of the where clause.
+ * @throws std::runtime_error If the tokens are not a valid where clause.
+ */
+Expression parseExpression(const std::vector<std::string> &expressionTokens,
+                           const std::unordered_map<std::string, std::string> &dataTypes);
+
+/**
+ * Parses the tokens of a set clause, assignments of constants to attributes joined by 'and'.
+ * @param statementTokens Scanned tokens of the set clause.
+ * @param dataTypes Data type of every attribute of the relation, an empty data type is not checked.
+ * @return A single assignment, or a conjunction of assignments.
+ * @throws std::runtime_error If the tokens are not a valid set clause.
+ */
+Expression parseAssignments(const std::vector<std::string> &statementTokens,
+                            const std::unordered_map<std::string, std::string> &dataTypes);
+
+/**
+ * Serializes a tree into the prefix form written in the build file, e.g.
+ * (and (>= grade "5") (or (== Name "John") (== Name "Peter"))). Constants are always quoted.
+ * @param expression Tree to serialize.
+ * @return Serialized tree.
+ */
+std::string serializeExpression(const Expression &expression);
+
+/**
+ * Checks whether a where or set line of a build file holds a serialized tree, build files written
+ * before the trees hold the infix text of the clause instead.
+ * @param text Text of the line after its opcode.
+ * @return True if the text is a serialized tree, false otherwise.
+ */
+bool isSerializedExpression(const std::string &text);
+
+/**
+ * Reads a tree written by serializeExpression.
+ * @param text Serialized tree.
+ * @return The tree.
+ * @throws std::runtime_error If the text is not a serialized tree.
+ */
+Expression deserializeExpression(const std::string &text);
+
+/**
+ * Splits the comparison of an attribute to a constant with '==' off a where clause, when every row
+ * it matches has to satisfy that comparison (i.e. it is the clause or one of its conjuncts).
+ * @param expression Tree of the where clause.
+ * @param attribute Attribute to look for.
+ * @param constant Constant the attribute is compared to, set when the comparison is found.
+ * @param residual The rest of the clause, set when the comparison is found.
+ * @return True if the comparison was found, false otherwise.
+ */
+bool splitKeyComparison(const Expression &expression, const std::string &attribute,
+                        std::string &constant, Expression &residual);
+
+/**
+ * Finds the comparisons of an attribute to a constant with '<', '<=', '>' or '>=' that every row a
+ * where clause matches has to satisfy (i.e. the clause or its conjuncts).
+ * @param expression Tree of the where clause.
+ * @param attribute Attribute to look for.
+ * @return The comparisons, with the attribute on the left.
+ */
+std::vector<Expression> getKeyBounds(const Expression &expression, const std::string &attribute);
+
+/**
+ * Where clause compiled against a relation: attributes are resolved to their index in a row and
+ * constants are decoded once with the data type of the attribute they are compared to. NULL equals
+ * NULL and is ordered before any other value, like in the order by.
+ * Conjunctions stop at the first false operand and disjunctions at the first true one. The operands
+ * are ordered so the cheapest and most selective ones run first, from pass rates observed on the
+ * rows of the relation. The pass rates are kept per relation, so later where clauses start from
+ * them, and the operands are reordered while a scan runs. A predicate changes while it matches rows,
+ * so every thread needs a copy of its own.
+ * Scans filter batches of rows: every comparison narrows a selection vector over the batch in one
+ * loop, and comparisons of int, boolean, date and datetime attributes to a constant decode their
+ * column first, so the comparison itself is a branch free loop over integers.
+ * Comparisons of a dictionary encoded attribute to a constant are decided once per code of the
+ * dictionary when the predicate is compiled, rows are then matched by looking up their code.
+ */
+class Predicate {
+private:
+    enum class Operator { Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual };
+
+    struct Node {
+        ExpressionKind kind = ExpressionKind::And;
+        Operator op = Operator::Equal;
+        size_t index = 0;
+        Datatype *datatype = nullptr;
+        // Index of the second attribute when two attributes are compared, 0 when comparing to the constant.
+        size_t otherIndex = 0;
+        Value constant;
+        // True if the attribute decodes to an integer (int, boolean, date and datetime).
+        bool isIntegral = false;
+        // Dictionaries of the attributes when they are encoded, and whether the value of every code of
+        // the dictionary satisfies the comparison to the constant.
+        const Dictionary *dictionary = nullptr;
+        const Dictionary *otherDictionary = nullptr;
+        std::vector<uint8_t> codePasses;
+        std::vector<Node> children;
+
+        // Serialized expression of the node, the pass rates of the relation are kept under it.
+        std::string key;
+        // Estimated cost of evaluating the node once, relative to comparing two integers.
+        double cost = 0;
+        double passRate = 1;
+        // Rows evaluated and passed since the pass rate was last updated.
+        size_t evaluated = 0;
+        size_t passed = 0;
+    };
+
+    std::string relationName;
+    mutable Node root;
+    mutable size_t rowsSinceAdapt = 0;
+    mutable size_t adaptInterval;
+
+    static Node compile(const Expression &expression, Relation *relation);
+    static bool evaluate(Node &node, const std::vector<std::string> &row);
+    static bool compareValues(Operator op, const Value &value, const Value &other);
+    static bool compareRow(const Node &node, const std::vector<std::string> &row);
+    static void select(Node &node, const std::vector<std::vector<std::string>> &rows, std::vector<uint32_t> &selection);
+    static void selectIntegral(const Node &node, const std::vector<std::vector<std::string>> &rows,
+                               std::vector<uint32_t> &selection);
+    static void selectEncoded(const Node &node, const std::vector<std::vector<std::string>> &rows,
+                              std::vector<uint32_t> &selection);
+    void countRows(size_t rows) const;
+    static void orderChildren(Node &node);
+    static void adapt(Node &node, const std::string &relationName);
+
+public:
+    /**
+     * Creates a predicate that matches every row.
+     */
+    Predicate();
+
+    /**
+     * Compiles the tree of a where clause against a relation.
+     * @param expression Tree of the where clause.
+     * @param relation Relation the rows belong to.
+     * @throws std::runtime_error If the tree refers to an attribute that is not in the relation.
+     */
+    Predicate(const Expression &expression, Relation *relation);
+
+    /**
+     * Checks whether a row satisfies the predicate.
+     * @param row Tokens of the row, the RID first and then the attributes in declaration order.
+     * @return True if the row satisfies the predicate, false otherwise.
+     */
+    bool matches(const std::vector<std::string> &row) const;
+
+    /**
+     * Narrows a selection vector to the rows of a batch that satisfy the predicate.
+     * @param rows Tokens of the rows of the batch, each with the RID first and then the attributes.
+     * @param selection Indexes of the selected rows in ascending order, the rows that do not satisfy
+     * the predicate are removed from it.
+     */
+    void filter(const std::vector<std::vector<std::string>> &rows, std::vector<uint32_t> &selection) const;
+
+    /**
+     * Checks whether the predicate matches every row without looking at them.
+     * @return True if the predicate is always true, false otherwise.
+     */
+    bool matchesAll() const;
+};
+
+#endif //FQL_EXPRESSION_H
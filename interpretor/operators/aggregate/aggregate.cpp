@@ -0,0 +1,252 @@
+#include <string>
+#include <vector>
+#include <thread>
+#include <sstream>
+#include <cstdlib>
+
+#include "aggregate.h"
+#include "../../../utils/algorithms/algorithms.h"
+
+AggregateFunction getAggregateFunction(const std::string &name) {
+    if (name == "count") return AggregateFunction::Count;
+    else if (name == "sum") return AggregateFunction::Sum;
+    else if (name == "min") return AggregateFunction::Min;
+    else if (name == "max") return AggregateFunction::Max;
+    else if (name == "avg") return AggregateFunction::Avg;
+
+    throw std::runtime_error("Unknown aggregate function: " + name);
+}
+
+AccumulatorType getAccumulatorType(Datatype *datatype) {
+    if (datatype == nullptr) return AccumulatorType::Generic;
+
+    std::string name = datatype->getName();
+    if (name == "int") return AccumulatorType::Integer;
+    else if (name == "date") return AccumulatorType::Date;
+    else if (name == "datetime") return AccumulatorType::Datetime;
+
+    return AccumulatorType::Generic;
+}
+
+long long packTemporal(const std::string &value) {
+    long long packed = 0;
+    for (char chr : value) {
+        if (std::isdigit(chr)) packed = packed * 10 + (chr - '0');
+    }
+
+    return packed;
+}
+
+std::string unpackTemporal(long long packed, AccumulatorType type) {
+    std::string digits = std::to_string(packed);
+
+    if (type == AccumulatorType::Date) {
+        digits.insert(0, 8 - std::min<size_t>(8, digits.size()), '0');
+        return digits.substr(0, 4) + "-" + digits.substr(4, 2) + "-" + digits.substr(6, 2);
+    }
+
+    digits.insert(0, 14 - std::min<size_t>(14, digits.size()), '0');
+    return digits.substr(0, 4) + "-" + digits.substr(4, 2) + "-" + digits.substr(6, 2) + " " +
+           digits.substr(8, 2) + ":" + digits.substr(10, 2) + ":" + digits.substr(12, 2);
+}
+
+HashAggregator::HashAggregator(const std::vector<size_t> &_groupIndexes, const std::vector<AggregateSpec> &_aggregates)
+    : groupIndexes(_groupIndexes), aggregates(_aggregates) {
+    for (const auto &aggregate : aggregates) types.push_back(getAccumulatorType(aggregate.datatype));
+}
+
+void HashAggregator::add(const std::vector<std::string> &row) {
+    std::string key;
+    for (size_t index : groupIndexes) {
+        key += (index < row.size() ? row[index] : "") + '\x1f';
+    }
+
+    auto it = groups.find(key);
+    if (it == groups.end()) {
+        GroupState state;
+        for (size_t index : groupIndexes) state.groupValues.push_back(index < row.size() ? row[index] : "NULL");
+        state.accumulators.resize(aggregates.size());
+        it = groups.emplace(key, std::move(state)).first;
+    }
+
+    for (size_t aggregateIndex = 0 ; aggregateIndex < aggregates.size() ; aggregateIndex++) {
+        const AggregateSpec &aggregate = aggregates[aggregateIndex];
+        Accumulator &accumulator = it->second.accumulators[aggregateIndex];
+
+        // count() counts the rows, every other aggregate skips the NULL values.
+        if (aggregate.index == 0) {
+            accumulator.count++;
+            continue;
+        }
+
+        const std::string &value = aggregate.index < row.size() ? row[aggregate.index] : "";
+        if (Datatype::isNull(value)) continue;
+        accumulate(accumulator, aggregateIndex, value);
+    }
+}
+
+void HashAggregator::accumulate(Accumulator &accumulator, size_t aggregateIndex, const std::string &value) const {
+    AccumulatorType type = types[aggregateIndex];
+    AggregateFunction function = aggregates[aggregateIndex].function;
+
+    if (function == AggregateFunction::Count) {
+        accumulator.count++;
+        return;
+    }
+
+    if (type == AccumulatorType::Generic) {
+        Datatype *datatype = aggregates[aggregateIndex].datatype;
+        auto compare = [datatype](const std::string &first, const std::string &second) {
+            return datatype != nullptr ? datatype->compare(first, second) : first.compare(second);
+        };
+
+        if (accumulator.count == 0 || compare(value, accumulator.minimumText) < 0) accumulator.minimumText = value;
+        if (accumulator.count == 0 || compare(value, accumulator.maximumText) > 0) accumulator.maximumText = value;
+        accumulator.count++;
+        return;
+    }
+
+    long long packed = type == AccumulatorType::Integer ? std::strtoll(value.c_str(), nullptr, 10)
+                                                        : packTemporal(value);
+    if (accumulator.count == 0 || packed < accumulator.minimum) accumulator.minimum = packed;
+    if (accumulator.count == 0 || packed > accumulator.maximum) accumulator.maximum = packed;
+    accumulator.sum += packed;
+    accumulator.count++;
+}
+
+void HashAggregator::mergeAccumulator(Accumulator &target, const Accumulator &source, size_t aggregateIndex) const {
+    if (source.count == 0) return;
+    if (target.count == 0) {
+        target = source;
+        return;
+    }
+
+    if (types[aggregateIndex] == AccumulatorType::Generic) {
+        Datatype *datatype = aggregates[aggregateIndex].datatype;
+        auto compare = [datatype](const std::string &first, const std::string &second) {
+            return datatype != nullptr ? datatype->compare(first, second) : first.compare(second);
+        };
+
+        if (compare(source.minimumText, target.minimumText) < 0) target.minimumText = source.minimumText;
+        if (compare(source.maximumText, target.maximumText) > 0) target.maximumText = source.maximumText;
+    }
+    else {
+        target.minimum = std::min(target.minimum, source.minimum);
+        target.maximum = std::max(target.maximum, source.maximum);
+        target.sum += source.sum;
+    }
+    target.count += source.count;
+}
+
+void HashAggregator::merge(const HashAggregator &other) {
+    for (const auto &[key, state] : other.groups) {
+        auto it = groups.find(key);
+        if (it == groups.end()) {
+            groups.emplace(key, state);
+            continue;
+        }
+
+        for (size_t aggregateIndex = 0 ; aggregateIndex < aggregates.size() ; aggregateIndex++) {
+            mergeAccumulator(it->second.accumulators[aggregateIndex], state.accumulators[aggregateIndex], aggregateIndex);
+        }
+    }
+}
+
+std::string HashAggregator::finalize(const Accumulator &accumulator, size_t aggregateIndex) const {
+    AggregateFunction function = aggregates[aggregateIndex].function;
+    AccumulatorType type = types[aggregateIndex];
+
+    if (function == AggregateFunction::Count) return std::to_string(accumulator.count);
+    if (accumulator.count == 0) return "NULL";
+
+    if (type == AccumulatorType::Generic) {
+        if (function == AggregateFunction::Min) return accumulator.minimumText;
+        if (function == AggregateFunction::Max) return accumulator.maximumText;
+        return "NULL";
+    }
+
+    if (function == AggregateFunction::Sum) return std::to_string(accumulator.sum);
+    if (function == AggregateFunction::Avg) {
+        if (accumulator.sum % accumulator.count == 0) return std::to_string(accumulator.sum / accumulator.count);
+
+        std::ostringstream average;
+        average << static_cast<double>(accumulator.sum) / static_cast<double>(accumulator.count);
+        return average.str();
+    }
+
+    long long value = function == AggregateFunction::Min ? accumulator.minimum : accumulator.maximum;
+    if (type == AccumulatorType::Integer) return std::to_string(value);
+    return unpackTemporal(value, type);
+}
+
+size_t HashAggregator::getGroupNumber() const {
+    return groups.size();
+}
+
+std::vector<std::vector<std::string>> HashAggregator::getResults() const {
+    std::vector<std::vector<std::string>> results;
+
+    // Aggregating without group attributes returns exactly one row, even for an empty input.
+    if (groups.empty() && groupIndexes.empty()) {
+        std::vector<std::string> row;
+        for (size_t aggregateIndex = 0 ; aggregateIndex < aggregates.size() ; aggregateIndex++) {
+            row.push_back(finalize(Accumulator(), aggregateIndex));
+        }
+        results.push_back(row);
+        return results;
+    }
+
+    for (const auto &[key, state] : groups) {
+        std::vector<std::string> row = state.groupValues;
+        for (size_t aggregateIndex = 0 ; aggregateIndex < aggregates.size() ; aggregateIndex++) {
+            row.push_back(finalize(state.accumulators[aggregateIndex], aggregateIndex));
+        }
+        results.push_back(row);
+    }
+
+    return results;
+}
+
+std::vector<std::vector<std::string>> aggregateRows(const std::vector<std::string> &lines,
+                                                    const std::vector<size_t> &groupIndexes,
+                                                    const std::vector<AggregateSpec> &aggregates,
+                                                    const SelectionFilter &filter) {
+    size_t partitionNumber = std::max<size_t>(1, std::thread::hardware_concurrency());
+    partitionNumber = std::min(partitionNumber, std::max<size_t>(1, lines.size() / minRowsPerPartition));
+
+    std::vector<HashAggregator> partials(partitionNumber, HashAggregator(groupIndexes, aggregates));
+    auto aggregatePartition = [&](size_t partition) {
+        size_t start = lines.size() * partition / partitionNumber;
+        size_t end = lines.size() * (partition + 1) / partitionNumber;
+        // A filter can keep state while it runs, so every partition works on a copy.
+        SelectionFilter partitionFilter = filter;
+
+        std::vector<std::vector<std::string>> rows;
+        std::vector<uint32_t> selection;
+        for (size_t batchStart = start ; batchStart < end ; batchStart += scanBatchRows) {
+            rows.clear();
+            selection.clear();
+            for (size_t index = batchStart ; index < std::min(end, batchStart + scanBatchRows) ; index++) {
+                if (lines[index].empty()) continue;
+
+                selection.push_back(static_cast<uint32_t>(rows.size()));
+                rows.push_back(split(lines[index], ","));
+            }
+
+            if (partitionFilter) partitionFilter(rows, selection);
+            for (uint32_t row : selection) partials[partition].add(rows[row]);
+        }
+    };
+
+    if (partitionNumber == 1) aggregatePartition(0);
+    else {
+        std::vector<std::thread> workers;
+        for (size_t partition = 0 ; partition < partitionNumber ; partition++) {
+            workers.emplace_back(aggregatePartition, partition);
+        }
+        for (auto &worker : workers) worker.join();
+    }
+
+    for (size_t partition = 1 ; partition < partitionNumber ; partition++) partials[0].merge(partials[partition]);
+    return partials[0].getResults();
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#ifndef FQL_AGGREGATE_H
+#define FQL_AGGREGATE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "../sort/sort.h"
+
+/**
+ * Minimum number of rows a partition should have before the aggregation is split across threads.
+ */
+const size_t minRowsPerPartition = 16384;
+
+enum class AggregateFunction { Count, Sum, Min, Max, Avg };
+
+/**
+ * Representation used by an accumulator. Integer, Date and Datetime values are packed into
+ * 64 bit integers so they can be accumulated without comparing strings.
+ */
+enum class AccumulatorType { Integer, Date, Datetime, Generic };
+
+/**
+ * Describes one aggregate of a fetch.
+ * function Aggregate function to compute.
+ * index Index of the aggregated attribute in a row, 0 to count the rows.
+ * datatype Data type of the aggregated attribute, nullptr when counting the rows.
+ */
+struct AggregateSpec {
+    AggregateFunction function;
+    size_t index;
+    Datatype *datatype;
+};
+
+/**
+ * Partial result of one aggregate for one group.
+ */
+struct Accumulator {
+    long long count = 0;
+    long long sum = 0;
+    long long minimum = 0;
+    long long maximum = 0;
+    std::string minimumText;
+    std::string maximumText;
+};
+
+/**
+ * Partial results of all the aggregates of one group.
+ */
+struct GroupState {
+    std::vector<std::string> groupValues;
+    std::vector<Accumulator> accumulators;
+};
+
+/**
+ * Hash aggregation operator. Rows are grouped by the values of the group attributes and every
+ * aggregate is accumulated in the same pass. Partial aggregators built over different partitions
+ * can be merged.
+ */
+class HashAggregator {
+private:
+    std::vector<size_t> groupIndexes;
+    std::vector<AggregateSpec> aggregates;
+    std::vector<AccumulatorType> types;
+    std::unordered_map<std::string, GroupState> groups;
+
+    void accumulate(Accumulator &accumulator, size_t aggregateIndex, const std::string &value) const;
+    void mergeAccumulator(Accumulator &target, const Accumulator &source, size_t aggregateIndex) const;
+    std::string finalize(const Accumulator &accumulator, size_t aggregateIndex) const;
+
+public:
+    HashAggregator(const std::vector<size_t> &_groupIndexes, const std::vector<AggregateSpec> &_aggregates);
+
+    void add(const std::vector<std::string> &row);
+    void merge(const HashAggregator &other);
+
+    [[nodiscard]] size_t getGroupNumber() const;
+    [[nodiscard]] std::vector<std::vector<std::string>> getResults() const;
+};
+
+/**
+ * Gets the aggregate function with a given name.
+ * @param name Name of the function (count, sum, min, max or avg).
+ * @return The aggregate function.
+ */
+AggregateFunction getAggregateFunction(const std::string &name);
+
+/**
+ * Gets the accumulator representation for a data type.
+ * @param datatype Data type of the aggregated attribute.
+ * @return The accumulator type.
+ */
+AccumulatorType getAccumulatorType(Datatype *datatype);
+
+/**
+ * Packs a Date or Datetime value into an integer keeping its chronological order.
+ * @param value Stored value (YYYY-MM-DD or YYYY-MM-DD hh:mm:ss).
+ * @return The packed value.
+ */
+long long packTemporal(const std::string &value);
+
+/**
+ * Unpacks a Date or Datetime value packed by packTemporal.
+ * @param packed Packed value.
+ * @param type Type of the value (Date or Datetime).
+ * @return The stored representation of the value.
+ */
+std::string unpackTemporal(long long packed, AccumulatorType type);
+
+/**
+ * Aggregates rows with a hash aggregation split into parallel partitions. The filter and the
+ * aggregation run in the same pass, and the partial results are merged at the end.
+ * @param lines Lines of the relation (without the header).
+ * @param groupIndexes Indexes of the group by attributes in a row.
+ * @param aggregates Aggregates to compute.
+ * @param filter Filter applied to every batch of rows, nullptr to keep all rows. Every partition runs a copy of it.
+ * @return One row per group: the group values followed by the aggregate values.
+ */
+std::vector<std::vector<std::string>> aggregateRows(const std::vector<std::string> &lines,
+                                                    const std::vector<size_t> &groupIndexes,
+                                                    const std::vector<AggregateSpec> &aggregates,
+                                                    const SelectionFilter &filter = nullptr);
+
+#endif //FQL_AGGREGATE_H
@@ -0,0 +1,127 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+
+#include "join.h"
+#include "../../../utils/algorithms/algorithms.h"
+#include "../../../io/io.h"
+
+namespace {
+    /**
+     * Reads the rows of a sorted join input one at a time.
+     */
+    class SortedRowReader {
+    private:
+        std::ifstream fin;
+        std::vector<std::string> row;
+        bool valid;
+
+    public:
+        explicit SortedRowReader(const std::string &filePath) : fin(filePath), valid(false) {
+            if (!fin.is_open()) throw std::runtime_error("File path " + filePath + " does not exist!");
+        }
+
+        void skipLine() {
+            std::string line;
+            getline(fin, line);
+        }
+
+        bool next() {
+            std::string line;
+            while (getline(fin, line)) {
+                if (isFreeLine(line)) continue;
+                row = split(line, ",");
+                valid = true;
+                return true;
+            }
+
+            valid = false;
+            return false;
+        }
+
+        [[nodiscard]] bool hasRow() const { return valid; }
+        [[nodiscard]] const std::vector<std::string>& current() const { return row; }
+    };
+
+    std::string prepareInput(const JoinInput &input, size_t memoryBudget, bool &skipHeader) {
+        if (input.sorted) {
+            skipHeader = input.hasHeader;
+            return input.filePath;
+        }
+
+        std::string sortedPath = createTemporaryPath("fql_join");
+        externalSort(input.filePath, sortedPath, {SortKey{input.keyIndex, input.datatype, false}},
+                     input.hasHeader, nullptr, memoryBudget);
+
+        skipHeader = false;
+        return sortedPath;
+    }
+
+    const std::string& keyOf(const std::vector<std::string> &row, size_t keyIndex) {
+        static const std::string empty;
+        return keyIndex < row.size() ? row[keyIndex] : empty;
+    }
+}
+
+size_t mergeJoin(const JoinInput &left, const JoinInput &right, const JoinEmitter &emit, size_t memoryBudget) {
+    bool skipLeftHeader;
+    bool skipRightHeader;
+    std::string leftPath = prepareInput(left, memoryBudget, skipLeftHeader);
+    std::string rightPath = prepareInput(right, memoryBudget, skipRightHeader);
+
+    Datatype *datatype = left.datatype;
+    auto compareKeys = [datatype](const std::string &first, const std::string &second) {
+        return datatype != nullptr ? datatype->compare(first, second) : first.compare(second);
+    };
+
+    SortedRowReader leftReader(leftPath);
+    SortedRowReader rightReader(rightPath);
+    if (skipLeftHeader) leftReader.skipLine();
+    if (skipRightHeader) rightReader.skipLine();
+
+    leftReader.next();
+    rightReader.next();
+
+    size_t emitted = 0;
+    std::vector<std::vector<std::string>> group;
+    while (leftReader.hasRow() && rightReader.hasRow()) {
+        const std::string &leftKey = keyOf(leftReader.current(), left.keyIndex);
+        const std::string &rightKey = keyOf(rightReader.current(), right.keyIndex);
+
+        if (Datatype::isNull(leftKey)) {
+            leftReader.next();
+            continue;
+        }
+        if (Datatype::isNull(rightKey)) {
+            rightReader.next();
+            continue;
+        }
+
+        int result = compareKeys(leftKey, rightKey);
+        if (result < 0) leftReader.next();
+        else if (result > 0) rightReader.next();
+        else {
+            // Buffer every left row with this key, then pair it with the equal right rows.
+            std::string key = leftKey;
+            group.clear();
+            while (leftReader.hasRow() && compareKeys(keyOf(leftReader.current(), left.keyIndex), key) == 0) {
+                group.push_back(leftReader.current());
+                leftReader.next();
+            }
+
+            while (rightReader.hasRow() && compareKeys(keyOf(rightReader.current(), right.keyIndex), key) == 0) {
+                for (const auto &leftRow : group) {
+                    emit(leftRow, rightReader.current());
+                    emitted++;
+                }
+                rightReader.next();
+            }
+        }
+    }
+
+    if (!left.sorted) std::filesystem::remove(leftPath);
+    if (!right.sorted) std::filesystem::remove(rightPath);
+
+    return emitted;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#ifndef FQL_JOIN_H
+#define FQL_JOIN_H
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "../sort/sort.h"
+
+/**
+ * Describes one side of a merge join.
+ * filePath Path of the CSV file holding the rows.
+ * hasHeader True if the first line of the file is a header, false otherwise.
+ * keyIndex Index of the join attribute in a row.
+ * datatype Data type of the join attribute.
+ * sorted True if the rows are already ordered by the join attribute (i.e. a PK range), false otherwise.
+ */
+struct JoinInput {
+    std::string filePath;
+    bool hasHeader;
+    size_t keyIndex;
+    Datatype *datatype;
+    bool sorted;
+};
+
+/**
+ * Callback receiving every pair of matching rows.
+ */
+using JoinEmitter = std::function<void(const std::vector<std::string> &left, const std::vector<std::string> &right)>;
+
+/**
+ * Joins two inputs on equal keys with a sort-merge join. Unsorted inputs are ordered with the
+ * external sort first, so the join only needs memory for the rows sharing the same key.
+ * NULL keys never match.
+ * @param left Left input of the join.
+ * @param right Right input of the join.
+ * @param emit Callback receiving the matching rows.
+ * @param memoryBudget Memory budget used when an input has to be sorted.
+ * @return Number of emitted pairs.
+ */
+size_t mergeJoin(const JoinInput &left, const JoinInput &right, const JoinEmitter &emit,
+                 size_t memoryBudget = defaultSortMemoryBudget);
+
+#endif //FQL_JOIN_H
@@ -0,0 +1,167 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <unistd.h>
+
+#include "sort.h"
+#include "../../../utils/algorithms/algorithms.h"
+#include "../../../io/io.h"
+#include "../../../utils/metrics/metrics.h"
+#include "../../../utils/data_structures/LoserTree/LoserTree.h"
+
+namespace {
+    struct RowLess {
+        const std::vector<SortKey> *keys;
+
+        bool operator()(const std::vector<std::string> &first, const std::vector<std::string> &second) const {
+            return compareRows(*keys, first, second) < 0;
+        }
+    };
+
+    void writeRun(const std::string &runPath, const std::vector<std::vector<std::string>> &rows) {
+        countMetric(Metric::FileOpens);
+        std::ofstream fout(runPath);
+        if (!fout.is_open()) throw std::runtime_error("Could not create sort run: " + runPath);
+
+        for (const auto &row : rows) fout << join(row, ",") << '\n';
+        fout.close();
+        recordBytesWritten(getFileSize(runPath));
+    }
+
+    size_t estimateRowSize(const std::string &line, const std::vector<std::string> &tokens) {
+        return line.size() + sizeof(std::vector<std::string>) + tokens.size() * sizeof(std::string);
+    }
+}
+
+int compareRows(const std::vector<SortKey> &keys, const std::vector<std::string> &first,
+                const std::vector<std::string> &second) {
+    for (const auto &key : keys) {
+        const std::string &firstValue = key.index < first.size() ? first[key.index] : "";
+        const std::string &secondValue = key.index < second.size() ? second[key.index] : "";
+
+        int result = key.datatype != nullptr ? key.datatype->compare(firstValue, secondValue)
+                                             : firstValue.compare(secondValue);
+        if (result != 0) return key.descending ? -result : result;
+    }
+
+    return 0;
+}
+
+void sortRows(std::vector<std::vector<std::string>> &rows, const std::vector<SortKey> &keys) {
+    std::stable_sort(rows.begin(), rows.end(), RowLess{&keys});
+}
+
+std::string createTemporaryPath(const std::string &prefix) {
+    static size_t counter = 0;
+    std::filesystem::path directory = std::filesystem::temp_directory_path();
+    std::string fileName = prefix + "_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+
+    return (directory / fileName).string();
+}
+
+size_t externalSort(const std::string &inputPath, const std::string &outputPath,
+                    const std::vector<SortKey> &keys, bool skipHeader,
+                    const RowFilter &filter, size_t memoryBudget) {
+    std::vector<std::string> runPaths;
+    std::vector<std::vector<std::string>> run;
+    size_t runSize = 0;
+    size_t rowCount = 0;
+
+    // The input is read through io, so a compressed relation is sorted like any other.
+    forEachLine(inputPath, [&](uint64_t offset, const std::string &line) {
+        if ((skipHeader && offset == 0) || isFreeLine(line)) return;
+
+        auto tokens = split(line, ",");
+        if (filter && !filter(tokens)) return;
+
+        runSize += estimateRowSize(line, tokens);
+        run.push_back(std::move(tokens));
+        rowCount++;
+
+        if (runSize >= memoryBudget) {
+            sortRows(run, keys);
+            runPaths.push_back(createTemporaryPath("fql_run"));
+            writeRun(runPaths.back(), run);
+
+            run.clear();
+            runSize = 0;
+        }
+    });
+
+    // Everything fits in one run, so there is nothing to merge.
+    if (runPaths.empty()) {
+        sortRows(run, keys);
+        writeRun(outputPath, run);
+        return rowCount;
+    }
+
+    if (!run.empty()) {
+        sortRows(run, keys);
+        runPaths.push_back(createTemporaryPath("fql_run"));
+        writeRun(runPaths.back(), run);
+        run.clear();
+    }
+
+    mergeRuns(runPaths, outputPath, keys);
+    return rowCount;
+}
+
+void mergeRuns(const std::vector<std::string> &runPaths, const std::string &outputPath,
+               const std::vector<SortKey> &keys) {
+    std::vector<std::string> pending = runPaths;
+
+    // Merge in several passes if there are more runs than files we are willing to keep open.
+    while (pending.size() > maxSortFanIn) {
+        std::vector<std::string> merged;
+        for (size_t start = 0 ; start < pending.size() ; start += maxSortFanIn) {
+            size_t end = std::min(start + maxSortFanIn, pending.size());
+            std::vector<std::string> group(pending.begin() + (long) start, pending.begin() + (long) end);
+
+            merged.push_back(createTemporaryPath("fql_run"));
+            mergeRuns(group, merged.back(), keys);
+        }
+        pending = merged;
+    }
+
+    std::vector<std::ifstream> readers;
+    std::vector<std::vector<std::string>> heads;
+    std::vector<bool> exhausted;
+    readers.reserve(pending.size());
+    countMetric(Metric::FileOpens, pending.size() + 1);
+
+    for (const auto &runPath : pending) {
+        readers.emplace_back(runPath);
+        std::string line;
+
+        if (getline(readers.back(), line)) {
+            heads.push_back(split(line, ","));
+            exhausted.push_back(false);
+        }
+        else {
+            heads.emplace_back();
+            exhausted.push_back(true);
+        }
+    }
+
+    std::ofstream fout(outputPath);
+    if (!fout.is_open()) throw std::runtime_error("Could not create sort output: " + outputPath);
+
+    LoserTree<std::vector<std::string>, RowLess> tree(heads, exhausted, RowLess{&keys});
+    std::string line;
+    while (!tree.empty()) {
+        fout << join(tree.top(), ",") << '\n';
+
+        if (getline(readers[tree.winner()], line)) tree.replaceTop(split(line, ","));
+        else tree.exhaustTop();
+    }
+    fout.close();
+    recordBytesWritten(getFileSize(outputPath));
+
+    for (auto &reader : readers) reader.close();
+    for (const auto &runPath : pending) {
+        recordBytesRead(getFileSize(runPath));
+        std::filesystem::remove(runPath);
+    }
+}
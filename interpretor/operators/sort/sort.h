@@ -0,0 +1,101 @@
+#pragma once
+
+#ifndef FQL_SORT_H
+#define FQL_SORT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+#include "../../../domain/datatype/Datatype.h"
+
+/**
+ * Memory budget (in bytes) used for the sorted runs when none is given.
+ */
+const size_t defaultSortMemoryBudget = 64 * 1024 * 1024;
+
+/**
+ * Maximum number of runs merged at once, bounding the number of open files.
+ */
+const size_t maxSortFanIn = 64;
+
+/**
+ * Describes one key of an ordering.
+ * index Index of the token in a row (0 is the RID).
+ * datatype Data type of the attribute, used to compare the values.
+ * descending True if the key is ordered descending, false otherwise.
+ */
+struct SortKey {
+    size_t index;
+    Datatype *datatype;
+    bool descending;
+};
+
+/**
+ * Filter applied to the rows before they are sorted, it may also rewrite the tokens of the rows it keeps.
+ */
+using RowFilter = std::function<bool(std::vector<std::string> &row)>;
+
+/**
+ * Filter applied to a batch of rows at once: it removes from a selection vector (indexes of rows of
+ * the batch, in ascending order) the rows that are not kept. Like a RowFilter, it may also rewrite
+ * the tokens of the rows it keeps.
+ */
+using SelectionFilter = std::function<void(std::vector<std::vector<std::string>> &rows,
+                                           std::vector<uint32_t> &selection)>;
+
+/**
+ * Amount of rows a scan splits and filters at once.
+ */
+const size_t scanBatchRows = 2048;
+
+/**
+ * Compares two rows based on a list of sort keys.
+ * @param keys Keys to compare by, in order of priority.
+ * @param first Tokens of the first row.
+ * @param second Tokens of the second row.
+ * @return Negative if first goes before second, 0 if they are equal, positive otherwise.
+ */
+int compareRows(const std::vector<SortKey> &keys, const std::vector<std::string> &first,
+                const std::vector<std::string> &second);
+
+/**
+ * Sorts rows in memory (stable).
+ * @param rows Tokens of the rows to sort.
+ * @param keys Keys to sort by.
+ */
+void sortRows(std::vector<std::vector<std::string>> &rows, const std::vector<SortKey> &keys);
+
+/**
+ * Sorts the rows of a CSV file that may not fit in memory. Runs sized to the memory budget are
+ * sorted and spilled to temporary files, then merged with a loser tree.
+ * @param inputPath Path of the file to sort.
+ * @param outputPath Path of the file the sorted rows are written to (without header).
+ * @param keys Keys to sort by.
+ * @param skipHeader True if the first line of the input is a header, false otherwise.
+ * @param filter Filter applied to every row before sorting, nullptr to keep all rows.
+ * @param memoryBudget Maximum number of bytes held in memory by a run.
+ * @return Number of rows written to the output.
+ */
+size_t externalSort(const std::string &inputPath, const std::string &outputPath,
+                    const std::vector<SortKey> &keys, bool skipHeader,
+                    const RowFilter &filter = nullptr, size_t memoryBudget = defaultSortMemoryBudget);
+
+/**
+ * Merges already sorted run files into one sorted file. The runs are removed once merged.
+ * @param runPaths Paths of the sorted runs.
+ * @param outputPath Path of the merged file.
+ * @param keys Keys the runs are sorted by.
+ */
+void mergeRuns(const std::vector<std::string> &runPaths, const std::string &outputPath,
+               const std::vector<SortKey> &keys);
+
+/**
+ * Creates a unique path for a temporary file used by the operators.
+ * @param prefix Prefix of the file name.
+ * @return Path of the temporary file.
+ */
+std::string createTemporaryPath(const std::string &prefix);
+
+#endif //FQL_SORT_H
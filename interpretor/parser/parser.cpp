@@ -10,7 +10,10 @@
 #include "../validator/validator.h"
 #include "../builder/builder.h"
 #include "../scanner/scanner.h"
+#include "../cache/cache.h"
+#include "../expression/expression.h"
 #include "../../io/io.h"
+#include "../../utils/compression/compression.h"
 
 std::vector<std::string> builderLines;
 
@@ -26,7 +29,8 @@ std::unordered_set<std::string> usedArrays;
 std::vector<std::string> warnings;
 std::vector<std::string> errors;
 
-std::unordered_map<std::string, std::vector<std::string>> relationDataTypes;
+// Line of the begin of the transaction that is still open, empty if there is none.
+std::string openTransactionLine;
 
 void logError(const std::string& errorMessage, unsigned long lineNumber) {
     if (errorLines.find(lineNumber) == errorLines.end()) {
@@ -48,67 +52,141 @@ bool isValidSeparator(const std::vector<std::string> &tokens, const std::string
 }
 
 int parseCode(const std::vector<std::string>& codeLines, const std::string &filePath) {
-    using namespace std::chrono;
-    auto start = high_resolution_clock::now();
+    std::vector<std::string> buildLines;
+    if (!buildCode(codeLines, buildLines)) return false;
 
-    int index = 0;
+    buildExecutable(buildLines, filePath);
+    return true;
+}
 
-    while (index < codeLines.size() && index != -1) {
-        if (errorLines.find(index) != errorLines.end()) {
-            index++;
-            continue;
-        }
+namespace {
+    /**
+     * Clears the state of a previous build in the same process, it is not carried over.
+     */
+    void resetBuild() {
+        builderLines.clear();
+        errorLines.clear();
+        warningLines.clear();
+        createdRelations.clear();
+        usedRelations.clear();
+        createdArrays.clear();
+        usedArrays.clear();
+        warnings.clear();
+        errors.clear();
+        openTransactionLine.clear();
+    }
+
+    void showBuildTime(std::chrono::high_resolution_clock::time_point start) {
+        using namespace std::chrono;
+        auto end = high_resolution_clock::now();
+        auto duration = duration_cast<milliseconds>(end - start);
+        if (duration.count() > 1000) std::cout << "Build execution time: " << duration.count() / 1000 << "s" << std::endl;
+        else std::cout << "Build execution time: " << duration.count() << "ms" << std::endl;
+    }
+
+    /**
+     * Parses the code against the symbol table and moves its executable to the build lines when it has no errors.
+     * @param codeLines Lines of code to parse.
+     * @param buildLines Lines of the executable, set when the build succeeds.
+     * @return True if the build succeeded, false otherwise.
+     */
+    bool parseBuild(const std::vector<std::string> &codeLines, std::vector<std::string> &buildLines) {
+        int index = 0;
+        while (index < codeLines.size() && index != -1) {
+            if (errorLines.find(index) != errorLines.end()) {
+                index++;
+                continue;
+            }
 
-        std::vector<std::string> tokens = split(codeLines[index], ";");
+            std::vector<std::string> tokens = split(codeLines[index], ";");
 
-        if (tokens[0] == "Keyword" && tokens[1] == "schema") {
-            index = parseSchema(index + 1, codeLines);
-        }
-        else if (tokens[0] == "Keyword" && tokens[1] == "using") {
-            index = parseUsing(index + 1, codeLines);
-        }
-        else if (tokens[0] == "Keyword" && tokens[1] == "relation") {
-            index = parseRelation(index + 1, codeLines);
-        }
-        else if (tokens[0] == "Keyword" && tokens[1] == "let"){
-            index = parseLet(index + 1, codeLines);
-        }
-        else if (tokens[0] == "Keyword" && tokens[1] == "show"){
-            index = parseShow(index + 1, codeLines);
-        }
-        else if (tokens[0] == "Identifier" &&
-                 (split(codeLines[index + 1], ";")[0] == "Separator") &&
-                 (split(codeLines[index + 1], ";")[1] == ".")) {
-            index = parseMethod(index, codeLines);
+            if (tokens[0] == "Keyword" && tokens[1] == "schema") {
+                index = parseSchema(index + 1, codeLines);
+            }
+            else if (tokens[0] == "Keyword" && tokens[1] == "using") {
+                index = parseUsing(index + 1, codeLines);
+            }
+            else if (tokens[0] == "Keyword" && tokens[1] == "relation") {
+                index = parseRelation(index + 1, codeLines);
+            }
+            else if (tokens[0] == "Keyword" && tokens[1] == "let"){
+                index = parseLet(index + 1, codeLines);
+            }
+            else if (tokens[0] == "Keyword" && tokens[1] == "show"){
+                index = parseShow(index + 1, codeLines);
+            }
+            else if (tokens[0] == "Keyword" &&
+                     (tokens[1] == "begin" || tokens[1] == "commit" || tokens[1] == "rollback")){
+                index = parseTransaction(index, codeLines);
+            }
+            else if (tokens[0] == "Keyword" && tokens[1] == "explain"){
+                index = parseExplain(index, codeLines);
+            }
+            else if (tokens[0] == "Identifier" && static_cast<size_t>(index) + 1 < codeLines.size() &&
+                     (split(codeLines[index + 1], ";")[0] == "Separator") &&
+                     (split(codeLines[index + 1], ";")[1] == ".")) {
+                index = parseMethod(index, codeLines);
+            }
+            else if (tokens[0] == "Identifier" && static_cast<size_t>(index) + 1 < codeLines.size() &&
+                     (split(codeLines[index + 1], ";")[0] == "Separator") &&
+                     (split(codeLines[index + 1], ";")[1] == "->")) {
+                index = parseRelationAttributes(index, codeLines);
+            }
+            else {
+                logError("Syntax error at line " + tokens[2] +
+                         "! Could not find keyword '" + tokens[1] + "'!", index);
+                index++;
+            }
         }
-        else if (tokens[0] == "Identifier" &&
-                 (split(codeLines[index + 1], ";")[0] == "Separator") &&
-                 (split(codeLines[index + 1], ";")[1] == "->")) {
-            index = parseRelationAttributes(index, codeLines);
+        if (index != -1 && !openTransactionLine.empty()) {
+            logError("Syntax error at line " + openTransactionLine +
+                     "! Transaction is never committed or rolled back!", codeLines.size());
         }
-        else {
-            logError("Syntax error at line " + tokens[2] +
-                     "! Could not find keyword '" + tokens[1] + "'!", index);
-            index++;
+        getWarnings();
+
+        if (!errors.empty()) {
+            std::cout << "Build failed!" << std::endl;
+            showMessages();
+            return false;
         }
+
+        if (!warnings.empty()) showMessages();
+        std::cout << "Build successful!" << std::endl;
+        buildLines = std::move(builderLines);
+        builderLines.clear();
+        return true;
     }
-    getWarnings();
+}
 
-    if (!errors.empty()) {
-        std::cout << "Build failed!" << std::endl;
-        showMessages();
-        return false;
+bool buildCode(const std::vector<std::string> &codeLines, std::vector<std::string> &buildLines) {
+    auto start = std::chrono::high_resolution_clock::now();
+    resetBuild();
+
+    // A build of the same tokens is reused, as long as the files read by its addf calls did not change.
+    if (loadBuild(codeLines, buildLines, warnings)) {
+        if (!warnings.empty()) showMessages();
+        std::cout << "Build successful! (cached)" << std::endl;
+        showBuildTime(start);
+        return true;
     }
 
-    if (!warnings.empty()) showMessages();
-    std::cout << "Build successful!" << std::endl;
-    buildExecutable(builderLines, filePath);
+    buildSymbolTable(codeLines);
+    if (!parseBuild(codeLines, buildLines)) return false;
 
-    auto end = high_resolution_clock::now();
-    auto duration = duration_cast<milliseconds>(end - start);
-    if (duration.count() > 1000) std::cout << "Build execution time: " << duration.count() / 1000 << "s" << std::endl;
-    else std::cout << "Build execution time: " << duration.count() << "ms" << std::endl;
+    storeBuild(codeLines, buildLines, warnings);
+    showBuildTime(start);
+    return true;
+}
+
+bool buildStatement(const std::vector<std::string> &codeLines, std::vector<std::string> &buildLines) {
+    auto start = std::chrono::high_resolution_clock::now();
+    resetBuild();
+
+    // Only the declarations of the statement are added, the ones before it are already in the symbol table.
+    extendSymbolTable(codeLines);
+    if (!parseBuild(codeLines, buildLines)) return false;
 
+    showBuildTime(start);
     return true;
 }
 
@@ -120,7 +198,7 @@ int parseSchema(int index, const std::vector<std::string>& codeLines) {
 
     tokens = split(codeLines[index], ";");
     std::string schema = tokens[1];
-    if (tokens[0] != "Identifier" || schemaAlreadyExists(tokens[1], codeLines)) {
+    if (tokens[0] != "Identifier" || schemaAlreadyExists(tokens[1])) {
         logError("Syntax error at line " + tokens[2] +
                  "! Schema '" + tokens[1] + "' was already declared!", index);
         return -1;
@@ -131,7 +209,7 @@ int parseSchema(int index, const std::vector<std::string>& codeLines) {
 }
 
 int parseRelation(int index, const std::vector<std::string>& codeLines) {
-    std::unordered_map<std::string, std::string> relationSchema = getRelationSchema(codeLines);
+    const std::unordered_map<std::string, std::string> &relationSchema = getRelationSchema();
 
     std::vector<std::string> tokens = split(codeLines[index], ";");
     if (!isValidSeparator(tokens, ":", tokens[2])) return -1;
@@ -146,7 +224,6 @@ int parseRelation(int index, const std::vector<std::string>& codeLines) {
         return -1;
     }
     createdRelations.insert(tokens[1]);
-    buildDataTypes(codeLines);
 
     buildRelation(builderLines, relation, getKeyValue(relationSchema, relation));
     return index + 1;
@@ -157,7 +234,7 @@ int parseRelationAttributes(int index, const std::vector<std::string>& codeLines
     std::vector<std::string> attributes;
 
     auto tokens = split(codeLines[index], ";");
-    if (!isRelation(tokens[1], codeLines)) {
+    if (!isRelation(tokens[1])) {
         logError("Syntax error at line " + tokens[2] +
         "! Relation '" + tokens[1] + "' was not declared.", index);
         return index + 1;
@@ -199,7 +276,7 @@ int parseUsing(int index, const std::vector<std::string>& codeLines) {
     index++;
 
     tokens = split(codeLines[index], ";");
-    if (tokens[0] != "Identifier" || !schemaExists(tokens[1], codeLines)) {
+    if (tokens[0] != "Identifier" || !schemaExists(tokens[1])) {
         logError("Syntax error at line " + tokens[2] +
                  "! Schema '" + tokens[1] + "' was not declared!", index);
         return -1;
@@ -274,7 +351,7 @@ int parseLet(int index, const std::vector<std::string> &codeLines){
     auto tokens = split(codeLines[index], ";");
 
     std::string array = tokens[1];
-    if (tokens[0] != "Identifier" || arrayAlreadyExists(tokens[1], codeLines)){
+    if (tokens[0] != "Identifier" || arrayAlreadyExists(tokens[1])){
         logError("Syntax error at line " + tokens[2] +
         "! " + tokens[1] + " has already been declared!", index);
         return -1;
@@ -293,7 +370,7 @@ int parseLet(int index, const std::vector<std::string> &codeLines){
 int parseMethod(int index, const std::vector<std::string> &codeLines){
     auto tokens = split(codeLines[index], ";");
     std::string relation = tokens[1];
-    if (!isRelation(tokens[1], codeLines)){
+    if (!isRelation(tokens[1])){
         logError("Syntax error at line " + tokens[2] +
         "! " + tokens[1] + " is not a valid relation!", index);
         return -1;
@@ -313,6 +390,9 @@ int parseMethod(int index, const std::vector<std::string> &codeLines){
     else if (method == "addf") return parseAddf(index, relation, codeLines);
     else if (method == "update") return parseUpdate(index, relation, codeLines);
     else if (method == "delete") return parseDelete(index, relation, codeLines);
+    else if (method == "compact") return parseCompact(index, relation, codeLines);
+    else if (method == "analyze") return parseAnalyze(index, relation, codeLines);
+    else if (method == "compress") return parseCompress(index, relation, codeLines);
     else if (method == "fetch") return parseFetch(index, relation, codeLines);
 
     return -1;
@@ -337,6 +417,18 @@ void validConstantDataTypes(int index, const std::string &argumentType, const st
             "! Expected type 'int' for argument.", index);
         }
     }
+    else if (argumentType == "date") {
+        if (!isDate(tokens[1])) {
+            logError("Syntax error at line " + tokens[2] +
+                     "! Expected type 'date' for argument.", index);
+        }
+    }
+    else if (argumentType == "datetime") {
+        if (!isDateTime(tokens[1])) {
+            logError("Syntax error at line " + tokens[2] +
+                     "! Expected type 'datetime' for argument.", index);
+        }
+    }
     else if (argumentType.find("char(") == 0) {
         unsigned long startIndex = argumentType.find('(');
         unsigned long endIndex = argumentType.find(')');
@@ -449,6 +541,7 @@ int parseAddf(int index, const std::string &relation, const std::vector<std::str
 
     std::vector<std::string> lines = readLines(file);
     std::vector<std::string> tokenizedLines;
+    addBuildDependency(file);
 
     for (auto &line : lines) {
         if (line.empty()) continue;
@@ -464,22 +557,17 @@ int parseAddf(int index, const std::string &relation, const std::vector<std::str
     int rowIndex = 0;
     while (rowIndex < tokenizedLines.size()) rowIndex = parseAdd(rowIndex, relation, tokenizedLines);
 
+    // The statistics of the relation are collected once the file is loaded.
+    buildRelationAnalyze(builderLines, relation);
     return index;
 }
 
-void buildDataTypes(const std::vector<std::string> &codeLines){
-    for (const auto &relation : createdRelations){
-        if (!relationDataTypes[relation].empty()) continue;
-        relationDataTypes[relation] = getRelationDataTypes(relation, codeLines);
-    }
-}
-
 int parseAdd(int index, const std::string &relation, const std::vector<std::string> &codeLines) {
     auto tokens = split(codeLines[index], ";");
     if (!isValidSeparator(tokens, "(", tokens[2])) return -1;
     index++;
 
-    std::vector<std::string> dataTypes = relationDataTypes[relation];
+    const std::vector<std::string> &dataTypes = getRelationDataTypes(relation);
     std::vector<std::string> arguments;
     if (split(codeLines[index], ";")[0] == "Identifier" || split(codeLines[index], ";")[0] == "Constant")
         arguments.push_back(split(codeLines[index], ";")[1]);
@@ -563,7 +651,6 @@ int parseUpdate(int index, const std::string &relation, const std::vector<std::s
         if (tokens[1] == "}") break;
 
         expressionTokens.push_back(codeLines[index]);
-        whereExpression += tokens[1];
         index++;
     }
     index++;
@@ -572,24 +659,10 @@ int parseUpdate(int index, const std::string &relation, const std::vector<std::s
         logWarning("Updating " + relation + " is redundant because of empty where clause!");
     }
 
-    std::vector<std::string> attributes = getRelationAttributes(relation, codeLines);
-    std::vector<std::string> types = getRelationDataTypes(relation, codeLines);
-    std::unordered_map<std::string, std::string> dataTypes;
-    if (attributes.size() != types.size()) {
-        logError("Syntax error at line " + tokens[2] +
-        "! Mismatch between attributes and data types for relation " + relation, index);
-        return -1;
-    }
-
-    for (size_t i = 0; i < attributes.size(); i++) {
-        dataTypes[attributes[i]] = types[i];
-    }
-
-    if (!isExpressionValid(expressionTokens, dataTypes) && !expressionTokens.empty()) {
-        logError("Syntax error at line " + tokens[2] +
-        ": Invalid expression inside method call!", index);
-        return -1;
-    }
+    std::unordered_map<std::string, std::string> dataTypes = buildDataTypes(getRelationAttributes(relation),
+                                                                            getRelationDataTypes(relation));
+    if (!expressionTokens.empty() &&
+        !parseClause(index, tokens[2], expressionTokens, dataTypes, false, whereExpression)) return -1;
 
     tokens = split(codeLines[index], ";");
     if (tokens[0] != "Keyword" || tokens[1] != "set"){
@@ -613,7 +686,6 @@ int parseUpdate(int index, const std::string &relation, const std::vector<std::s
         if (tokens[1] == "}") break;
 
         setTokens.push_back(codeLines[index]);
-        setExpression += tokens[1];
         index++;
     }
     index++;
@@ -622,13 +694,73 @@ int parseUpdate(int index, const std::string &relation, const std::vector<std::s
         logWarning("Updating " + relation + " is redundant because of empty set clause!");
     }
 
-    if (!isStatementValid(setTokens)) {
-        logError("Syntax error at line " + tokens[2] +
-                 ": Invalid statement inside method call!", index);
+    if (!setTokens.empty() && !parseClause(index, tokens[2], setTokens, dataTypes, true, setExpression)) return -1;
+
+    buildRelationUpdate(builderLines, relation, whereExpression, setExpression);
+    return index;
+}
+
+int parseCompact(int index, const std::string &relation, const std::vector<std::string> &codeLines){
+    if (static_cast<size_t>(index) + 1 >= codeLines.size()) {
+        logError("Syntax error: Unexpected end of input!", index);
         return -1;
     }
 
-    buildRelationUpdate(builderLines, relation, whereExpression, setExpression);
+    auto tokens = split(codeLines[index], ";");
+    if (!isValidSeparator(tokens, "(", tokens[2])) return -1;
+    index++;
+
+    tokens = split(codeLines[index], ";");
+    if (!isValidSeparator(tokens, ")", tokens[2])) return -1;
+    index++;
+
+    buildRelationCompact(builderLines, relation);
+    return index;
+}
+
+int parseAnalyze(int index, const std::string &relation, const std::vector<std::string> &codeLines){
+    if (static_cast<size_t>(index) + 1 >= codeLines.size()) {
+        logError("Syntax error: Unexpected end of input!", index);
+        return -1;
+    }
+
+    auto tokens = split(codeLines[index], ";");
+    if (!isValidSeparator(tokens, "(", tokens[2])) return -1;
+    index++;
+
+    tokens = split(codeLines[index], ";");
+    if (!isValidSeparator(tokens, ")", tokens[2])) return -1;
+    index++;
+
+    buildRelationAnalyze(builderLines, relation);
+    return index;
+}
+
+int parseCompress(int index, const std::string &relation, const std::vector<std::string> &codeLines){
+    if (static_cast<size_t>(index) + 2 >= codeLines.size()) {
+        logError("Syntax error: Unexpected end of input!", index);
+        return -1;
+    }
+
+    auto tokens = split(codeLines[index], ";");
+    if (!isValidSeparator(tokens, "(", tokens[2])) return -1;
+    index++;
+
+    tokens = split(codeLines[index], ";");
+    if (tokens[0] != "Constant" || !isNumber(tokens[1]) || tokens[1].size() > 1
+        || std::stoi(tokens[1]) > maxCompressionLevel) {
+        logError("Syntax error at line " + tokens[2] + "! Compression level must be an integer between 0 and "
+                 + std::to_string(maxCompressionLevel) + ".", index);
+        return -1;
+    }
+    std::string level = tokens[1];
+    index++;
+
+    tokens = split(codeLines[index], ";");
+    if (!isValidSeparator(tokens, ")", tokens[2])) return -1;
+    index++;
+
+    buildRelationCompress(builderLines, relation, level);
     return index;
 }
 
@@ -676,29 +808,14 @@ int parseDelete(int index, const std::string &relation, const std::vector<std::s
         if (tokens[1] == "}") break;
 
         expressionTokens.push_back(codeLines[index]);
-        whereExpression += tokens[1];
         index++;
     }
     index++;
 
-    std::vector<std::string> attributes = getRelationAttributes(relation, codeLines);
-    std::vector<std::string> types = getRelationDataTypes(relation, codeLines);
-    std::unordered_map<std::string, std::string> dataTypes;
-    if (attributes.size() != types.size()) {
-        logError("Syntax error at line " + tokens[2] +
-                 "! Mismatch between attributes and data types for relation " + relation, index);
-        return -1;
-    }
-
-    for (size_t i = 0; i < attributes.size(); i++) {
-        dataTypes[attributes[i]] = types[i];
-    }
-
-    if (!isExpressionValid(expressionTokens, dataTypes)) {
-        logError("Syntax error at line " + tokens[2] +
-                 ": Invalid expression inside method call!", index);
-        return -1;
-    }
+    std::unordered_map<std::string, std::string> dataTypes = buildDataTypes(getRelationAttributes(relation),
+                                                                            getRelationDataTypes(relation));
+    if (!expressionTokens.empty() &&
+        !parseClause(index, tokens[2], expressionTokens, dataTypes, false, whereExpression)) return -1;
 
     buildRelationDelete(builderLines, relation, whereExpression);
     return index;
@@ -715,7 +832,7 @@ int parseFetch(int index, const std::string& relation, const std::vector<std::st
         return -1;
     }
 
-    std::vector<std::string> attributes = getRelationAttributes(relation, codeLines);
+    std::vector<std::string> attributes = getRelationAttributes(relation);
     std::vector<std::string> builderTokens;
     bool argumentParsed = false;
 
@@ -726,6 +843,15 @@ int parseFetch(int index, const std::string& relation, const std::vector<std::st
         }
 
         tokens = split(codeLines[index], ";");
+        if (tokens[0] == "Identifier" && isAggregateFunction(tokens[1])
+            && static_cast<size_t>(index) + 1 < codeLines.size() && split(codeLines[index + 1], ";")[1] == "(") {
+            index = parseAggregate(index, relation, codeLines, builderTokens);
+            if (index == -1) return -1;
+
+            argumentParsed = true;
+            continue;
+        }
+
         if (tokens[0] == "Identifier" && !isAttribute(tokens[1], attributes)) {
             logError("Syntax error at line " + tokens[2] + "! " + tokens[1] +
                      " is not a valid attribute in " + relation + "!", index);
@@ -747,6 +873,7 @@ int parseFetch(int index, const std::string& relation, const std::vector<std::st
     index++;
     buildFetch(builderLines, relation, builderTokens);
 
+    std::vector<std::string> groupKeys;
     while (index < codeLines.size()) {
         tokens = split(codeLines[index], ";");
 
@@ -760,9 +887,130 @@ int parseFetch(int index, const std::string& relation, const std::vector<std::st
             index = parseWhere(index, relation, codeLines);
             if (index == -1) return -1;
         }
+        else if (tokens[0] == "Keyword" && tokens[1] == "order by") {
+            index++;
+            index = parseOrderBy(index, relation, codeLines);
+            if (index == -1) return -1;
+        }
+        else if (tokens[0] == "Keyword" && tokens[1] == "group by") {
+            index++;
+            index = parseGroupBy(index, relation, codeLines, groupKeys);
+            if (index == -1) return -1;
+        }
         else break;
     }
 
+    bool hasAggregate = false;
+    for (const auto &builderToken : builderTokens) {
+        if (builderToken.find('(') != std::string::npos) hasAggregate = true;
+    }
+
+    if (hasAggregate || !groupKeys.empty()) {
+        for (const auto &builderToken : builderTokens) {
+            if (builderToken.find('(') != std::string::npos || isAttribute(builderToken, groupKeys)) continue;
+
+            logError("Syntax error at line " + tokens[2] + "! " + builderToken +
+                     " must be aggregated or appear in the group by clause!", index);
+            return -1;
+        }
+    }
+
+    return index;
+}
+
+int parseAggregate(int index, const std::string &relation, const std::vector<std::string> &codeLines,
+                   std::vector<std::string> &builderTokens) {
+    auto tokens = split(codeLines[index], ";");
+    std::string function = tokens[1];
+    index += 2;
+
+    if (static_cast<size_t>(index) >= codeLines.size()) {
+        logError("Syntax error: Unexpected end of input!", index);
+        return -1;
+    }
+
+    tokens = split(codeLines[index], ";");
+    std::string attribute;
+    if (tokens[0] == "Identifier") {
+        std::vector<std::string> attributes = getRelationAttributes(relation);
+        if (!isAttribute(tokens[1], attributes)) {
+            logError("Syntax error at line " + tokens[2] + "! " + tokens[1] +
+                     " is not a valid attribute in " + relation + "!", index);
+            return -1;
+        }
+
+        attribute = tokens[1];
+        index++;
+        tokens = split(codeLines[index], ";");
+    }
+
+    if (!isValidSeparator(tokens, ")", tokens[2])) return -1;
+
+    if (attribute.empty() && function != "count") {
+        logError("Syntax error at line " + tokens[2] + "! Aggregate function '" + function +
+                 "' expects an attribute!", index);
+        return -1;
+    }
+
+    if (function == "sum" || function == "avg") {
+        std::unordered_map<std::string, std::string> dataTypes =
+                buildDataTypes(getRelationAttributes(relation), getRelationDataTypes(relation));
+
+        if (getKeyValue(dataTypes, attribute) != "int") {
+            logError("Syntax error at line " + tokens[2] + "! Aggregate function '" + function +
+                     "' expects an attribute of type 'int'!", index);
+            return -1;
+        }
+    }
+
+    builderTokens.push_back(function + "(" + attribute + ")");
+    return index + 1;
+}
+
+int parseGroupBy(int index, const std::string &relation, const std::vector<std::string> &codeLines,
+                 std::vector<std::string> &groupKeys) {
+    auto tokens = split(codeLines[index], ";");
+    if (tokens[0] != "Separator" || tokens[1] != "{") {
+        logError("Syntax error at line " + tokens[2] +
+                 "! Expected '{' to start group by clause.", index);
+        return -1;
+    }
+    index++;
+
+    std::vector<std::string> attributes = getRelationAttributes(relation);
+    std::vector<std::string> newGroupKeys;
+    while (static_cast<size_t>(index) < codeLines.size()) {
+        tokens = split(codeLines[index], ";");
+        if (tokens[1] == "}") break;
+
+        if (tokens[0] == "Identifier") {
+            if (!isAttribute(tokens[1], attributes)) {
+                logError("Syntax error at line " + tokens[2] + "! " + tokens[1] +
+                         " is not a valid attribute in " + relation + "!", index);
+                return -1;
+            }
+            newGroupKeys.push_back(tokens[1]);
+        }
+        else if (tokens[0] != "Separator" || tokens[1] != ",") {
+            logError("Syntax error at line " + tokens[2] + "! Invalid token in group by clause.", index);
+            return -1;
+        }
+        index++;
+    }
+
+    if (static_cast<size_t>(index) >= codeLines.size()) {
+        logError("Syntax error: Missing closing '}' for group by clause!", index);
+        return -1;
+    }
+    index++;
+
+    if (newGroupKeys.empty()) {
+        logError("Syntax error at line " + tokens[2] + "! Group by clause expects at least one attribute!", index);
+        return -1;
+    }
+
+    groupKeys.insert(groupKeys.end(), newGroupKeys.begin(), newGroupKeys.end());
+    buildGroupBy(builderLines, newGroupKeys);
     return index;
 }
 
@@ -774,7 +1022,7 @@ int parseConcatenation(int index, const std::vector<std::string>& codeLines) {
 
         if (tokens[0] == "Constant") index++;
         else if (tokens[0] == "Identifier") {
-            if (isRelation(tokens[1], codeLines)) {
+            if (isRelation(tokens[1])) {
                 std::string relation = tokens[1];
                 index++;
 
@@ -823,6 +1071,21 @@ std::unordered_map<std::string, std::string> buildDataTypes(const std::vector<st
     return dataTypes;
 }
 
+bool parseClause(int index, const std::string &line, const std::vector<std::string> &clauseTokens,
+                 const std::unordered_map<std::string, std::string> &dataTypes, bool isSetClause,
+                 std::string &serializedClause) {
+    try {
+        Expression expression = isSetClause ? parseAssignments(clauseTokens, dataTypes)
+                                            : parseExpression(clauseTokens, dataTypes);
+        serializedClause = serializeExpression(expression);
+        return true;
+    }
+    catch (const std::exception &exception) {
+        logError("Syntax error at line " + line + "! " + exception.what(), index);
+        return false;
+    }
+}
+
 int parseWhere(int index, const std::string& relation, const std::vector<std::string>& codeLines) {
     auto tokens = split(codeLines[index], ";");
     if (tokens[0] != "Separator" || tokens[1] != "{") {
@@ -839,7 +1102,6 @@ int parseWhere(int index, const std::string& relation, const std::vector<std::st
         if (tokens[1] == "}") break;
 
         expressionTokens.push_back(codeLines[index]);
-        whereExpression += tokens[1];
         index++;
     }
 
@@ -849,33 +1111,123 @@ int parseWhere(int index, const std::string& relation, const std::vector<std::st
     }
     index++;
 
-    std::vector<std::string> attributes = getRelationAttributes(relation, codeLines);
-    std::unordered_map<std::string, std::string> dataTypes = buildDataTypes(attributes, getRelationDataTypes(relation, codeLines));
+    std::unordered_map<std::string, std::string> dataTypes = buildDataTypes(getRelationAttributes(relation),
+                                                                            getRelationDataTypes(relation));
+    if (!expressionTokens.empty() &&
+        !parseClause(index, tokens[2], expressionTokens, dataTypes, false, whereExpression)) return -1;
+
+    buildWhere(builderLines, whereExpression);
+    return index;
+}
 
-    if (!isExpressionValid(expressionTokens, dataTypes)) {
-        logError("Syntax error at line " + tokens[2] + "! Invalid expression in where clause.", index);
+int parseOrderBy(int index, const std::string &relation, const std::vector<std::string> &codeLines) {
+    auto tokens = split(codeLines[index], ";");
+    if (tokens[0] != "Separator" || tokens[1] != "{") {
+        logError("Syntax error at line " + tokens[2] +
+                 "! Expected '{' to start order by clause.", index);
         return -1;
     }
+    index++;
 
-    buildWhere(builderLines, whereExpression);
+    std::vector<std::string> attributes = getRelationAttributes(relation);
+    std::vector<std::string> orderKeys;
+    while (static_cast<size_t>(index) < codeLines.size()) {
+        tokens = split(codeLines[index], ";");
+        if (tokens[1] == "}") break;
+
+        if (tokens[0] == "Identifier" && (tokens[1] == "asc" || tokens[1] == "desc")) {
+            if (orderKeys.empty() || split(orderKeys.back(), ",").size() > 1) {
+                logError("Syntax error at line " + tokens[2] +
+                         "! Expected an attribute before '" + tokens[1] + "'!", index);
+                return -1;
+            }
+            orderKeys.back() += "," + tokens[1];
+        }
+        else if (tokens[0] == "Identifier") {
+            if (!isAttribute(tokens[1], attributes)) {
+                logError("Syntax error at line " + tokens[2] + "! " + tokens[1] +
+                         " is not a valid attribute in " + relation + "!", index);
+                return -1;
+            }
+            orderKeys.push_back(tokens[1]);
+        }
+        else if (tokens[0] != "Separator" || tokens[1] != ",") {
+            logError("Syntax error at line " + tokens[2] + "! Invalid token in order by clause.", index);
+            return -1;
+        }
+        index++;
+    }
+
+    if (static_cast<size_t>(index) >= codeLines.size()) {
+        logError("Syntax error: Missing closing '}' for order by clause!", index);
+        return -1;
+    }
+    index++;
+
+    if (orderKeys.empty()) {
+        logError("Syntax error at line " + tokens[2] + "! Order by clause expects at least one attribute!", index);
+        return -1;
+    }
+
+    for (auto &orderKey : orderKeys) {
+        if (split(orderKey, ",").size() == 1) orderKey += ",asc";
+    }
+
+    buildOrderBy(builderLines, orderKeys);
     return index;
 }
 
+int parseTransaction(int index, const std::vector<std::string> &codeLines){
+    auto tokens = split(codeLines[index], ";");
+
+    if (tokens[1] == "begin") {
+        if (index != -1 && !openTransactionLine.empty()) {
+            logError("Syntax error at line " + tokens[2] + "! Transaction started at line " +
+                     openTransactionLine + " is still open!", index);
+            return -1;
+        }
+        openTransactionLine = tokens[2];
+    }
+    else {
+        if (openTransactionLine.empty()) {
+            logError("Syntax error at line " + tokens[2] + "! '" + tokens[1] +
+                     "' without a matching 'begin'!", index);
+            return -1;
+        }
+        openTransactionLine.clear();
+    }
+
+    buildTransaction(builderLines, tokens[1]);
+    return index + 1;
+}
+
+int parseExplain(int index, const std::vector<std::string> &codeLines){
+    auto tokens = split(codeLines[index], ";");
+
+    if (static_cast<size_t>(index) + 1 >= codeLines.size()) {
+        logError("Syntax error at line " + tokens[2] + "! Expected a statement after 'explain'!", index);
+        return -1;
+    }
+
+    buildExplain(builderLines, tokens[2]);
+    return index + 1;
+}
+
 int parseShow(int index, const std::vector<std::string> &codeLines){
     auto tokens = split(codeLines[index], ";");
     if (!isValidSeparator(tokens, ":", tokens[2])) return -1;
     index++;
 
     tokens = split(codeLines[index], ";");
-    if (isRelation(tokens[1], codeLines)){
+    if (isRelation(tokens[1])){
         buildShow(builderLines, tokens[1]);
         return index + 1;
     }
-    else if (isSchema(tokens[1], codeLines)){
+    else if (isSchema(tokens[1])){
         buildShowSchema(builderLines, tokens[1]);
         return index + 1;
     }
-    else if (isArray(tokens[1], codeLines)){
+    else if (isArray(tokens[1])){
         buildShowArray(builderLines, tokens[1]);
         return index + 1;
     }
@@ -13,6 +13,23 @@
  */
 int parseCode(const std::vector<std::string> &codeLines, const std::string &filePath);
 
+/**
+ * Parses the code to check for syntax errors and builds the executable in memory.
+ * @param codeLines Lines of code to parse.
+ * @param buildLines Lines of the executable, set when the build succeeds.
+ * @return True if the build succeeded, false otherwise.
+ */
+bool buildCode(const std::vector<std::string> &codeLines, std::vector<std::string> &buildLines);
+
+/**
+ * Parses a statement of a session and builds its executable in memory. The statement is validated
+ * against the symbols declared by the statements built before it, and its own declarations are added to them.
+ * @param codeLines Lines of code of the statement.
+ * @param buildLines Lines of the executable, set when the build succeeds.
+ * @return True if the build succeeded, false otherwise.
+ */
+bool buildStatement(const std::vector<std::string> &codeLines, std::vector<std::string> &buildLines);
+
 /**
  * Parses the scanned lines when finding a schema to check for syntax errors.
  * @param index Index of the line.
@@ -97,6 +114,28 @@ int parseAddf(int index, const std::string &relation, const std::vector<std::str
  */
 int parseFetch(int index, const std::string &relation, const std::vector<std::string> &codeLines);
 
+/**
+ * Parses an aggregate function passed to the fetch method.
+ * @param index Index of the line.
+ * @param relation Relation to get the attributes from.
+ * @param codeLines Lines of code to parse.
+ * @param builderTokens Fetched items, the aggregate is added as "function(attribute)".
+ * @return Index of the next parsed line.
+ */
+int parseAggregate(int index, const std::string &relation, const std::vector<std::string> &codeLines,
+                   std::vector<std::string> &builderTokens);
+
+/**
+ * Parses the group by keyword for fetch expressions.
+ * @param index Index of the line.
+ * @param relation Relation to get the attributes from.
+ * @param codeLines Lines of code to parse.
+ * @param groupKeys Attributes the fetch is grouped by.
+ * @return Index of the next parsed line.
+ */
+int parseGroupBy(int index, const std::string &relation, const std::vector<std::string> &codeLines,
+                 std::vector<std::string> &groupKeys);
+
 /**
  * Parses the concatenation between fetch resulting arrays.
  * @param index Index of the line.
@@ -106,6 +145,20 @@ int parseFetch(int index, const std::string &relation, const std::vector<std::st
  */
 int parseConcatenation(int index, const std::vector<std::string> &codeLines);
 
+/**
+ * Parses the tokens of a where or set clause into the serialized tree written in the build file.
+ * @param index Index of the parsed line.
+ * @param line Number of the line in the code, for the error message.
+ * @param clauseTokens Tokens of the clause, without its braces.
+ * @param dataTypes Data type of every attribute of the relation.
+ * @param isSetClause True for a set clause, false for a where clause.
+ * @param serializedClause Serialized tree of the clause, set when it is valid.
+ * @return True if the clause is valid, false otherwise.
+ */
+bool parseClause(int index, const std::string &line, const std::vector<std::string> &clauseTokens,
+                 const std::unordered_map<std::string, std::string> &dataTypes, bool isSetClause,
+                 std::string &serializedClause);
+
 /**
  * Maps attributes to their corresponding data types.
  * @param attributes Vector of attribute names.
@@ -124,6 +177,15 @@ std::unordered_map<std::string, std::string> buildDataTypes(const std::vector<st
  */
 int parseWhere(int index, const std::string &relation, const std::vector<std::string> &codeLines);
 
+/**
+ * Parses the order by keyword for fetch expressions.
+ * @param index Index of the line.
+ * @param relation Relation to get the attributes from.
+ * @param codeLines Lines of code to parse.
+ * @return Index of the next parsed line.
+ */
+int parseOrderBy(int index, const std::string &relation, const std::vector<std::string> &codeLines);
+
 /**
  * Parses the update method for relations.
  * @param index Index of the line.
@@ -133,6 +195,33 @@ int parseWhere(int index, const std::string &relation, const std::vector<std::st
  */
 int parseUpdate(int index, const std::string &relation, const std::vector<std::string> &codeLines);
 
+/**
+ * Parses the compact method for relations.
+ * @param index Index of the line.
+ * @param relation Relation to compact.
+ * @param codeLines Lines of code to parse.
+ * @return Index of the next parsed line.
+ */
+int parseCompact(int index, const std::string &relation, const std::vector<std::string> &codeLines);
+
+/**
+ * Parses the analyze method for relations.
+ * @param index Index of the line.
+ * @param relation Relation to analyze.
+ * @param codeLines Lines of code to parse.
+ * @return Index of the next parsed line.
+ */
+int parseAnalyze(int index, const std::string &relation, const std::vector<std::string> &codeLines);
+
+/**
+ * Parses the compress method for relations.
+ * @param index Index of the line.
+ * @param relation Relation to compress.
+ * @param codeLines Lines of code to parse.
+ * @return Index of the next parsed line.
+ */
+int parseCompress(int index, const std::string &relation, const std::vector<std::string> &codeLines);
+
 /**
  * Parses the delete method for relations.
  * @param index Index of the line.
@@ -151,6 +240,22 @@ int parseDelete(int index, const std::string &relation, const std::vector<std::s
  */
 int parseArgument(int index, const std::string &argumentType, const std::vector<std::string> &codeLines);
 
+/**
+ * Parses a begin, commit or rollback statement, checking that transactions are not nested.
+ * @param index Index of the line.
+ * @param codeLines Lines of code to parse.
+ * @return index of the next parsed line.
+ */
+int parseTransaction(int index, const std::vector<std::string> &codeLines);
+
+/**
+ * Parses an explain keyword, which shows the plan of the statement that follows it.
+ * @param index Index of the line.
+ * @param codeLines Lines of code to parse.
+ * @return index of the next parsed line.
+ */
+int parseExplain(int index, const std::vector<std::string> &codeLines);
+
 /**
  * Parses the show function.
  * @param index Index of the line.
@@ -184,12 +289,6 @@ void validIdentifierDataTypes(int index, const std::string &argumentType, const
  */
 bool isValidSeparator(const std::vector<std::string> &tokens, const std::string &op, const std::string &index);
 
-/**
- * Builds data types for the given code lines.
- * @param codeLines Lines of code to build data types for.
- */
-void buildDataTypes(const std::vector<std::string> &codeLines);
-
 /**
  * Gets all the warnings regarding the scanned lines.
  */
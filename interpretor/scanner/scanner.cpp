@@ -6,17 +6,16 @@
 
 #include "scanner.h"
 #include "../../io/io.h"
+#include "../cache/cache.h"
 #include "../../utils/algorithms/algorithms.h"
 
 std::vector<std::string> originalCodeLines;
 
-std::vector<std::string> readCode(const std::string& filePath) {
+std::vector<std::string> removeComments(std::vector<std::string> codeLines) {
     std::regex oneLineComment(R"(\s*--\s*.*?\s*--)");
     std::regex startMultiLineComment(R"(\s*-/\s*.*?$)");
     std::regex endMultiLineComment(R"(\s*^.*?\s*-?/)");
 
-    std::vector<std::string> codeLines = readLines(filePath);
-    originalCodeLines = codeLines;
     bool inMultiLineComment = false;
 
     auto it = codeLines.begin();
@@ -37,6 +36,11 @@ std::vector<std::string> readCode(const std::string& filePath) {
     return codeLines;
 }
 
+std::vector<std::string> readCode(const std::string& filePath) {
+    originalCodeLines = readLines(filePath);
+    return removeComments(originalCodeLines);
+}
+
 std::string getLine(int lineNumber) {
     if (lineNumber > 0 && lineNumber <= originalCodeLines.size()) {
         return originalCodeLines[lineNumber - 1];
@@ -45,14 +49,17 @@ std::string getLine(int lineNumber) {
 }
 
 std::vector<std::string> scanLine(const std::string& line) {
-    std::regex keywordsRegex(R"(^\s*(include|schema|relation|let|varchar|int|uuid|UUID|date|boolean|PK|FK|nullable|char|datetime|
-        |using|nullable|not null|NULLABLE|NOT NULL|where|set|default|set|show))");
-    std::regex methodRegex(R"(^\s*(addf|add|delete|fetch|update))");
-    std::regex separatorRegex(R"(^\s*(and|or|>|<|>=|<=|!=|==|->|:|=|\+|-|\(|\)|\{|\}|\.|\,))");
-    std::regex constantRegex(R"(^\s*(-?\d+(\.\d+)?|\"([^\"\\]|\\.)*\"|[Tt][Rr][Uu][Ee]|[Ff][Aa][Ll][Ss][Ee]))");
-    std::regex identifierRegex(R"(^\s*[a-zA-Z0-9_\-/\\]+)");
-    std::regex endOfFileRegex(R"(^$)");
-    std::regex errorRegex(R"(\S+)");
+    // The regexes are compiled once, scanning is done for every line of every scanned file.
+    static const std::regex keywordsRegex(R"(^\s*(include|schema|relation|let|varchar|int|uuid|UUID|datetime|date|boolean|PK|FK|nullable|char|using|not null|NULLABLE|NOT NULL|where|set|default|show|order by|group by|begin|commit|rollback|explain)\b)");
+    static const std::regex methodRegex(R"(^\s*(addf|add|delete|fetch|update|compact|analyze|compress)\b)");
+    // Operators are matched longest first, so '>=' is not scanned as '>' followed by '='.
+    static const std::regex separatorRegex(R"(^\s*(and\b|or\b|>=|<=|!=|==|->|>|<|:|=|\+|-|\(|\)|\{|\}|\.|\,))");
+    // Dates and datetimes are single constants, they are matched before their digits can be taken as numbers.
+    static const std::regex constantRegex(R"(^\s*(\d{4}-\d{2}-\d{2}( \d{2}:\d{2}:\d{2})?(?![\w\-])|-?\d+(\.\d+)?|\"([^\"\\]|\\.)*\"|([Tt][Rr][Uu][Ee]|[Ff][Aa][Ll][Ss][Ee])\b))");
+    static const std::regex identifierRegex(R"(^\s*[a-zA-Z0-9_\-/\\]+)");
+    static const std::regex endOfFileRegex(R"(^$)");
+    static const std::regex errorRegex(R"(\S+)");
+    static const std::regex leadingSpaceRegex(R"(^\s+)");
 
     std::string remainingString = line;
     std::vector<std::string> tokens;
@@ -94,28 +101,23 @@ std::vector<std::string> scanLine(const std::string& line) {
             remainingString = remainingString.substr(match.length());
         }
 
-        remainingString = std::regex_replace(remainingString, std::regex(R"(^\s+)"), "");
+        remainingString = std::regex_replace(remainingString, leadingSpaceRegex, "");
     }
 
     return tokens;
 }
 
-std::vector<std::string> scanCode(const std::string &filePath, std::unordered_set<std::string> &scannedFiles) {
-    if (scannedFiles.find(filePath) != scannedFiles.end()) {
-        return {};
-    }
+std::vector<std::string> scanFile(const std::string &filePath) {
+    originalCodeLines = readLines(filePath);
 
-    if (!validFile(filePath)) {
-        std::cerr << "Linker Error: Invalid file path " << filePath << std::endl;
-        return {};
-    }
-    scannedFiles.insert(filePath);
+    std::string content;
+    for (const auto &line : originalCodeLines) content += line + "\n";
 
-    std::vector<std::string> codeLines = readCode(filePath);
-    std::vector<std::string> scannedCode;
-    int lineNumber = 1;
+    std::vector<std::string> fileTokens;
+    if (loadScannedFile(content, fileTokens)) return fileTokens;
 
-    for (const auto &line : codeLines) {
+    int lineNumber = 1;
+    for (const auto &line : removeComments(originalCodeLines)) {
         std::vector<std::string> tokens = scanLine(line);
 
         bool isIncludeLine = false;
@@ -124,28 +126,62 @@ std::vector<std::string> scanCode(const std::string &filePath, std::unordered_se
                 isIncludeLine = true;
                 size_t pos = line.find(":");
                 if (pos != std::string::npos) {
-                    std::string includedFile = strip(line.substr(pos + 1), ' ');
-
-                    if (validFile(includedFile)) {
-                        std::vector<std::string> includedTokens = scanCode(includedFile, scannedFiles);
-                        scannedCode.insert(scannedCode.end(), includedTokens.begin(), includedTokens.end());
-                    }else {
-                        std::cerr << "Linker error: Invalid include file path " << includedFile << " in "
-                                  << filePath << " at line " << lineNumber << std::endl;
-                    }
+                    fileTokens.push_back("Include;" + strip(line.substr(pos + 1), ' ') + ";" + std::to_string(lineNumber));
                 }
-                else std::cerr << "Linker error: Invalid include statement in " << filePath << " at line " << lineNumber << std::endl;
+                else fileTokens.push_back("Include;" + std::to_string(lineNumber));
                 break;
             }
         }
 
         if (!isIncludeLine) {
             for (const auto &token : tokens) {
-                scannedCode.push_back(token + ";" + std::to_string(lineNumber));
+                fileTokens.push_back(token + ";" + std::to_string(lineNumber));
             }
         }
         lineNumber++;
     }
 
+    storeScannedFile(content, fileTokens);
+    return fileTokens;
+}
+
+std::vector<std::string> scanCode(const std::string &filePath, std::unordered_set<std::string> &scannedFiles) {
+    if (scannedFiles.find(filePath) != scannedFiles.end()) {
+        return {};
+    }
+
+    if (!validFile(filePath)) {
+        std::cerr << "Linker Error: Invalid file path " << filePath << std::endl;
+        return {};
+    }
+    scannedFiles.insert(filePath);
+
+    std::vector<std::string> scannedCode;
+    for (const auto &token : scanFile(filePath)) {
+        if (token.rfind("Include;", 0) != 0) {
+            scannedCode.push_back(token);
+            continue;
+        }
+
+        // Included files are scanned on their own, so a change in one of them does not rescan the others.
+        size_t pathStart = std::string("Include;").size();
+        size_t lineStart = token.rfind(';');
+        std::string lineNumber = token.substr(lineStart + 1);
+        if (lineStart < pathStart) {
+            std::cerr << "Linker error: Invalid include statement in " << filePath << " at line " << lineNumber << std::endl;
+            continue;
+        }
+
+        std::string includedFile = token.substr(pathStart, lineStart - pathStart);
+        if (validFile(includedFile)) {
+            std::vector<std::string> includedTokens = scanCode(includedFile, scannedFiles);
+            scannedCode.insert(scannedCode.end(), includedTokens.begin(), includedTokens.end());
+        }
+        else {
+            std::cerr << "Linker error: Invalid include file path " << includedFile << " in "
+                      << filePath << " at line " << lineNumber << std::endl;
+        }
+    }
+
     return scannedCode;
 }
@@ -6,6 +6,13 @@
 #include <regex>
 #include <unordered_set>
 
+/**
+ * Removes the one line and the multi line comments.
+ * @param codeLines Lines of code.
+ * @return Lines of code without comments.
+ */
+std::vector<std::string> removeComments(std::vector<std::string> codeLines);
+
 /**
  * Reads a file line by line and removes empty lines and comments.
  * @param filePath File path.
@@ -13,6 +20,15 @@
  */
 std::vector<std::string> readCode(const std::string &filePath);
 
+/**
+ * Scans a single file into tokens, without the files it includes. An include line becomes one
+ * 'Include;path;line' token. The tokens are taken from the build cache when the file was scanned
+ * before with the same content.
+ * @param filePath File path.
+ * @return Vector of tokens of the file.
+ */
+std::vector<std::string> scanFile(const std::string &filePath);
+
 /**
  * Scans the code and breaks it down into tokens that can be parsed.
  * @param codeLines Lines to be scanned.
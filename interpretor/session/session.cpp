@@ -0,0 +1,306 @@
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iostream>
+#include <filesystem>
+#include <unordered_set>
+#include <utility>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "session.h"
+#include "../scanner/scanner.h"
+#include "../parser/parser.h"
+#include "../validator/validator.h"
+#include "../executor/executor.h"
+#include "../cache/cache.h"
+#include "../../io/io.h"
+#include "../../utils/algorithms/algorithms.h"
+
+namespace {
+    /**
+     * Lines of a statement that is being read. A statement is complete once its braces are closed
+     * and, for a transaction, once it is committed or rolled back.
+     */
+    struct PendingStatement {
+        std::vector<std::string> lines;
+        int depth = 0;
+        bool inTransaction = false;
+    };
+
+    /**
+     * Sends the standard output and error to a string from its construction to its destruction.
+     */
+    class OutputCapture {
+    public:
+        OutputCapture() : coutBuffer(std::cout.rdbuf(output.rdbuf())), cerrBuffer(std::cerr.rdbuf(output.rdbuf())) {}
+
+        ~OutputCapture() {
+            std::cout.rdbuf(coutBuffer);
+            std::cerr.rdbuf(cerrBuffer);
+        }
+
+        std::string str() const {
+            return output.str();
+        }
+
+    private:
+        std::ostringstream output;
+        std::streambuf *coutBuffer;
+        std::streambuf *cerrBuffer;
+    };
+
+    std::string sessionDirectory;
+
+    void openSession() {
+        sessionDirectory = (std::filesystem::temp_directory_path() / ("fql_session_" + std::to_string(getpid()))).string();
+        std::filesystem::create_directories(sessionDirectory);
+
+        // The symbols of the session start empty and grow with the declarations of its statements.
+        buildSymbolTable({});
+
+        // A statement builds against the symbols declared before it, so its tokens alone do not identify its build.
+        setBuildCache(false);
+    }
+
+    void closeSession() {
+        std::error_code error;
+        std::filesystem::remove_all(sessionDirectory, error);
+    }
+
+    /**
+     * Adds a line to the statement that is being read.
+     * @param statement Statement that is being read.
+     * @param line Line to add.
+     * @return True if the statement is complete, false otherwise.
+     */
+    bool addLine(PendingStatement &statement, const std::string &line) {
+        std::string trimmedLine = trim(line);
+        if (statement.lines.empty() && (trimmedLine.empty() || trimmedLine.rfind("--", 0) == 0)) return false;
+
+        statement.lines.push_back(line);
+        for (char character : line) {
+            if (character == '{') statement.depth++;
+            else if (character == '}') statement.depth--;
+        }
+
+        if (trimmedLine == "begin") statement.inTransaction = true;
+        else if (trimmedLine == "commit" || trimmedLine == "rollback") statement.inTransaction = false;
+
+        return statement.depth <= 0 && !statement.inTransaction;
+    }
+
+    /**
+     * Builds a statement against the symbols declared by the statements before it and executes its build lines.
+     * The symbols it declares are kept for the next statements only when it builds and executes.
+     * @param statementLines Lines of the statement.
+     */
+    void executeStatement(const std::vector<std::string> &statementLines) {
+        std::string codePath = sessionDirectory + "/statement";
+        createFile(codePath);
+        writeLines(codePath, statementLines);
+
+        // The build messages are only shown when the statement does not build.
+        SymbolTable declaredSymbols = getSymbolTable();
+        bool built;
+        std::string buildOutput;
+        std::vector<std::string> buildLines;
+        {
+            OutputCapture capture;
+            std::unordered_set<std::string> scannedFiles;
+            built = buildStatement(scanCode(codePath, scannedFiles), buildLines);
+            buildOutput = capture.str();
+        }
+        if (!built) {
+            setSymbolTable(std::move(declaredSymbols));
+            std::cout << buildOutput;
+            return;
+        }
+        if (buildLines.empty()) return;
+
+        try {
+            executeCode(buildLines);
+        }
+        catch (...) {
+            setSymbolTable(std::move(declaredSymbols));
+            throw;
+        }
+    }
+
+    /**
+     * Executes every complete statement of a piece of code, a failing statement does not stop the next ones.
+     * @param code Code to execute.
+     */
+    void executeSessionCode(const std::string &code) {
+        std::istringstream input(code);
+        PendingStatement statement;
+        std::string line;
+
+        while (std::getline(input, line)) {
+            if (!addLine(statement, line)) continue;
+
+            try {
+                executeStatement(statement.lines);
+            }
+            catch (const std::exception &exception) {
+                std::cout << "Runtime error: " << exception.what() << std::endl;
+            }
+            statement = PendingStatement{};
+        }
+
+        if (!statement.lines.empty()) std::cout << "Incomplete statement: " << trim(statement.lines[0]) << std::endl;
+    }
+
+    std::string readAll(int descriptor) {
+        std::string content;
+        char buffer[4096];
+        ssize_t count;
+
+        while ((count = read(descriptor, buffer, sizeof(buffer))) != 0) {
+            if (count == -1) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error("Unable to read from the session socket: " + std::string(strerror(errno)));
+            }
+            content.append(buffer, count);
+        }
+        return content;
+    }
+
+    void writeAll(int descriptor, const std::string &content) {
+        size_t written = 0;
+        while (written < content.size()) {
+            ssize_t count = write(descriptor, content.data() + written, content.size() - written);
+            if (count == -1) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error("Unable to write to the session socket: " + std::string(strerror(errno)));
+            }
+            written += count;
+        }
+    }
+
+    sockaddr_un getSocketAddress(const std::string &socketPath) {
+        sockaddr_un address{};
+        if (socketPath.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Socket path " + socketPath + " is too long!");
+        }
+
+        address.sun_family = AF_UNIX;
+        std::strcpy(address.sun_path, socketPath.c_str());
+        return address;
+    }
+}
+
+void runInteractiveSession() {
+    openSession();
+    bool interactive = isatty(STDIN_FILENO);
+
+    PendingStatement statement;
+    std::string line;
+    while (true) {
+        if (interactive) std::cout << (statement.lines.empty() ? "fql> " : "...> ") << std::flush;
+        if (!std::getline(std::cin, line)) break;
+        if (statement.lines.empty() && (trim(line) == "exit" || trim(line) == "quit")) break;
+        if (!addLine(statement, line)) continue;
+
+        try {
+            executeStatement(statement.lines);
+        }
+        catch (const std::exception &exception) {
+            std::cout << "Runtime error: " << exception.what() << std::endl;
+        }
+        statement = PendingStatement{};
+    }
+
+    if (!statement.lines.empty()) std::cout << "Incomplete statement: " << trim(statement.lines[0]) << std::endl;
+    closeSession();
+}
+
+void runSessionServer(const std::string &socketPath) {
+    sockaddr_un address = getSocketAddress(socketPath);
+
+    // A client closing its connection early must not stop the server.
+    signal(SIGPIPE, SIG_IGN);
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server == -1) throw std::runtime_error("Unable to create the session socket: " + std::string(strerror(errno)));
+
+    // A socket left behind by a server that did not stop cleanly is replaced. The socket is created
+    // for the owner only, other local users must not run statements against the database.
+    unlink(socketPath.c_str());
+    mode_t previousMask = umask(0077);
+    bool bound = bind(server, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0;
+    umask(previousMask);
+    if (!bound || listen(server, 16) == -1) {
+        close(server);
+        throw std::runtime_error("Unable to listen on " + socketPath + ": " + std::string(strerror(errno)));
+    }
+
+    openSession();
+    std::cout << "Serving FQL on " << socketPath << std::endl;
+
+    // Connections are served one after another, the executor runs a single statement at a time.
+    bool running = true;
+    while (running) {
+        int client = accept(server, nullptr, nullptr);
+        if (client == -1) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        try {
+            std::string code = readAll(client);
+            std::string response;
+
+            if (trim(code) == "shutdown") {
+                running = false;
+                response = "Server stopped\n";
+            }
+            else {
+                OutputCapture capture;
+                executeSessionCode(code);
+                response = capture.str();
+            }
+            writeAll(client, response);
+        }
+        catch (const std::exception &exception) {
+            std::cerr << exception.what() << std::endl;
+        }
+        close(client);
+    }
+
+    close(server);
+    unlink(socketPath.c_str());
+    closeSession();
+}
+
+std::string sendSessionRequest(const std::string &socketPath, const std::string &code) {
+    sockaddr_un address = getSocketAddress(socketPath);
+
+    int client = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (client == -1) throw std::runtime_error("Unable to create the session socket: " + std::string(strerror(errno)));
+
+    if (connect(client, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1) {
+        close(client);
+        throw std::runtime_error("Unable to connect to " + socketPath + ": " + std::string(strerror(errno)));
+    }
+
+    std::string response;
+    try {
+        writeAll(client, code);
+        // Closing the writing side tells the server the whole code was sent.
+        shutdown(client, SHUT_WR);
+        response = readAll(client);
+    }
+    catch (...) {
+        close(client);
+        throw;
+    }
+
+    close(client);
+    return response;
+}
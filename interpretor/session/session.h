@@ -0,0 +1,32 @@
+#pragma once
+
+#ifndef FQL_SESSION_H
+#define FQL_SESSION_H
+
+#include <string>
+
+/**
+ * Runs an interactive session reading statements from the standard input. Every statement is
+ * scanned, built and executed as soon as it is complete, while the schemas, the relations and
+ * their PK indexes stay loaded between statements. The session ends at the end of the input or
+ * with 'exit'.
+ */
+void runInteractiveSession();
+
+/**
+ * Serves a session on a Unix socket. Every connection sends FQL code and closes its writing side,
+ * the code is executed in the session and its output is sent back. The schemas, the relations and
+ * their PK indexes stay loaded between connections. The server stops when a client sends 'shutdown'.
+ * @param socketPath Path of the Unix socket.
+ */
+void runSessionServer(const std::string &socketPath);
+
+/**
+ * Sends FQL code to a session server and waits for its output.
+ * @param socketPath Path of the Unix socket of the server.
+ * @param code Code to execute.
+ * @return Output of the executed code.
+ */
+std::string sendSessionRequest(const std::string &socketPath, const std::string &code);
+
+#endif //FQL_SESSION_H
@@ -0,0 +1,187 @@
+#include <string>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <filesystem>
+
+#include "statistics.h"
+#include "../../io/io.h"
+#include "../../utils/algorithms/algorithms.h"
+
+namespace {
+    /**
+     * Gets the number a value is ordered by, for the values that are ordered like numbers.
+     * @param value Value to convert.
+     * @param number Number of the value.
+     * @return True if the value is ordered like a number, false otherwise.
+     */
+    bool toNumber(const Value &value, double &number) {
+        if (value.isNull()) return false;
+        if (value.getType() != ValueType::String) {
+            number = static_cast<double>(value.getInteger());
+            return true;
+        }
+
+        // Strings of digits (UUIDs) all have the same length, so they are ordered like their numbers.
+        size_t length = value.getLength();
+        if (length == 0 || length > 18) return false;
+
+        number = 0;
+        const char *characters = value.getCharacters();
+        for (size_t index = 0 ; index < length ; index++) {
+            if (characters[index] < '0' || characters[index] > '9') return false;
+            number = number * 10 + (characters[index] - '0');
+        }
+        return true;
+    }
+
+    /**
+     * Gets the position of a value in a histogram, from 0 (before the minimum) to the amount of buckets
+     * (after the maximum).
+     */
+    double getHistogramPosition(const std::vector<Value> &bounds, const Value &value) {
+        if (value.compare(bounds.front()) < 0) return 0;
+        if (value.compare(bounds.back()) > 0) return static_cast<double>(bounds.size() - 1);
+
+        size_t bucket = 1;
+        while (bucket < bounds.size() - 1 && value.compare(bounds[bucket]) > 0) bucket++;
+
+        double low, high, number;
+        if (toNumber(bounds[bucket - 1], low) && toNumber(bounds[bucket], high) && toNumber(value, number) && high > low) {
+            return static_cast<double>(bucket - 1) + std::clamp((number - low) / (high - low), 0.0, 1.0);
+        }
+        return static_cast<double>(bucket) - 0.5;
+    }
+}
+
+RelationStatistics collectStatistics(Relation *relation, const std::vector<std::string> &lines) {
+    std::vector<std::vector<std::string>> rows;
+    rows.reserve(lines.size());
+    for (const auto &line : lines) {
+        if (!line.empty()) rows.push_back(split(line, ","));
+    }
+
+    RelationStatistics statistics;
+    statistics.rowCount = rows.size();
+
+    // Rows hold their RID first, then the attributes in declaration order.
+    for (int index = 1 ; index <= relation->getAttributeNumber() ; index++) {
+        Datatype &datatype = relation->getAttribute(index)->getDataType();
+        AttributeStatistics attribute;
+        attribute.name = relation->getAttribute(index)->getName();
+
+        std::vector<Value> values;
+        values.reserve(rows.size());
+        for (const auto &row : rows) {
+            if (static_cast<size_t>(index) >= row.size()) continue;
+
+            Value value = datatype.decode(row[index]);
+            if (value.isNull()) attribute.nullCount++;
+            else values.push_back(value);
+        }
+
+        std::sort(values.begin(), values.end(), [](const Value &first, const Value &second) {
+            return first.compare(second) < 0;
+        });
+        for (size_t value = 0 ; value < values.size() ; value++) {
+            if (value == 0 || values[value].compare(values[value - 1]) != 0) attribute.distinctCount++;
+        }
+
+        if (!values.empty()) {
+            size_t buckets = std::min(histogramBuckets, values.size());
+            attribute.bounds.push_back(values.front().toString());
+            for (size_t bucket = 1 ; bucket <= buckets ; bucket++) {
+                size_t last = (bucket * values.size() + buckets - 1) / buckets - 1;
+                attribute.bounds.push_back(values[last].toString());
+            }
+        }
+
+        statistics.attributes.push_back(std::move(attribute));
+    }
+
+    return statistics;
+}
+
+void writeStatistics(const std::string &filePath, const RelationStatistics &statistics) {
+    std::vector<std::string> lines = {"rows," + std::to_string(statistics.rowCount)};
+    for (const auto &attribute : statistics.attributes) {
+        lines.push_back("attribute," + attribute.name + "," + std::to_string(attribute.distinctCount) + "," +
+                        std::to_string(attribute.nullCount));
+
+        std::string bounds = "bounds";
+        for (const auto &bound : attribute.bounds) bounds += "," + bound;
+        lines.push_back(bounds);
+    }
+
+    std::filesystem::create_directories(std::filesystem::path(filePath).parent_path());
+    createFile(filePath);
+    writeLines(filePath, lines);
+}
+
+bool readStatistics(const std::string &filePath, RelationStatistics &statistics) {
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(filePath, error)) return false;
+
+    std::vector<std::string> lines = readLines(filePath);
+    if (lines.empty()) return false;
+
+    auto tokens = split(lines[0], ",");
+    if (tokens.size() != 2 || tokens[0] != "rows" || !isNumber(tokens[1])) return false;
+
+    RelationStatistics readStatistics;
+    readStatistics.rowCount = std::stoull(tokens[1]);
+    for (size_t index = 1 ; index + 1 < lines.size() ; index += 2) {
+        tokens = split(lines[index], ",");
+        if (tokens.size() != 4 || tokens[0] != "attribute" || !isNumber(tokens[2]) || !isNumber(tokens[3])) return false;
+
+        AttributeStatistics attribute;
+        attribute.name = tokens[1];
+        attribute.distinctCount = std::stoull(tokens[2]);
+        attribute.nullCount = std::stoull(tokens[3]);
+
+        tokens = split(lines[index + 1], ",");
+        if (tokens[0] != "bounds") return false;
+        attribute.bounds.assign(tokens.begin() + 1, tokens.end());
+
+        readStatistics.attributes.push_back(std::move(attribute));
+    }
+
+    statistics = std::move(readStatistics);
+    return true;
+}
+
+const AttributeStatistics *findAttributeStatistics(const RelationStatistics &statistics, const std::string &attribute) {
+    for (const auto &attributeStatistics : statistics.attributes) {
+        if (attributeStatistics.name == attribute) return &attributeStatistics;
+    }
+    return nullptr;
+}
+
+double estimateRangeFraction(const RelationStatistics &statistics, const AttributeStatistics &attribute,
+                             Datatype *datatype, const Value *low, const Value *high) {
+    if (statistics.rowCount == 0 || attribute.bounds.size() < 2) return 0;
+
+    std::vector<Value> bounds;
+    bounds.reserve(attribute.bounds.size());
+    for (const auto &bound : attribute.bounds) bounds.push_back(datatype->decode(bound));
+
+    double buckets = static_cast<double>(bounds.size() - 1);
+    double start = low == nullptr ? 0 : getHistogramPosition(bounds, *low);
+    double end = high == nullptr ? buckets : getHistogramPosition(bounds, *high);
+    if (low != nullptr && high != nullptr && low->compare(*high) > 0) return 0;
+
+    double nonNullFraction = 1 - static_cast<double>(attribute.nullCount) / static_cast<double>(statistics.rowCount);
+    double fraction = std::max(0.0, end - start) / buckets * nonNullFraction;
+
+    // A range that is not empty is taken to hold at least one row.
+    return std::clamp(fraction, 1.0 / static_cast<double>(statistics.rowCount), 1.0);
+}
+
+double estimateFullScanCost(size_t rowCount) {
+    return static_cast<double>(rowCount) * scanRowCost;
+}
+
+double estimatePKRangeCost(size_t rowCount, double fraction) {
+    double depth = std::log2(static_cast<double>(rowCount) + 2);
+    return depth * indexNodeCost + fraction * static_cast<double>(rowCount) * lookupRowCost;
+}
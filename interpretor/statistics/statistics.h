@@ -0,0 +1,117 @@
+#pragma once
+
+#ifndef FQL_STATISTICS_H
+#define FQL_STATISTICS_H
+
+#include <string>
+#include <vector>
+
+#include "../../domain/relation/Relation.h"
+#include "../../domain/value/Value.h"
+
+/**
+ * Maximum amount of buckets of the equi-depth histogram of an attribute.
+ */
+const size_t histogramBuckets = 32;
+
+/**
+ * Cost of reading a row in a full scan, the unit of every other cost.
+ */
+const double scanRowCost = 1;
+
+/**
+ * Cost of reading a row through its locator, which seeks in the relation file.
+ */
+const double lookupRowCost = 4;
+
+/**
+ * Cost of visiting a node of the PK index.
+ */
+const double indexNodeCost = 1;
+
+/**
+ * Statistics of an attribute of a relation.
+ * name Name of the attribute.
+ * distinctCount Amount of distinct values, NULL excluded.
+ * nullCount Amount of NULL values.
+ * bounds Bounds of the equi-depth histogram of the values that are not NULL: the minimum, then the
+ * highest value of every bucket, so the last bound is the maximum. Every bucket holds about the same
+ * amount of values. Empty when every value is NULL.
+ */
+struct AttributeStatistics {
+    std::string name;
+    size_t distinctCount = 0;
+    size_t nullCount = 0;
+    std::vector<std::string> bounds;
+};
+
+/**
+ * Statistics of a relation, collected by the analyze method and after every addf.
+ * rowCount Amount of visible rows when the statistics were collected.
+ * attributes Statistics of every attribute, in declaration order.
+ */
+struct RelationStatistics {
+    size_t rowCount = 0;
+    std::vector<AttributeStatistics> attributes;
+};
+
+/**
+ * Collects the statistics of a relation from its rows.
+ * @param relation Relation the rows belong to.
+ * @param lines Visible rows of the relation, without the header.
+ * @return Statistics of the relation.
+ */
+RelationStatistics collectStatistics(Relation *relation, const std::vector<std::string> &lines);
+
+/**
+ * Writes the statistics of a relation to a file, replacing the previous ones.
+ * @param filePath Path of the statistics file.
+ * @param statistics Statistics to write.
+ */
+void writeStatistics(const std::string &filePath, const RelationStatistics &statistics);
+
+/**
+ * Reads the statistics of a relation written by writeStatistics.
+ * @param filePath Path of the statistics file.
+ * @param statistics Statistics read from the file.
+ * @return True if the file holds statistics, false if it is missing or malformed.
+ */
+bool readStatistics(const std::string &filePath, RelationStatistics &statistics);
+
+/**
+ * Finds the statistics of an attribute.
+ * @param statistics Statistics of the relation.
+ * @param attribute Name of the attribute.
+ * @return Statistics of the attribute, nullptr if there are none.
+ */
+const AttributeStatistics *findAttributeStatistics(const RelationStatistics &statistics, const std::string &attribute);
+
+/**
+ * Estimates the fraction of the rows of a relation whose attribute is in a range, from its histogram.
+ * Numeric values are interpolated inside a bucket, any other value is taken as the middle of its bucket.
+ * @param statistics Statistics of the relation.
+ * @param attribute Statistics of the attribute.
+ * @param datatype Data type of the attribute.
+ * @param low Lowest value of the range, nullptr for no lower bound.
+ * @param high Highest value of the range, nullptr for no upper bound.
+ * @return Estimated fraction of the rows, between 0 and 1.
+ */
+double estimateRangeFraction(const RelationStatistics &statistics, const AttributeStatistics &attribute,
+                             Datatype *datatype, const Value *low, const Value *high);
+
+/**
+ * Estimates the cost of reading every row of a relation.
+ * @param rowCount Amount of rows of the relation.
+ * @return Estimated cost.
+ */
+double estimateFullScanCost(size_t rowCount);
+
+/**
+ * Estimates the cost of finding the rows of a PK range through the PK index and reading them by their locators.
+ * @param rowCount Amount of rows of the relation.
+ * @param fraction Estimated fraction of the rows in the range.
+ * @return Estimated cost.
+ */
+double estimatePKRangeCost(size_t rowCount, double fraction);
+
+#endif //FQL_STATISTICS_H
@@ -0,0 +1,362 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <filesystem>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+
+#include "transaction.h"
+#include "../../io/io.h"
+#include "../../utils/metrics/metrics.h"
+#include "../../utils/algorithms/algorithms.h"
+
+namespace {
+    const std::string clockPath = transactionDirectory + "/clock";
+    const std::string commitLogPath = transactionDirectory + "/commits";
+    const std::string activeDirectory = transactionDirectory + "/active";
+    const std::string lockDirectory = transactionDirectory + "/locks";
+
+    uint64_t transactionId = 0;
+    uint64_t snapshot = 0;
+    bool wroteVersions = false;
+
+    // Maps every committed transaction to its position in the commit log, which is read incrementally.
+    std::unordered_map<uint64_t, uint64_t> commitSequence;
+    uint64_t commitLogOffset = 0;
+
+    std::unordered_map<std::string, int> writeLocks;
+    std::unordered_set<std::string> writtenFiles;
+
+    std::string padStamp(uint64_t stamp) {
+        std::string padded = std::to_string(stamp);
+        if (padded.size() < endStampWidth) padded.insert(0, endStampWidth - padded.size(), '0');
+        return padded;
+    }
+
+    bool parseStamp(std::string_view rid, RowVersion &version) {
+        size_t at = rid.find('@');
+        if (at == std::string_view::npos) {
+            version = RowVersion{0, 0};
+            return !rid.empty();
+        }
+
+        size_t dash = rid.find('-', at);
+        if (dash == std::string_view::npos || rid.size() - dash - 1 != endStampWidth) return false;
+
+        version = RowVersion{0, 0};
+        for (size_t index = at + 1 ; index < rid.size() ; index++) {
+            if (index == dash) continue;
+            if (rid[index] < '0' || rid[index] > '9') return false;
+
+            uint64_t &stamp = index < dash ? version.begin : version.end;
+            stamp = stamp * 10 + (rid[index] - '0');
+        }
+        return true;
+    }
+
+    std::string_view getRID(std::string_view line) {
+        return line.substr(0, line.find(','));
+    }
+
+    void readCommitLog() {
+        std::ifstream fin(commitLogPath, std::ios::binary);
+        if (!fin.is_open()) return;
+
+        fin.seekg(static_cast<std::streamoff>(commitLogOffset));
+        std::string content((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+
+        // A commit that is still being written has no newline yet and is read the next time.
+        size_t start = 0;
+        size_t end;
+        while ((end = content.find('\n', start)) != std::string::npos) {
+            if (end > start) {
+                uint64_t committed = std::stoull(content.substr(start, end - start));
+                commitSequence.emplace(committed, commitSequence.size());
+            }
+            start = end + 1;
+        }
+        commitLogOffset += start;
+    }
+
+    bool isCommittedBefore(uint64_t transaction, uint64_t limit) {
+        if (transaction == 0) return true;
+
+        auto it = commitSequence.find(transaction);
+        return it != commitSequence.end() && it->second < limit;
+    }
+
+    bool isVisibleVersion(const RowVersion &version) {
+        // Outside a transaction every committed version is seen.
+        uint64_t limit = transactionId == 0 ? UINT64_MAX : snapshot;
+
+        bool created = version.begin == transactionId || isCommittedBefore(version.begin, limit);
+        bool ended = version.end != 0 && (version.end == transactionId || isCommittedBefore(version.end, limit));
+        return created && !ended;
+    }
+
+    bool isProcessAlive(pid_t pid) {
+        return kill(pid, 0) == 0 || errno == EPERM;
+    }
+
+    /**
+     * Reads the active transactions with their snapshots. Transactions of processes that exited
+     * without committing are aborted and removed from the registry.
+     */
+    std::unordered_map<uint64_t, uint64_t> getActiveTransactions() {
+        std::unordered_map<uint64_t, uint64_t> active;
+        if (!validDirectory(activeDirectory)) return active;
+
+        for (const auto &entry : std::filesystem::directory_iterator(activeDirectory)) {
+            std::vector<std::string> lines = readLines(entry.path().string());
+            if (lines.empty()) continue;
+
+            auto tokens = split(lines[0], ",");
+            if (tokens.size() < 2) continue;
+            if (!isProcessAlive(static_cast<pid_t>(std::stol(tokens[0])))) {
+                std::error_code error;
+                std::filesystem::remove(entry.path(), error);
+                continue;
+            }
+            active[std::stoull(entry.path().filename().string())] = std::stoull(tokens[1]);
+        }
+        return active;
+    }
+
+    void finishTransaction() {
+        std::error_code error;
+        std::filesystem::remove(activeDirectory + "/" + std::to_string(transactionId), error);
+
+        for (const auto &[filePath, descriptor] : writeLocks) releaseFileLock(descriptor);
+        writeLocks.clear();
+        writtenFiles.clear();
+
+        transactionId = 0;
+        wroteVersions = false;
+    }
+}
+
+void beginTransaction() {
+    if (transactionId != 0) throw std::runtime_error("A transaction is already running!");
+
+    createDirectory("DB");
+    createDirectory(transactionDirectory);
+    createDirectory(activeDirectory);
+    createDirectory(lockDirectory);
+
+    // The clock lock orders the start of a transaction against the commits of the others.
+    int lock = acquireFileLock(clockPath);
+
+    uint64_t lastTransaction = 0;
+    if (validFile(clockPath)) {
+        std::vector<std::string> lines = readLines(clockPath);
+        if (!lines.empty() && !lines[0].empty()) lastTransaction = std::stoull(lines[0]);
+    }
+    else createFile(clockPath);
+
+    transactionId = lastTransaction + 1;
+    writeLines(clockPath, {std::to_string(transactionId)});
+
+    readCommitLog();
+    snapshot = commitSequence.size();
+
+    std::string activePath = activeDirectory + "/" + std::to_string(transactionId);
+    createFile(activePath);
+    writeLines(activePath, {std::to_string(getpid()) + "," + std::to_string(snapshot)});
+
+    releaseFileLock(lock);
+    wroteVersions = false;
+}
+
+void commitTransaction() {
+    if (transactionId == 0) return;
+
+    // A transaction that wrote no version has nothing to publish and leaves the commit log untouched.
+    if (wroteVersions) {
+        // The written files reach the disk before the commit record, so a commit that survives a crash has all its rows.
+        for (const auto &[filePath, descriptor] : writeLocks) writtenFiles.insert(filePath);
+        for (const auto &filePath : writtenFiles) {
+            if (validFile(filePath)) syncFile(filePath);
+        }
+
+        int lock = acquireFileLock(clockPath);
+        writeLine(commitLogPath, std::to_string(transactionId));
+        syncFile(commitLogPath);
+        releaseFileLock(lock);
+    }
+
+    finishTransaction();
+}
+
+void abortTransaction() {
+    if (transactionId == 0) return;
+
+    finishTransaction();
+}
+
+uint64_t getTransactionId() {
+    return transactionId;
+}
+
+int acquireFileLock(const std::string &filePath) {
+    std::string lockName = filePath;
+    std::replace(lockName.begin(), lockName.end(), '/', '_');
+
+    std::string lockPath = lockDirectory + "/" + lockName + ".lock";
+    int descriptor = open(lockPath.c_str(), O_CREAT | O_RDWR, 0644);
+    if (descriptor == -1) throw std::runtime_error("Unable to open lock file: " + lockPath);
+
+    if (flock(descriptor, LOCK_EX) == -1) {
+        close(descriptor);
+        throw std::runtime_error("Unable to lock file: " + filePath);
+    }
+    return descriptor;
+}
+
+void releaseFileLock(int descriptor) {
+    flock(descriptor, LOCK_UN);
+    close(descriptor);
+}
+
+bool lockForWrite(const std::string &filePath) {
+    if (writeLocks.find(filePath) != writeLocks.end()) return false;
+
+    writeLocks[filePath] = acquireFileLock(filePath);
+    return true;
+}
+
+void recordWrittenFile(const std::string &filePath) {
+    if (transactionId != 0) writtenFiles.insert(filePath);
+}
+
+std::string stampRow(const std::string &row) {
+    size_t ridEnd = std::min(row.find(','), row.size());
+    std::string rid = row.substr(0, std::min(row.find('@'), ridEnd));
+
+    wroteVersions = true;
+    return rid + "@" + std::to_string(transactionId) + "-" + padStamp(0) + row.substr(ridEnd);
+}
+
+bool getRowVersion(const std::string &line, RowVersion &version) {
+    return parseStamp(getRID(line), version);
+}
+
+bool isVersionedRow(const std::string &line) {
+    return getRID(line).find('@') != std::string_view::npos;
+}
+
+std::string getRowData(const std::string &line) {
+    size_t ridEnd = std::min(line.find(','), line.size());
+    size_t at = line.find('@');
+    if (at >= ridEnd) return line;
+
+    return line.substr(0, at) + line.substr(ridEnd);
+}
+
+bool isVisibleRID(const std::string &rid) {
+    RowVersion version{};
+    return parseStamp(rid, version) && isVisibleVersion(version);
+}
+
+bool isVisibleRow(const std::string &line) {
+    RowVersion version{};
+    return parseStamp(getRID(line), version) && isVisibleVersion(version);
+}
+
+bool isNewerRow(const std::string &line) {
+    RowVersion version{};
+    if (!parseStamp(getRID(line), version)) return false;
+
+    readCommitLog();
+    auto isNewer = [](uint64_t transaction) {
+        if (transaction == 0 || transaction == transactionId) return false;
+
+        auto it = commitSequence.find(transaction);
+        return it != commitSequence.end() && it->second >= snapshot;
+    };
+    return isNewer(version.begin) || isNewer(version.end);
+}
+
+void endRowVersions(const std::string &filePath, const std::vector<std::pair<uint64_t, std::string>> &rows) {
+    if (rows.empty()) return;
+
+    countMetric(Metric::FileOpens);
+    std::fstream file(filePath, std::ios::in | std::ios::out | std::ios::binary);
+    if (!file.is_open()) throw std::runtime_error("Unable to open file: " + filePath);
+
+    std::string stamp = padStamp(transactionId);
+    for (const auto &[offset, line] : rows) {
+        RowVersion version{};
+        if (!isVersionedRow(line) || !getRowVersion(line, version)) {
+            throw std::runtime_error("Row " + line + " of " + filePath + " is not versioned!");
+        }
+
+        // Writers of a relation are serialized, so an end stamp of another transaction is either
+        // committed, which means the row changed after the snapshot was taken, or aborted.
+        if (version.end != 0 && version.end != transactionId) {
+            readCommitLog();
+            if (commitSequence.find(version.end) != commitSequence.end()) {
+                throw std::runtime_error("Write conflict: row " + getRowData(line) +
+                                         " was changed by a transaction committed after this one started!");
+            }
+        }
+
+        file.seekp(static_cast<std::streamoff>(offset + line.find('-', line.find('@')) + 1));
+        file.write(stamp.data(), static_cast<std::streamsize>(stamp.size()));
+    }
+    file.close();
+    recordBytesWritten(rows.size() * stamp.size());
+
+    wroteVersions = true;
+}
+
+std::vector<std::string> readVisibleLines(const std::string &filePath) {
+    std::vector<std::string> lines = readRelationLines(filePath);
+    std::vector<std::string> visibleLines;
+    visibleLines.reserve(lines.size());
+    if (!lines.empty()) countMetric(Metric::RowsScanned, lines.size() - 1);
+
+    if (!lines.empty()) visibleLines.push_back(lines[0]);
+    for (size_t index = 1 ; index < lines.size() ; index++) {
+        if (isVisibleRow(lines[index])) visibleLines.push_back(getRowData(lines[index]));
+    }
+    return visibleLines;
+}
+
+std::vector<std::string> collectGarbage(const std::vector<std::string> &lines) {
+    readCommitLog();
+    std::unordered_map<uint64_t, uint64_t> active = getActiveTransactions();
+
+    // Versions ended before the oldest snapshot still in use are invisible to every transaction.
+    uint64_t horizon = commitSequence.size();
+    for (const auto &[transaction, activeSnapshot] : active) horizon = std::min(horizon, activeSnapshot);
+
+    std::vector<std::string> keptLines;
+    if (!lines.empty()) keptLines.push_back(lines[0]);
+
+    for (size_t index = 1 ; index < lines.size() ; index++) {
+        const std::string &line = lines[index];
+        RowVersion version{};
+        if (isFreeLine(line) || !getRowVersion(line, version)) continue;
+
+        bool aborted = version.begin != 0 && commitSequence.find(version.begin) == commitSequence.end()
+                       && active.find(version.begin) == active.end();
+        bool expired = version.end != 0 && isCommittedBefore(version.end, horizon);
+        if (aborted || expired) continue;
+
+        // Rows written before versioning get a stamp, so they can be ended in place later on.
+        if (!isVersionedRow(line)) {
+            size_t ridEnd = std::min(line.find(','), line.size());
+            keptLines.push_back(line.substr(0, ridEnd) + "@0-" + padStamp(0) + line.substr(ridEnd));
+        }
+        else keptLines.push_back(line);
+    }
+    return keptLines;
+}
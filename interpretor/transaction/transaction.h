@@ -0,0 +1,164 @@
+#pragma once
+
+#ifndef FQL_TRANSACTION_H
+#define FQL_TRANSACTION_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Directory holding the clock, the commit log, the active transactions and the lock files.
+ */
+const std::string transactionDirectory = "DB/transactions";
+
+/**
+ * Width of the end stamp of a row version. The stamp has a fixed width so that a version can be
+ * ended by overwriting it in place, without moving the rest of the file.
+ */
+const size_t endStampWidth = 12;
+
+/**
+ * Transactions that created and ended a version of a row. A row version is stored as
+ * "RID@begin-end,values...", where end is 0 while the version is current. Rows stored as
+ * "RID,values..." were written before versioning and are seen by every transaction.
+ */
+struct RowVersion {
+    uint64_t begin;
+    uint64_t end;
+};
+
+/**
+ * Starts a transaction. It gets a new id and a snapshot of the transactions committed so far,
+ * and it is registered as active until it commits or aborts.
+ */
+void beginTransaction();
+
+/**
+ * Commits the current transaction, making its row versions visible to the transactions started
+ * after it, and releases its write locks. The relation files it locked, the files registered with
+ * recordWrittenFile and then its commit record are synced to the disk, so the commit is durable
+ * once this returns.
+ */
+void commitTransaction();
+
+/**
+ * Aborts the current transaction and releases its write locks. Its row versions are never
+ * committed, so they stay invisible and are reclaimed by the next compaction.
+ */
+void abortTransaction();
+
+/**
+ * Gets the id of the current transaction.
+ * @return Id of the transaction, 0 if none is running.
+ */
+uint64_t getTransactionId();
+
+/**
+ * Takes an exclusive lock on a file, waiting for the process that holds it. The lock is taken on a
+ * separate lock file, so the file itself can be replaced while it is locked.
+ * @param filePath Path of the locked file.
+ * @return Descriptor of the lock file, passed to releaseFileLock.
+ */
+int acquireFileLock(const std::string &filePath);
+
+/**
+ * Releases a lock taken with acquireFileLock.
+ * @param descriptor Descriptor of the lock file.
+ */
+void releaseFileLock(int descriptor);
+
+/**
+ * Takes the write lock of a relation file for the rest of the current transaction. Writers of the
+ * same relation are serialized, readers never take it.
+ * @param filePath Path of the relation file.
+ * @return True if the lock was taken now, false if the transaction already held it.
+ */
+bool lockForWrite(const std::string &filePath);
+
+/**
+ * Registers a file written by the current transaction besides the relations it locked, like the
+ * current RIDs, a dictionary or a rewritten relation, so that the commit syncs it too.
+ * Does nothing outside a transaction.
+ * @param filePath Path of the written file.
+ */
+void recordWrittenFile(const std::string &filePath);
+
+/**
+ * Stamps a row as a new version created by the current transaction, replacing its previous stamp.
+ * @param row Row starting with its RID.
+ * @return Row stamped with the current transaction.
+ */
+std::string stampRow(const std::string &row);
+
+/**
+ * Reads the stamp of a row version.
+ * @param line Line of a relation file.
+ * @param version Transactions that created and ended the version.
+ * @return True if the stamp could be read, false if the line is not a complete row.
+ */
+bool getRowVersion(const std::string &line, RowVersion &version);
+
+/**
+ * Checks if a row carries a version stamp, rather than being written before versioning.
+ * @param line Line of a relation file.
+ * @return True if the row is stamped, false otherwise.
+ */
+bool isVersionedRow(const std::string &line);
+
+/**
+ * Removes the stamp from a row version.
+ * @param line Line of a relation file.
+ * @return Row as it is shown to the user, starting with its bare RID.
+ */
+std::string getRowData(const std::string &line);
+
+/**
+ * Checks if a row version is seen by the current transaction: it was created by a transaction
+ * committed before its snapshot (or by itself) and was not ended by one.
+ * @param rid First token of the row, holding the RID and the stamp.
+ * @return True if the version is visible, false otherwise.
+ */
+bool isVisibleRID(const std::string &rid);
+
+/**
+ * Checks if a row version is seen by the current transaction.
+ * @param line Line of a relation file.
+ * @return True if the version is visible, false otherwise.
+ */
+bool isVisibleRow(const std::string &line);
+
+/**
+ * Checks if a row version was created or ended by a transaction that committed after the snapshot of
+ * the current one, so the current transaction is not allowed to write over it.
+ * @param line Line of a relation file.
+ * @return True if the version is newer than the snapshot, false otherwise.
+ */
+bool isNewerRow(const std::string &line);
+
+/**
+ * Ends row versions seen by the current transaction by writing its id into their end stamps in place.
+ * @param filePath Path of the relation file, locked with lockForWrite.
+ * @param rows Pairs of byte offsets and contents of the ended lines.
+ * @throws std::runtime_error If a version was already ended by a transaction that committed after
+ * the snapshot of the current one.
+ */
+void endRowVersions(const std::string &filePath, const std::vector<std::pair<uint64_t, std::string>> &rows);
+
+/**
+ * Reads the header and the row versions of a relation file seen by the current transaction.
+ * @param filePath Path of the relation file.
+ * @return Vector of strings containing the header followed by the visible rows, without their stamps.
+ */
+std::vector<std::string> readVisibleLines(const std::string &filePath);
+
+/**
+ * Removes the row versions no transaction can see anymore: versions ended by a transaction that
+ * committed before the oldest active snapshot, and versions created by aborted transactions.
+ * @param lines Header and rows of a relation file.
+ * @return Header and rows that are kept.
+ */
+std::vector<std::string> collectGarbage(const std::vector<std::string> &lines);
+
+#endif //FQL_TRANSACTION_H
@@ -2,42 +2,121 @@
 #include <vector>
 #include <unordered_map>
 #include <regex>
-#include <stack>
+#include <utility>
 
 #include "validator.h"
 #include "../../utils/algorithms/algorithms.h"
-#include "../../utils/data_structures/AST/AST.h"
 
-bool isSchema(const std::string &schema, const std::vector<std::string> &codeLines){
-    std::vector<std::string> schemas = getSchemas(codeLines);
+namespace {
+    SymbolTable symbolTable;
 
-    for (const std::string &currentSchema : schemas) {
-        if (currentSchema == schema) return true;
+    bool isToken(const std::vector<std::string> &codeLines, size_t index, const std::string &type, const std::string &value) {
+        if (index >= codeLines.size()) return false;
+
+        auto tokens = split(codeLines[index], ";");
+        return tokens[0] == type && tokens.size() > 1 && tokens[1] == value;
     }
 
-    return false;
-}
+    bool isTokenType(const std::vector<std::string> &codeLines, size_t index, const std::string &type) {
+        return index < codeLines.size() && split(codeLines[index], ";")[0] == type;
+    }
+
+    std::string getTokenValue(const std::vector<std::string> &codeLines, size_t index) {
+        auto tokens = split(codeLines[index], ";");
+        return tokens.size() > 1 ? tokens[1] : "";
+    }
+
+    /**
+     * Adds the attributes and the data types declared in the block of a relation starting at index.
+     */
+    void addRelationBlock(const std::string &relation, size_t index, const std::vector<std::string> &codeLines) {
+        std::vector<std::string> &attributes = symbolTable.relationAttributes[relation];
+        std::vector<std::string> dataTypes;
 
-bool isRelation(const std::string &relation, const std::vector<std::string> &codeLines){
-    std::vector<std::string> relations = getRelations(codeLines);
+        while (index < codeLines.size()) {
+            auto tokens = split(codeLines[index], ";");
+            if (tokens.size() > 1 && tokens[1] == "}") break;
 
-    for (const std::string &currentRelation : relations) {
-        if (currentRelation == relation) return true;
+            if (tokens[0] == "Identifier") attributes.push_back(tokens[1]);
+            else if (tokens[0] == "Keyword" && isDataType(tokens[1])) dataTypes.push_back(tokens[1]);
+            else if (tokens[0] == "Keyword" && isParameterDataType(tokens[1])) {
+                std::string dataType;
+                while (index < codeLines.size() && getTokenValue(codeLines, index) != ")") {
+                    dataType += getTokenValue(codeLines, index);
+                    index++;
+                }
+                dataTypes.push_back(dataType + ")");
+                continue;
+            }
+            index++;
+        }
+
+        // The data types of a relation are taken from its first block that declares any.
+        auto &relationDataTypes = symbolTable.relationDataTypes[relation];
+        if (relationDataTypes.empty()) relationDataTypes = dataTypes;
     }
+}
 
-    return false;
+void buildSymbolTable(const std::vector<std::string> &codeLines) {
+    symbolTable = SymbolTable{};
+    extendSymbolTable(codeLines);
 }
 
-bool isArray(const std::string &array, const std::vector<std::string> &codeLines) {
-    std::vector<std::string> arrays = getArrays(codeLines);
+void extendSymbolTable(const std::vector<std::string> &codeLines) {
+    for (size_t index = 0 ; index < codeLines.size() ; index++) {
+        auto tokens = split(codeLines[index], ";");
+        if (tokens.size() < 2) continue;
 
-    for (const auto &currentArray : arrays) {
-        if (currentArray == array) {
-            return true;
+        bool isDeclaration = isToken(codeLines, index + 1, "Separator", ":") &&
+                             isTokenType(codeLines, index + 2, "Identifier");
+
+        if (tokens[0] == "Keyword" && tokens[1] == "schema" && isDeclaration) {
+            std::string schema = getTokenValue(codeLines, index + 2);
+            symbolTable.schemas.push_back(schema);
+            symbolTable.schemaCounts[schema]++;
+        }
+        else if (tokens[0] == "Keyword" && tokens[1] == "using" && isDeclaration) {
+            symbolTable.usedSchema = getTokenValue(codeLines, index + 2);
+        }
+        else if (tokens[0] == "Keyword" && tokens[1] == "relation" && isDeclaration) {
+            std::string relation = getTokenValue(codeLines, index + 2);
+            symbolTable.relationSchemas.insert(make_pair(relation, symbolTable.usedSchema));
+
+            // 'relation: name -> {' declares the attributes, the relation itself is declared by 'relation: name'.
+            if (!isToken(codeLines, index + 3, "Separator", "->")) {
+                symbolTable.relations.push_back(relation);
+                symbolTable.relationCounts[relation]++;
+            }
+        }
+        else if (tokens[0] == "Keyword" && tokens[1] == "let" && isTokenType(codeLines, index + 1, "Identifier")) {
+            std::string array = getTokenValue(codeLines, index + 1);
+            symbolTable.arrays.push_back(array);
+            symbolTable.arrayCounts[array]++;
+        }
+        else if (tokens[0] == "Identifier" && isToken(codeLines, index + 1, "Separator", "->")) {
+            addRelationBlock(tokens[1], index + 2, codeLines);
         }
     }
+}
 
-    return false;
+const SymbolTable &getSymbolTable() {
+    return symbolTable;
+}
+
+void setSymbolTable(SymbolTable table) {
+    symbolTable = std::move(table);
+}
+
+bool isSchema(const std::string &schema){
+    return symbolTable.schemaCounts.contains(schema);
+}
+
+bool isRelation(const std::string &relation){
+    return symbolTable.relationCounts.contains(relation);
+}
+
+bool isArray(const std::string &array) {
+    return symbolTable.arrayCounts.contains(array);
 }
 
 bool isAttribute(const std::string &attribute, const std::vector<std::string> &attributes){
@@ -75,407 +154,70 @@ bool isConstraint(const std::string &constraint){
 bool isMethod(const std::string &method){
     if (method == "add" || method == "delete"
         || method == "fetch" || method == "update"
-        || method == "addf") return true;
+        || method == "addf" || method == "compact"
+        || method == "analyze" || method == "compress") return true;
 
     return false;
 }
 
-bool isParameterDataType(const std::string &dataType){
-    if (dataType == "varchar" || dataType == "char") return true;
+bool isAggregateFunction(const std::string &function){
+    if (function == "count" || function == "sum" || function == "min"
+        || function == "max" || function == "avg") return true;
 
     return false;
 }
 
-std::vector<std::string> getSchemas(const std::vector<std::string> &codeLines) {
-    std::vector<std::string> schemas;
-    auto it = codeLines.begin();
-
-    while (it != codeLines.end()) {
-        auto tokens = split(*it, ";");
-        if (tokens[0] == "Keyword" && tokens[1] == "schema") {
-            it++;
-            if (it != codeLines.end() && split(*it, ";")[0] == "Separator" && split(*it, ";")[1] == ":") {
-                it++;
-                if (it != codeLines.end() && split(*it, ";")[0] == "Identifier") schemas.push_back(split(*it, ";")[1]);
-            }
-        }
-        else it++;
-    }
-
-    return schemas;
-}
-
-std::vector<std::string> getRelations(const std::vector<std::string> &codeLines){
-    std::vector<std::string> relations;
-    auto it = codeLines.begin();
-
-    while (it != codeLines.end() - 1) {
-        auto tokens = split(*it, ";");
-
-        if ((tokens[0] == "Keyword" && tokens[1] == "relation")) {
-            it++;
-            if (it != codeLines.end() && split(*it, ";")[0] == "Separator" && split(*it, ";")[1] == ":") {
-                it++;
-                if (it != codeLines.end() && split(*it, ";")[0] == "Identifier" && split(*(std::next(it)), ";")[1] != "->") relations.push_back(split(*it, ";")[1]);
-            }
-        }
-        else it++;
-    }
-
-    return relations;
-}
-
-std::vector<std::string> getArrays(const std::vector<std::string> &codeLines){
-    std::vector<std::string> arrays;
-    auto it = codeLines.begin();
-
-    while (it != codeLines.end() - 1){
-        auto tokens = split(*it, ";");
-
-        if ((tokens[0] == "Keyword" && tokens[1] == "let")) {
-            it++;
-            if (it != codeLines.end() && split(*it, ";")[0] == "Identifier") arrays.push_back(split(*it, ";")[1]);
-        }
-        else it++;
-    }
-
-    return arrays;
-}
-
-std::unordered_map<std::string, std::string> getRelationSchema(const std::vector<std::string> &codeLines){
-    std::unordered_map<std::string, std::string> relationSchemaMap;
-    std::string usedSchema = "NULL"; //TODO try to find another way to initialise usedSchema
-    auto it = codeLines.begin();
-
-    while (it != codeLines.end()) {
-        auto tokens = split(*it, ";");
-
-        if (tokens[0] == "Keyword" && tokens[1] == "using"){
-            it++;
-            if (it != codeLines.end() && split(*it, ";")[0] == "Separator" && split(*it, ";")[1] == ":") {
-                it++;
-                if (it != codeLines.end() && split(*it, ";")[0] == "Identifier") usedSchema = split(*it, ";")[1];
-            }
-        }
-        else if (tokens[0] == "Keyword" && tokens[1] == "relation"){
-            it++;
-            if (it != codeLines.end() && split(*it, ";")[0] == "Separator" && split(*it, ";")[1] == ":") {
-                it++;
-                if (it != codeLines.end() && split(*it, ";")[0] == "Identifier") relationSchemaMap.insert(make_pair(split(*it, ";")[1], usedSchema));
-            }
-        }
-        else it++;
-    }
-
-    return relationSchemaMap;
-}
-
-std::vector<std::string> getRelationDataTypes(const std::string &relation, const std::vector<std::string> &codeLines){
-    std::vector<std::string> dataTypes;
-
-    auto it = codeLines.begin();
-    while (it != codeLines.end()){
-        if (split(*it, ";")[0] == "Identifier" && split(*it, ";")[1] == relation
-            && split(*(it + 1), ";")[1] == "->"){
-            it++;
-            auto tokens = split(*it, ";");
-            while (tokens[1] != "}"){
-                if (tokens[0] == "Keyword" && isDataType(tokens[1])){
-                    dataTypes.push_back(tokens[1]);
-                    it++;
-                }
-                else if (tokens[0] == "Keyword" && isParameterDataType(tokens[1])){
-                    std::string attr;
-                    while (tokens[1] != ")"){
-                        attr += tokens[1];
-                        it++;
-                        tokens = split(*it, ";");
-                    }
-                    dataTypes.push_back(attr + ")");
-                }
-                else it++;
-                tokens = split(*it, ";");
-            }
-            if (!dataTypes.empty()) return dataTypes;
-        }
-        it++;
-    }
-    return dataTypes;
-}
-
-std::vector<std::string> getRelationAttributes(const std::string &relation, const std::vector<std::string> &codeLines) {
-    std::vector<std::string> attributes;
-
-    for (auto it = codeLines.begin(); it != codeLines.end(); ++it) {
-        auto tokens = split(*it, ";");
-        if (tokens[0] == "Identifier" && tokens[1] == relation) {
-            auto nextIt = std::next(it);
-            if (nextIt != codeLines.end()) {
-                auto nextTokens = split(*nextIt, ";");
-                if (nextTokens[1] == "->") {
-                    nextIt++;
-                    while (nextIt != codeLines.end()) {
-                        auto attrTokens = split(*nextIt, ";");
-                        if (attrTokens[1] == "}") {
-                            break;
-                        }
-                        if (attrTokens[0] == "Identifier") {
-                            attributes.push_back(attrTokens[1]);
-                        }
-                        nextIt++;
-                    }
-                }
-            }
-        }
-    }
-
-    return attributes;
-}
-
-bool schemaAlreadyExists(const std::string &schema, const std::vector<std::string> &codeLines) {
-    std::vector<std::string> schemas = getSchemas(codeLines);
-    int count = 0;
-
-    for (const std::string &currentSchema : schemas) {
-        if (currentSchema == schema) {
-            count++;
-            if (count >= 2) return true;
-        }
-    }
+bool isParameterDataType(const std::string &dataType){
+    if (dataType == "varchar" || dataType == "char") return true;
 
     return false;
 }
 
-bool arrayAlreadyExists(const std::string &array, const std::vector<std::string> &codeLines){
-    std::vector<std::string> arrays = getArrays(codeLines);
-    int count = 0;
-
-    for (const std::string &currentArray : arrays) {
-        if (currentArray == array) {
-            count++;
-            if (count >= 2) return true;
-        }
-    }
-
-    return false;
+const std::vector<std::string> &getSchemas() {
+    return symbolTable.schemas;
 }
 
-bool schemaExists(const std::string &schema, const std::vector<std::string> &codeLines){
-    std::vector<std::string> schemas = getSchemas(codeLines);
-
-    for (const std::string &currentSchema : schemas) {
-        if (currentSchema == schema) return true;
-    }
-
-    return false;
+const std::vector<std::string> &getRelations(){
+    return symbolTable.relations;
 }
 
-bool relationExists(const std::string &relation, const std::vector<std::string> &codeLines) {
-    std::vector<std::string> relations = getRelations(codeLines);
-    int count = 0;
-
-    for (const std::string &currentRelation: relations) {
-        if (currentRelation == relation) {
-            count++;
-            if (count >= 2) return true;
-        }
-    }
-
-    return false;
+const std::vector<std::string> &getArrays(){
+    return symbolTable.arrays;
 }
 
-bool isOperator(const std::string &op){
-    if (op == "==" || op == ">" || op == "<" || op == ">=" || op == "<="
-        || op == "and" || op == "or" || op == "!=" || op == "=") return true;
-    return false;
+const std::unordered_map<std::string, std::string> &getRelationSchema(){
+    return symbolTable.relationSchemas;
 }
 
-bool isExpressionValid(const std::vector<std::string>& expressionTokens,
-                       const std::unordered_map<std::string, std::string>& dataTypes) {
-    std::vector<std::string> attributes;
-    attributes.reserve(dataTypes.size());
-
-    for (const auto& [key, value] : dataTypes) {
-        attributes.push_back(key);
-    }
-
-    auto *expressionTree = new AST();
-    for (const auto &token : expressionTokens){
-        auto tokens = split(token, ";");
-
-        if (tokens[0] == "Separator" && tokens[1] == "("){
-            if (expressionTree->getCurrentNode() == "Operator") return false;
-            expressionTree->createChildren();
-            expressionTree->insertInCurrentNode("Operator");
-            expressionTree->goLeft();
-        }
-        else if (tokens[0] == "Separator" && tokens[1] == ")"){
-            expressionTree->goUp();
-        }
-        else if (tokens[0] == "Identifier"){
-            if (!isAttribute(tokens[1], attributes)) return false;
-            expressionTree->insertInCurrentNode(tokens[1] + ";" + getKeyValue(dataTypes, tokens[1]));
-            expressionTree->goUp();
-        }
-        else if (tokens[0] == "Separator" && isOperator(tokens[1])){
-            if (isOperator(expressionTree->getCurrentNode())) return false;
-            expressionTree->insertInCurrentNode(tokens[1]);
+const std::vector<std::string> &getRelationDataTypes(const std::string &relation){
+    static const std::vector<std::string> noDataTypes;
 
-            if (expressionTree->rightNodeIsNull()) expressionTree->goRight();
-            else {
-                //TODO Check if the separator is valid between the children
-            }
-        }
-        else if (tokens[0] == "Constant"){
-            expressionTree->insertInCurrentNode(tokens[1]);
-            expressionTree->goUp();
-        }
-        else return false;
-    }
-
-    if (expressionTree->isEnded()) return true;
-    return false;
+    auto it = symbolTable.relationDataTypes.find(relation);
+    return it == symbolTable.relationDataTypes.end() ? noDataTypes : it->second;
 }
 
-bool isStatementValid(const std::vector<std::string> &statementTokens){
-    for (auto const &token : statementTokens){
-        auto tokens = split(token, ";");
-        if (tokens[0] == "Separator" && (tokens[1] == "(" || tokens[1] == ")")) continue;
-        if (tokens[0] == "Separator" && (tokens[1] != "=" && tokens[1] != "and")) return false;
-        else if (tokens[0] == "Separator" && tokens[1] == "or") return false;
-    }
+const std::vector<std::string> &getRelationAttributes(const std::string &relation) {
+    static const std::vector<std::string> noAttributes;
 
-    return true;
+    auto it = symbolTable.relationAttributes.find(relation);
+    return it == symbolTable.relationAttributes.end() ? noAttributes : it->second;
 }
 
-std::vector<std::string> getValidExpressions(const std::vector<std::string> &expressionTokens) {
-    std::vector<std::string> validExpressions;
-    std::stack<std::vector<std::string>> expressionStack;
-    std::vector<std::string> currentExpression;
-
-    bool insideString = false;
-    std::string currentToken;
-
-    for (const auto &token : expressionTokens) {
-        if (token == "Separator;(") {
-            if (!currentExpression.empty()) {
-                expressionStack.push(currentExpression);
-                currentExpression.clear();
-            }
-        }
-        else if (token == "Separator;)") {
-            if (!expressionStack.empty()) {
-                std::vector<std::string> parentExpression = expressionStack.top();
-                expressionStack.pop();
-
-                if (!currentExpression.empty()) {
-                    parentExpression.push_back(mergeTokens(currentExpression));
-                }
-                currentExpression = parentExpression;
-            }
-        }
-        else if (token == "Operator;or") {
-            if (!currentExpression.empty()) {
-                validExpressions.push_back(mergeTokens(currentExpression));
-                currentExpression.clear();
-            }
-        } else if (token == "Operator;and") {
-            if (!insideString && !currentExpression.empty()) {
-                validExpressions.push_back(mergeTokens(currentExpression));
-                currentExpression.clear();
-            }
-        } else {
-            if (token.front() == '"' && !insideString) {
-                insideString = true;
-                currentExpression.push_back(token);
-            }
-            else if (insideString) {
-                currentExpression.push_back(token);
-                if (token.back() == '"') {
-                    insideString = false;
-                }
-            }
-            else currentExpression.push_back(token);
-        }
-    }
-
-    if (!currentExpression.empty()) {
-        validExpressions.push_back(mergeTokens(currentExpression));
-    }
-
-    std::vector<std::string> finalExpressions;
-    for (const auto &expr : validExpressions) {
-        std::vector<std::string> orSplit = splitByOr(expr);
-        for (const auto &orPart : orSplit) {
-            std::vector<std::string> andSplit = splitByAnd(orPart);
-            if (andSplit.size() > 1) {
-                finalExpressions.push_back(join(andSplit, ","));
-            }
-            else finalExpressions.push_back(andSplit[0]);
-
-        }
-    }
-
-    return finalExpressions;
+bool schemaAlreadyExists(const std::string &schema) {
+    auto it = symbolTable.schemaCounts.find(schema);
+    return it != symbolTable.schemaCounts.end() && it->second >= 2;
 }
 
-std::string mergeTokens(const std::vector<std::string> &tokens) {
-    std::string merged;
-    for (const auto &token : tokens) {
-        merged += token.substr(token.find(';') + 1);
-    }
-    return merged;
+bool arrayAlreadyExists(const std::string &array){
+    auto it = symbolTable.arrayCounts.find(array);
+    return it != symbolTable.arrayCounts.end() && it->second >= 2;
 }
 
-std::vector<std::string> splitByOr(const std::string &expression) {
-    std::vector<std::string> splitExpressions;
-    std::string current;
-    std::stack<char> parenthesisStack;
-
-    for (size_t i = 0; i < expression.size(); ++i) {
-        char ch = expression[i];
-        if (ch == '(') {
-            parenthesisStack.push('(');
-            current += ch;
-        }
-        else if (ch == ')') {
-            current += ch;
-            if (!parenthesisStack.empty() && parenthesisStack.top() == '(') {
-                parenthesisStack.pop();
-            }
-        }
-        else if (expression.substr(i, 2) == "or" && parenthesisStack.empty()) {
-            splitExpressions.push_back(trim(current));
-            current.clear();
-            i++;
-        }
-        else current += ch;
-    }
-
-    if (!current.empty()) {
-        splitExpressions.push_back(trim(current));
-    }
-
-    return splitExpressions;
+bool schemaExists(const std::string &schema){
+    return isSchema(schema);
 }
 
-std::vector<std::string> splitByAnd(const std::string &expression) {
-    std::vector<std::string> result;
-    size_t start = 0;
-    size_t pos;
-
-    while ((pos = expression.find("and", start)) != std::string::npos) {
-        if (pos > 0 && expression[pos - 1] != '=' && expression[pos + 3] != '=') {
-            result.push_back(expression.substr(start, pos - start));
-            start = pos + 3;
-        } else {
-            start = pos + 3;
-        }
-    }
-
-    if (start < expression.size()) {
-        result.push_back(expression.substr(start));
-    }
-
-    return result;
-}
\ No newline at end of file
+bool relationExists(const std::string &relation) {
+    auto it = symbolTable.relationCounts.find(relation);
+    return it != symbolTable.relationCounts.end() && it->second >= 2;
+}
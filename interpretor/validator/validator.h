@@ -3,26 +3,76 @@
 #ifndef FQL_VALIDATOR_H
 #define FQL_VALIDATOR_H
 
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/**
+ * Symbols declared in the code: schemas, relations with their schema, attributes and data types,
+ * and arrays. It is built in a single pass, so every query below is a lookup.
+ */
+struct SymbolTable {
+    // Declared names in the order of their declaration, a name declared twice is kept twice.
+    std::vector<std::string> schemas;
+    std::vector<std::string> relations;
+    std::vector<std::string> arrays;
+
+    std::unordered_map<std::string, size_t> schemaCounts;
+    std::unordered_map<std::string, size_t> relationCounts;
+    std::unordered_map<std::string, size_t> arrayCounts;
+
+    // Schema of every relation, "NULL" when no schema was used before its declaration.
+    std::unordered_map<std::string, std::string> relationSchemas;
+    std::unordered_map<std::string, std::vector<std::string>> relationAttributes;
+    std::unordered_map<std::string, std::vector<std::string>> relationDataTypes;
+
+    // Schema of the last 'using', the relations declared after it belong to it.
+    std::string usedSchema = "NULL";
+};
+
+/**
+ * Builds the symbol table of the code in a single pass. It has to be built before the queries
+ * below are used, they all answer from the last built table.
+ * @param codeLines Lines of code (aka scanned tokens).
+ */
+void buildSymbolTable(const std::vector<std::string> &codeLines);
+
+/**
+ * Adds the symbols declared in more code to the last built symbol table, so code that is built
+ * in pieces, like the statements of a session, is validated against the declarations before it.
+ * @param codeLines Lines of code (aka scanned tokens).
+ */
+void extendSymbolTable(const std::vector<std::string> &codeLines);
+
+/**
+ * Gets the last built symbol table.
+ * @return Symbol table of the code.
+ */
+const SymbolTable &getSymbolTable();
+
 /**
- * Fetches all the schemas from the lines of code.
- * @param codeLines Lines of code to fetch the schemas from.
+ * Replaces the symbol table, to drop the symbols added by code that was not built or executed.
+ * @param table Symbol table to use.
+ */
+void setSymbolTable(SymbolTable table);
+
+/**
+ * Fetches all the schemas declared in the code.
  * @return Vector of strings containing all the schemas.
  */
-std::vector<std::string> getSchemas(const std::vector<std::string> &codeLines);
+const std::vector<std::string> &getSchemas();
 
 /**
- * Fetches all the relations from the lines of code.
- * @param codeLines Lines of code to fetch the relations from.
+ * Fetches all the relations declared in the code.
  * @return Vector of strings containing all the relations.
  */
-std::vector<std::string> getRelations(const std::vector<std::string> &codeLines);
+const std::vector<std::string> &getRelations();
 
 /**
- * Fetches all the arrays from the lines of code.
- * @param codeLines Lines of code to fetch the arrays from.
+ * Fetches all the arrays declared in the code.
  * @return Vector of strings containing all the arrays.
  */
-std::vector<std::string> getArrays(const std::vector<std::string> &codeLines);
+const std::vector<std::string> &getArrays();
 
 /**
  * Checks whether an attribute has been declared in a relation.
@@ -33,84 +83,74 @@ std::vector<std::string> getArrays(const std::vector<std::string> &codeLines);
 bool isAttribute(const std::string &attribute, const std::vector<std::string> &attributes);
 
 /**
- * Constructs a map with the relations as keys and the schema they belong to as the value,
+ * Gets a map with the relations as keys and the schema they belong to as the value,
  * or "NULL" in case the relation does not belong to any schema.
- * @param codeLines Lines of code to fetch from.
  * @return Map of strings containing relations as keys and the schema they belong to as values.
  */
-std::unordered_map<std::string, std::string> getRelationSchema(const std::vector<std::string> &codeLines);
+const std::unordered_map<std::string, std::string> &getRelationSchema();
 
 /**
  * Fetches all data types required for a relation.
  * @param relation Relation to fetch from.
- * @param codeLines Lines of code to fetch from.
  * @return Vector of strings containing the data types required for a relation.
  */
-std::vector<std::string> getRelationDataTypes(const std::string &relation, const std::vector<std::string> &codeLines);
+const std::vector<std::string> &getRelationDataTypes(const std::string &relation);
 
 /**
  * Fetches all attributes from a relation.
  * @param relation Relation to fetch from.
- * @param codeLines Lines of code to fetch from.
  * @return Vector of strings containing all the attribute names for a relation.
  */
-std::vector<std::string> getRelationAttributes(const std::string &relation, const std::vector<std::string> &codeLines);
+const std::vector<std::string> &getRelationAttributes(const std::string &relation);
 
 /**
  * Checks whether a schema exists when declaring it.
  * @param schema Schema to check.
- * @param codeLines Lines of code to check in.
  * @return True if the schema exists, false otherwise.
  */
-bool schemaAlreadyExists(const std::string &schema, const std::vector<std::string> &codeLines);
+bool schemaAlreadyExists(const std::string &schema);
 
 /**
  * Checks whether an array exists when declaring it.
  * @param array Array to check.
- * @param codeLines Lines of code to check in.
  * @return True if the schema exists, false otherwise.
  */
-bool arrayAlreadyExists(const std::string &array, const std::vector<std::string> &codeLines);
+bool arrayAlreadyExists(const std::string &array);
 
 /**
  * Checks whether a schema exists when using it before declaring relations.
  * @param schema Schema to check.
- * @param codeLines Lines of code to check in.
  * @return True if the schema exists and can be used, false otherwise.
  */
-bool schemaExists(const std::string &schema, const std::vector<std::string> &codeLines);
+bool schemaExists(const std::string &schema);
 
 /**
  * Checks whether a relation exists when declaring it.
  * @param relation Relation to check.
- * @param codeLines Lines of code to check in.
  * @return True if relation exists, false otherwise.
  */
-bool relationExists(const std::string &relation, const std::vector<std::string> &codeLines);
+bool relationExists(const std::string &relation);
 
 /**
  * Checks whether a given string is a schema.
  * @param schema String representing the schema.
- * @param codeLines Lines of code to check in.
  * @return True if the string is a schema, false otherwise.
  */
-bool isSchema(const std::string &schema, const std::vector<std::string> &codeLines);
+bool isSchema(const std::string &schema);
 
 /**
  * Checks whether a given string is a relation.
  * @param relation String representing the relation.
- * @param codeLines Lines of code to check in.
  * @return True if the string is a relation, false otherwise.
  */
-bool isRelation(const std::string &relation, const std::vector<std::string> &codeLines);
+bool isRelation(const std::string &relation);
 
 /**
  * Checks whether a given string is an array.
  * @param array String representing the array.
- * @param codeLines Lines of code to check in.
  * @return True if the string is an array, false otherwise.
  */
-bool isArray(const std::string &array, const std::vector<std::string> &codeLines);
+bool isArray(const std::string &array);
 
 /**
  * Checks whether a given string is a keyword.
@@ -140,6 +180,13 @@ bool isConstraint(const std::string &constraint);
  */
 bool isMethod(const std::string &method);
 
+/**
+ * Checks whether a given string is an aggregate function that can be fetched.
+ * @param function String representing the function.
+ * @return True if the string is an aggregate function, false otherwise.
+ */
+bool isAggregateFunction(const std::string &function);
+
 /**
  * Checks whether a given string is a data type that requires parameters.
  * @param dataType String representing the data type.
@@ -147,57 +194,4 @@ bool isMethod(const std::string &method);
  */
 bool isParameterDataType(const std::string &dataType);
 
-/**
- * Checks whether a given string is a valid operator.
- * @param op String representing the operator.
- * @return True if the string is an operator, false otherwise.
- */
-bool isOperator(const std::string &op);
-
-/**
- * Parses an expression passed inside a method.
- * @param expressionTokens Tokens representing the expression inside the method.
- * @param dataTypes Map which holds the datatype of all attributes of the relation
- * from which a method is called from.
- * @return True if the expression is valid, false otherwise.
- */
-bool isExpressionValid(const std::vector<std::string> &expressionTokens,
-                       const std::unordered_map<std::string, std::string> &dataTypes);
-
-/**
- * Parses a statement passed inside a method.
- * @param statementTokens Tokens representing the statement inside the method.
- * from which a method is called from.
- * @return True if the statement is valid, false otherwise.
- */
-bool isStatementValid(const std::vector<std::string> &statementTokens);
-
-/**
- * Gets valid expressions from a list of expression tokens.
- * @param expressionTokens Tokens representing the expression.
- * @return Vector of valid expressions.
- */
-std::vector<std::string> getValidExpressions(const std::vector<std::string> &expressionTokens);
-
-/**
- * Merges tokens into a single string.
- * @param tokens Vector of tokens to merge.
- * @return A string with all tokens merged.
- */
-std::string mergeTokens(const std::vector<std::string> &tokens);
-
-/**
- * Splits an expression by the 'AND' logical operator.
- * @param expression Expression to split.
- * @return Vector of expressions split by 'AND'.
- */
-std::vector<std::string> splitByAnd(const std::string &expression);
-
-/**
- * Splits an expression by the 'OR' logical operator.
- * @param expression Expression to split.
- * @return Vector of expressions split by 'OR'.
- */
-std::vector<std::string> splitByOr(const std::string &expression);
-
 #endif //FQL_VALIDATOR_H
@@ -1,17 +1,242 @@
 #include <string>
+#include <algorithm>
 #include <fstream>
 #include <vector>
+#include <array>
+#include <list>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
 #include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <filesystem>
 namespace fs = std::filesystem;
 
 #include "io.h"
+#include "../utils/metrics/metrics.h"
+#include "../utils/compression/compression.h"
+
+namespace {
+    uint64_t bytesRead = 0;
+    uint64_t bytesWritten = 0;
+
+    /**
+     * A compressed file starts with the magic, the amount of blocks and the compression level (4 bytes
+     * each), followed by an entry for every block and then the blocks. Integers are little endian.
+     */
+    const std::string compressedMagic = "FQLZBLK1";
+    const size_t compressedHeaderSize = 16;
+    const size_t compressedEntrySize = 24;
+
+    /**
+     * Entry of a block of a compressed file.
+     * offset Offset of the first line of the block in the decompressed file.
+     * position Position of the block in the compressed file.
+     * compressedSize Size of the block in the compressed file, equal to size when it is stored raw.
+     * size Size of the block once decompressed.
+     */
+    struct CompressedBlock {
+        uint64_t offset;
+        uint64_t position;
+        uint32_t compressedSize;
+        uint32_t size;
+    };
+
+    /**
+     * Block entries of a compressed file.
+     * version Inode, modification time and size of the file the entries were read from.
+     */
+    struct CompressedFile {
+        std::array<uint64_t, 3> version{};
+        std::vector<CompressedBlock> blocks;
+    };
+
+    std::unordered_map<std::string, CompressedFile> compressedFileMap;
+
+    // The block pool holds the last decompressed blocks, the most recently used first. A block is
+    // identified by the version of its file and its position, so a replaced file never hits old blocks.
+    using BlockKey = std::tuple<uint64_t, uint64_t, uint64_t, uint64_t>;
+    std::list<std::pair<BlockKey, std::shared_ptr<const std::string>>> pooledBlocks;
+    std::map<BlockKey, std::list<std::pair<BlockKey, std::shared_ptr<const std::string>>>::iterator> pooledBlockMap;
+
+    void writeInteger(std::string &output, uint64_t value, size_t bytes) {
+        for (size_t index = 0 ; index < bytes ; index++) output.push_back(static_cast<char>(value >> (8 * index) & 0xFF));
+    }
+
+    uint64_t readInteger(const char *data, size_t bytes) {
+        uint64_t value = 0;
+        for (size_t index = 0 ; index < bytes ; index++) value |= static_cast<uint64_t>(static_cast<uint8_t>(data[index])) << (8 * index);
+        return value;
+    }
+
+    /**
+     * Checks whether an open file starts with the compressed magic, then rewinds it.
+     */
+    bool peekCompressed(std::ifstream &fin) {
+        char magic[8];
+        fin.read(magic, sizeof(magic));
+        bool compressed = fin.gcount() == sizeof(magic) && std::string(magic, sizeof(magic)) == compressedMagic;
+        fin.clear();
+        fin.seekg(0);
+
+        return compressed;
+    }
+
+    /**
+     * Closes a file descriptor when it goes out of scope.
+     */
+    struct FileDescriptor {
+        int descriptor = -1;
+
+        ~FileDescriptor() {
+            if (descriptor != -1) close(descriptor);
+        }
+    };
+
+    void readExactly(int descriptor, char *data, size_t size, uint64_t position, const std::string &filePath) {
+        if (pread(descriptor, data, size, static_cast<off_t>(position)) != static_cast<ssize_t>(size)) {
+            throw std::runtime_error("Unable to read file: " + filePath);
+        }
+        bytesRead += size;
+    }
+
+    /**
+     * Opens a compressed file and gets its block entries, which are read again only when the file changed.
+     * @param filePath Path of the compressed file.
+     * @param file Descriptor of the opened file.
+     * @return Block entries of the file.
+     */
+    const CompressedFile &openCompressedFile(const std::string &filePath, FileDescriptor &file) {
+        countMetric(Metric::FileOpens);
+        file.descriptor = open(filePath.c_str(), O_RDONLY);
+        if (file.descriptor == -1) throw std::runtime_error("Unable to open file: " + filePath);
+        int descriptor = file.descriptor;
+
+        struct stat fileStat{};
+        fstat(descriptor, &fileStat);
+        std::array<uint64_t, 3> version{static_cast<uint64_t>(fileStat.st_ino),
+                                        static_cast<uint64_t>(fileStat.st_mtim.tv_sec) * 1000000000 + fileStat.st_mtim.tv_nsec,
+                                        static_cast<uint64_t>(fileStat.st_size)};
+
+        CompressedFile &compressedFile = compressedFileMap[filePath];
+        if (compressedFile.version == version) return compressedFile;
+
+        std::string header(compressedHeaderSize, '\0');
+        readExactly(descriptor, header.data(), header.size(), 0, filePath);
+        size_t blockCount = readInteger(header.data() + compressedMagic.size(), 4);
+
+        std::string entries(blockCount * compressedEntrySize, '\0');
+        readExactly(descriptor, entries.data(), entries.size(), compressedHeaderSize, filePath);
+
+        compressedFile.blocks.clear();
+        for (size_t index = 0 ; index < blockCount ; index++) {
+            const char *entry = entries.data() + index * compressedEntrySize;
+            compressedFile.blocks.push_back({readInteger(entry, 8), readInteger(entry + 8, 8),
+                                             static_cast<uint32_t>(readInteger(entry + 16, 4)),
+                                             static_cast<uint32_t>(readInteger(entry + 20, 4))});
+        }
+        compressedFile.version = version;
+
+        return compressedFile;
+    }
+
+    /**
+     * Gets a decompressed block of a compressed file from the block pool, reading it on a miss.
+     */
+    std::shared_ptr<const std::string> readBlock(const std::array<uint64_t, 3> &version, const CompressedBlock &block,
+                                                 int descriptor, const std::string &filePath) {
+        BlockKey key{version[0], version[1], version[2], block.position};
+
+        auto pooledIt = pooledBlockMap.find(key);
+        if (pooledIt != pooledBlockMap.end()) {
+            countMetric(Metric::BlockPoolHits);
+            pooledBlocks.splice(pooledBlocks.begin(), pooledBlocks, pooledIt->second);
+            return pooledIt->second->second;
+        }
+        countMetric(Metric::BlockPoolMisses);
+
+        std::string stored(block.compressedSize, '\0');
+        readExactly(descriptor, stored.data(), stored.size(), block.position, filePath);
+        auto data = std::make_shared<const std::string>(block.compressedSize == block.size ? std::move(stored)
+                                                        : decompressBlock(stored, block.size));
+
+        pooledBlocks.emplace_front(key, data);
+        pooledBlockMap[key] = pooledBlocks.begin();
+        if (pooledBlocks.size() > blockPoolBlocks) {
+            pooledBlockMap.erase(pooledBlocks.back().first);
+            pooledBlocks.pop_back();
+        }
+
+        return data;
+    }
+
+    void forEachCompressedLine(const std::string &filePath, const std::function<void(uint64_t, const std::string&)> &visit) {
+        FileDescriptor descriptor;
+        const CompressedFile &file = openCompressedFile(filePath, descriptor);
+
+        // The entries are copied, visit may read the file again and replace them.
+        CompressedFile copy = file;
+        std::string line;
+        for (const auto &block : copy.blocks) {
+            std::shared_ptr<const std::string> data = readBlock(copy.version, block, descriptor.descriptor, filePath);
+
+            size_t start = 0;
+            while (start < data->size()) {
+                size_t end = data->find('\n', start);
+                if (end == std::string::npos) end = data->size();
+                line.assign(*data, start, end - start);
+                visit(block.offset + start, line);
+                start = end + 1;
+            }
+        }
+    }
+
+    std::vector<std::string> readCompressedLinesAt(const std::string &filePath, const std::vector<uint64_t> &offsets) {
+        FileDescriptor descriptor;
+        const CompressedFile &file = openCompressedFile(filePath, descriptor);
+
+        std::vector<std::string> lines;
+        lines.reserve(offsets.size());
+        for (uint64_t offset : offsets) {
+            // Blocks hold whole lines, so the line is in the last block starting at or before its offset.
+            auto blockIt = std::upper_bound(file.blocks.begin(), file.blocks.end(), offset,
+                                            [](uint64_t value, const CompressedBlock &block) { return value < block.offset; });
+            if (blockIt == file.blocks.begin() || offset >= (blockIt - 1)->offset + (blockIt - 1)->size) {
+                lines.emplace_back();
+                continue;
+            }
+
+            --blockIt;
+            std::shared_ptr<const std::string> data = readBlock(file.version, *blockIt, descriptor.descriptor, filePath);
+            size_t start = offset - blockIt->offset;
+            size_t end = data->find('\n', start);
+            lines.emplace_back(*data, start, end == std::string::npos ? std::string::npos : end - start);
+        }
+
+        return lines;
+    }
+
+    /**
+     * Replaces a file with a temporary file written next to it. The temporary file is synced before the
+     * rename and the directory after it, so after a crash the file holds either its old or its new lines.
+     */
+    void replaceFile(const std::string &temporaryPath, const std::string &filePath) {
+        syncFile(temporaryPath);
+        fs::rename(temporaryPath, filePath);
+
+        fs::path directory = fs::path(filePath).parent_path();
+        syncFile(directory.empty() ? "." : directory.string());
+    }
+}
 
 bool validFile(const std::string &filePath){
     if (filePath.empty()){
         throw std::runtime_error("File path " + filePath + " was not provided!");
     }
 
+    countMetric(Metric::FileOpens);
     std::ifstream fin(filePath);
     return fin.good();
 }
@@ -36,11 +261,18 @@ std::vector<std::string> readLines(const std::string &filePath){
         throw std::runtime_error("File path " + filePath + " does not exist!");
     }
 
+    countMetric(Metric::FileOpens);
     std::ifstream fin(filePath);
     std::vector<std::string> lines;
+    if (peekCompressed(fin)) {
+        fin.close();
+        forEachCompressedLine(filePath, [&](uint64_t, const std::string &line) { lines.push_back(line); });
+        return lines;
+    }
 
     std::string line;
     while (getline(fin, line)){
+        bytesRead += line.size() + 1;
         lines.push_back(line);
     }
     fin.close();
@@ -57,12 +289,77 @@ void writeLines(const std::string &filePath, const std::vector<std::string> &lin
         throw std::runtime_error("File path " + filePath + " does not exist!");
     }
 
-    std::ofstream fout(filePath);
+    std::string temporaryPath = filePath + "." + std::to_string(getpid()) + ".tmp";
+    countMetric(Metric::FileOpens);
+    std::ofstream fout(temporaryPath);
+    if (!fout.is_open()) throw std::runtime_error("Unable to open file: " + temporaryPath);
 
     for (const auto& line : lines){
-        fout << line << std::endl;
+        fout << line << '\n';
+        bytesWritten += line.size() + 1;
     }
     fout.close();
+
+    replaceFile(temporaryPath, filePath);
+}
+
+void writeCompressedLines(const std::string &filePath, const std::vector<std::string> &lines, int level){
+    if (!validFile(filePath)){
+        throw std::runtime_error("File path " + filePath + " does not exist!");
+    }
+
+    std::vector<CompressedBlock> blocks;
+    std::string body;
+    std::string block;
+    uint64_t offset = 0;
+    auto flushBlock = [&]() {
+        if (block.empty()) return;
+
+        // A block that does not shrink is stored raw, its compressed size is then its size.
+        std::string compressed = compressBlock(block, level);
+        const std::string &stored = compressed.size() < block.size() ? compressed : block;
+        blocks.push_back({offset, body.size(), static_cast<uint32_t>(stored.size()), static_cast<uint32_t>(block.size())});
+        body += stored;
+        offset += block.size();
+        block.clear();
+    };
+
+    // Blocks hold whole lines, so a line is always read from a single block.
+    for (const auto &line : lines){
+        block += line;
+        block += '\n';
+        if (block.size() >= compressedBlockSize) flushBlock();
+    }
+    flushBlock();
+
+    std::string header = compressedMagic;
+    writeInteger(header, blocks.size(), 4);
+    writeInteger(header, level, 4);
+    uint64_t bodyPosition = compressedHeaderSize + blocks.size() * compressedEntrySize;
+    for (const auto &entry : blocks){
+        writeInteger(header, entry.offset, 8);
+        writeInteger(header, bodyPosition + entry.position, 8);
+        writeInteger(header, entry.compressedSize, 4);
+        writeInteger(header, entry.size, 4);
+    }
+
+    std::string temporaryPath = filePath + "." + std::to_string(getpid()) + ".tmp";
+    countMetric(Metric::FileOpens);
+    std::ofstream fout(temporaryPath, std::ios::binary);
+    if (!fout.is_open()) throw std::runtime_error("Unable to open file: " + temporaryPath);
+
+    fout.write(header.data(), static_cast<std::streamsize>(header.size()));
+    fout.write(body.data(), static_cast<std::streamsize>(body.size()));
+    fout.close();
+    bytesWritten += header.size() + body.size();
+
+    replaceFile(temporaryPath, filePath);
+}
+
+bool isCompressedFile(const std::string &filePath){
+    countMetric(Metric::FileOpens);
+    std::ifstream fin(filePath, std::ios::binary);
+    return fin.is_open() && peekCompressed(fin);
 }
 
 void createFile(const std::string &filePath){
@@ -70,6 +367,7 @@ void createFile(const std::string &filePath){
         throw std::runtime_error("File path " + filePath + " was not provided!");
     }
 
+    countMetric(Metric::FileOpens);
     std::ofstream fout;
     fout.open(filePath);
     fout.close();
@@ -109,11 +407,13 @@ void deleteDirectory(const char *dirPath) {
 void writeLine(const std::string &filePath, const std::string &line) {
     if (filePath.empty()) throw std::runtime_error("File path is empty. Cannot append line.");
 
+    countMetric(Metric::FileOpens);
     std::ofstream fout(filePath, std::ios::app);
     if (!fout.is_open()) throw std::runtime_error("Unable to open file: " + filePath);
 
     fout << line << std::endl;
     fout.close();
+    bytesWritten += line.size() + 1;
 }
 
 void deleteLine(const std::string &filePath, const std::string &line){
@@ -137,11 +437,13 @@ std::string getLine(const std::string &filePath, int index){
         throw std::runtime_error("File path " + filePath + " does not exist!");
     }
 
+    countMetric(Metric::FileOpens);
     std::ifstream fin(filePath);
     std::vector<std::string> lines;
 
     std::string line;
     while (getline(fin, line)){
+        bytesRead += line.size() + 1;
         lines.push_back(line);
     }
     fin.close();
@@ -151,4 +453,136 @@ std::string getLine(const std::string &filePath, int index){
     }
 
     return lines[index];
-}
\ No newline at end of file
+}
+
+void forEachLine(const std::string &filePath, const std::function<void(uint64_t, const std::string&)> &visit){
+    if (!validFile(filePath)){
+        throw std::runtime_error("File path " + filePath + " does not exist!");
+    }
+
+    countMetric(Metric::FileOpens);
+    std::ifstream fin(filePath);
+    if (peekCompressed(fin)) {
+        fin.close();
+        forEachCompressedLine(filePath, visit);
+        return;
+    }
+    uint64_t offset = 0;
+
+    std::string line;
+    while (getline(fin, line)){
+        visit(offset, line);
+        offset += line.size() + 1;
+    }
+    fin.close();
+    bytesRead += offset;
+}
+
+std::string readLineAt(const std::string &filePath, uint64_t offset){
+    countMetric(Metric::FileOpens);
+    std::ifstream fin(filePath);
+    if (!fin.is_open()) throw std::runtime_error("Unable to open file: " + filePath);
+    if (peekCompressed(fin)) {
+        fin.close();
+        return readCompressedLinesAt(filePath, {offset})[0];
+    }
+
+    fin.seekg(static_cast<std::streamoff>(offset));
+    std::string line;
+    getline(fin, line);
+    fin.close();
+    bytesRead += line.size() + 1;
+
+    return line;
+}
+
+std::vector<std::string> readLinesAt(const std::string &filePath, const std::vector<uint64_t> &offsets){
+    std::vector<std::string> lines;
+    if (offsets.empty()) return lines;
+
+    countMetric(Metric::FileOpens);
+    std::ifstream fin(filePath);
+    if (!fin.is_open()) throw std::runtime_error("Unable to open file: " + filePath);
+    if (peekCompressed(fin)) {
+        fin.close();
+        return readCompressedLinesAt(filePath, offsets);
+    }
+
+    lines.reserve(offsets.size());
+    for (uint64_t offset : offsets) {
+        fin.seekg(static_cast<std::streamoff>(offset));
+        std::string line;
+        getline(fin, line);
+        bytesRead += line.size() + 1;
+        lines.push_back(std::move(line));
+    }
+    fin.close();
+
+    return lines;
+}
+
+bool isFreeLine(const std::string &line){
+    return line.empty() || line[0] == '#';
+}
+
+std::vector<std::string> readRelationLines(const std::string &filePath){
+    std::vector<std::string> lines = readLines(filePath);
+
+    // The header is kept even though it is the first line, only the rows after it can be free space.
+    if (lines.size() > 1) lines.erase(std::remove_if(lines.begin() + 1, lines.end(), isFreeLine), lines.end());
+    return lines;
+}
+
+void appendLines(const std::string &filePath, const std::vector<std::string> &lines){
+    if (lines.empty()) return;
+
+    countMetric(Metric::FileOpens);
+    std::ofstream fout(filePath, std::ios::app);
+    if (!fout.is_open()) throw std::runtime_error("Unable to open file: " + filePath);
+
+    for (const auto &line : lines){
+        fout << line << '\n';
+        bytesWritten += line.size() + 1;
+    }
+    fout.close();
+}
+
+void syncFile(const std::string &filePath){
+    countMetric(Metric::FileOpens);
+    int descriptor = open(filePath.c_str(), O_RDONLY);
+    if (descriptor == -1) throw std::runtime_error("Unable to open file: " + filePath);
+
+    int result = fsync(descriptor);
+    close(descriptor);
+    if (result == -1) throw std::runtime_error("Unable to sync file: " + filePath);
+}
+
+uint64_t getFileId(const std::string &filePath){
+    struct stat fileStat{};
+    if (stat(filePath.c_str(), &fileStat) != 0) return 0;
+
+    return fileStat.st_ino;
+}
+
+uint64_t getFileSize(const std::string &filePath){
+    std::error_code error;
+    uint64_t size = fs::file_size(filePath, error);
+
+    return error ? 0 : size;
+}
+
+void recordBytesRead(uint64_t bytes){
+    bytesRead += bytes;
+}
+
+void recordBytesWritten(uint64_t bytes){
+    bytesWritten += bytes;
+}
+
+uint64_t getBytesRead(){
+    return bytesRead;
+}
+
+uint64_t getBytesWritten(){
+    return bytesWritten;
+}
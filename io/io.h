@@ -1,6 +1,22 @@
 #ifndef FQL_IO_H
 #define FQL_IO_H
 
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Size a block of a compressed file grows to before it is compressed, it ends at the first line end
+ * past it, so it only holds whole lines.
+ */
+const size_t compressedBlockSize = 64 * 1024;
+
+/**
+ * Amount of decompressed blocks kept in the block pool, shared by all the compressed files read.
+ */
+const size_t blockPoolBlocks = 256;
+
 /**
  * Checks if a file is valid to open.
  * @param filePath Path of the file.
@@ -16,19 +32,39 @@ bool validFile(const std::string &filePath);
 bool validDirectory(const std::string &dirPath);
 
 /**
- * Reads all the lines from a file.
+ * Reads all the lines from a file. This and the other functions reading lines read a compressed file
+ * (see writeCompressedLines) as if it was not compressed.
  * @param filePath Path of the file.
  * @return Vector of strings containing all the read lines.
  */
 std::vector<std::string> readLines(const std::string &filePath);
 
 /**
- * Writes a vector of strings to a file.
+ * Writes a vector of strings to a file. The lines are written to a temporary file that then replaces
+ * the file, so a reader sees either the old or the new content, never a partially written one. The new
+ * content is synced to the disk before the file is replaced.
  * @param filePath Path of the file.
  * @param lines Vector of strings to write.
  */
 void writeLines(const std::string &filePath, const std::vector<std::string> &lines);
 
+/**
+ * Writes a vector of strings to a file as compressed blocks of lines, replacing the file like writeLines
+ * does. The offset of a line is the same as in a file written by writeLines, readLineAt decompresses only
+ * the block holding the line, through the block pool.
+ * @param filePath Path of the file.
+ * @param lines Vector of strings to write.
+ * @param level Compression level, between 1 and maxCompressionLevel.
+ */
+void writeCompressedLines(const std::string &filePath, const std::vector<std::string> &lines, int level);
+
+/**
+ * Checks if a file was written by writeCompressedLines.
+ * @param filePath Path of the file.
+ * @return True if the file is compressed, false otherwise or if it does not exist.
+ */
+bool isCompressedFile(const std::string &filePath);
+
 /**
  * Creates a file with a given path.
  * @param filePath Path of the new file.
@@ -75,4 +111,94 @@ void deleteLine(const std::string &filePath, const std::string &line);
  */
 std::string getLine(const std::string &filePath, int index);
 
+/**
+ * Reads all the lines from a file together with the byte offset each line starts at.
+ * @param filePath Path of the file.
+ * @param visit Called with the offset and the content of every line.
+ */
+void forEachLine(const std::string &filePath, const std::function<void(uint64_t, const std::string&)> &visit);
+
+/**
+ * Reads the line starting at a given byte offset, without reading the lines before it.
+ * @param filePath Path of the file.
+ * @param offset Byte offset the line starts at.
+ * @return String representing the line.
+ */
+std::string readLineAt(const std::string &filePath, uint64_t offset);
+
+/**
+ * Reads the lines starting at several byte offsets, opening the file only once.
+ * @param filePath Path of the file.
+ * @param offsets Byte offsets the lines start at, in ascending order to read the file forward.
+ * @return The lines, in the order of the offsets.
+ */
+std::vector<std::string> readLinesAt(const std::string &filePath, const std::vector<uint64_t> &offsets);
+
+/**
+ * Checks if a line of a relation file is free space rather than a row. Rows always start with
+ * their RID, so free space is an empty line or a line starting with '#'.
+ * @param line Line to check.
+ * @return True if the line holds no row, false otherwise.
+ */
+bool isFreeLine(const std::string &line);
+
+/**
+ * Reads the header and the rows of a relation file, skipping the free space between the rows.
+ * @param filePath Path of the relation file.
+ * @return Vector of strings containing the header followed by the rows.
+ */
+std::vector<std::string> readRelationLines(const std::string &filePath);
+
+/**
+ * Appends several lines to a file, opening it only once.
+ * @param filePath Path of the file.
+ * @param lines Lines to append.
+ */
+void appendLines(const std::string &filePath, const std::vector<std::string> &lines);
+
+/**
+ * Flushes the content of a file from the page cache to the disk. A directory is synced the same way,
+ * which makes the files renamed into it durable.
+ * @param filePath Path of the file or the directory.
+ */
+void syncFile(const std::string &filePath);
+
+/**
+ * Gets an id of a file that changes when the file is replaced, like writeLines does.
+ * @param filePath Path of the file.
+ * @return Inode number of the file, 0 if the file does not exist.
+ */
+uint64_t getFileId(const std::string &filePath);
+
+/**
+ * Gets the size of a file.
+ * @param filePath Path of the file.
+ * @return Size of the file in bytes, 0 if the file does not exist.
+ */
+uint64_t getFileSize(const std::string &filePath);
+
+/**
+ * Counts bytes read from files without the functions of this module, like the sort runs do.
+ * @param bytes Amount of bytes read.
+ */
+void recordBytesRead(uint64_t bytes);
+
+/**
+ * Counts bytes written to files without the functions of this module.
+ * @param bytes Amount of bytes written.
+ */
+void recordBytesWritten(uint64_t bytes);
+
+/**
+ * Gets the amount of bytes read from files since the start of the process.
+ * @return Amount of bytes read.
+ */
+uint64_t getBytesRead();
+
+/**
+ * Gets the amount of bytes written to files since the start of the process.
+ * @return Amount of bytes written.
+ */
+uint64_t getBytesWritten();
+
 #endif //FQL_IO_H
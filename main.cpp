@@ -1,41 +1,120 @@
 #include <vector>
 #include <iostream>
 #include <cstdio>
+#include <fstream>
+#include <iterator>
 
 #include "./domain/relation/Relation.h"
 #include "./interpretor/parser/parser.h"
 #include "./interpretor/scanner/scanner.h"
 #include "./interpretor/executor/executor.h"
+#include "./interpretor/builder/builder.h"
+#include "./interpretor/explain/explain.h"
+#include "./interpretor/session/session.h"
+#include "./interpretor/cache/cache.h"
+#include "./utils/metrics/metrics.h"
 #include "./utils/algorithms/algorithms.h"
 
+/**
+ * Builds the code and hands the build lines to the executor in memory.
+ * @param codeFile Path of the code file.
+ * @param buildFile Path of the build file the build lines are also saved in, empty to save none.
+ * @return Exit code of FQL.
+ */
+int buildAndExecute(const std::string &codeFile, const std::string &buildFile) {
+    std::unordered_set<std::string> scannedFiles;
+    std::vector<std::string> buildLines;
+    if (!buildCode(scanCode(codeFile, scannedFiles), buildLines)) return 1;
+
+    if (!buildFile.empty()) buildExecutable(buildLines, buildFile);
+    executeCode(buildLines);
+    return 0;
+}
+
 int main(int argc, char **argv) {
-    if (argc < 3){
+    if (argc < 3 && !(argc == 2 && strcmp(argv[1], "repl") == 0)){
         std::cerr << "Too few arguments were provided!\n";
         std::cerr << "Try running:\n";
-        std::cerr << "1. <exec> run <buildFile>\n";
-        std::cerr << "2. <exec> build <codeFile> <buildFile>\n";
+        std::cerr << "1. <exec> run <buildFile> [--explain]\n";
+        std::cerr << "2. <exec> run <codeFile> <buildFile> [--explain]\n";
+        std::cerr << "3. <exec> exec <codeFile> [--explain]\n";
+        std::cerr << "4. <exec> build <codeFile> <buildFile>\n";
+        std::cerr << "5. <exec> repl\n";
+        std::cerr << "6. <exec> serve <socketPath>\n";
+        std::cerr << "7. <exec> client <socketPath> [codeFile]\n";
 
         return 1;
     }
 
-    if (strcmp(argv[1], "run") == 0){
-        executeCode(argv[2]);
-    }
-    else if (strcmp(argv[1], "build") == 0){
-        std::unordered_set<std::string> scannedFiles;
-        std::vector<std::string> scannedTokens = scanCode(argv[2], scannedFiles);
-        parseCode(scannedTokens, argv[3]);
-    }
-    else {
-        fprintf(stderr, "%s is not a valid operation!\n", argv[1]);
-        std::cerr << "Try running:\n";
-        std::cerr << "1. <exec> run <buildFile>\n";
-        std::cerr << "2. <exec> build <codeFile> <buildFile>\n";
+    // Code given on the command line is built through the build cache.
+    setBuildCache(true);
 
+    // A failed execution is rolled back, so it can be run again, like one stopped by a write conflict.
+    try {
+        if (strcmp(argv[1], "run") == 0){
+            if (strcmp(argv[argc - 1], "--explain") == 0) setExplainAll(true);
+
+            // With a second file, the first one is the code, which is built and executed without reading the build file back.
+            if (argc > 3 && strcmp(argv[3], "--explain") != 0) {
+                int exitCode = buildAndExecute(argv[2], argv[3]);
+                if (exitCode != 0) return exitCode;
+            }
+            else executeCode(argv[2]);
+        }
+        else if (strcmp(argv[1], "exec") == 0){
+            if (strcmp(argv[argc - 1], "--explain") == 0) setExplainAll(true);
+
+            int exitCode = buildAndExecute(argv[2], "");
+            if (exitCode != 0) return exitCode;
+        }
+        else if (strcmp(argv[1], "build") == 0){
+            std::unordered_set<std::string> scannedFiles;
+            std::vector<std::string> scannedTokens = scanCode(argv[2], scannedFiles);
+            parseCode(scannedTokens, argv[3]);
+        }
+        else if (strcmp(argv[1], "repl") == 0){
+            runInteractiveSession();
+        }
+        else if (strcmp(argv[1], "serve") == 0){
+            runSessionServer(argv[2]);
+        }
+        else if (strcmp(argv[1], "client") == 0){
+            // The code is read from the file when one is given, from the standard input otherwise.
+            std::ifstream fin;
+            if (argc > 3) {
+                fin.open(argv[3]);
+                if (!fin.is_open()) {
+                    fprintf(stderr, "Unable to open file: %s\n", argv[3]);
+                    return 1;
+                }
+            }
+            std::istream &input = argc > 3 ? fin : std::cin;
+            std::string code((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+            std::cout << sendSessionRequest(argv[2], code);
+        }
+        else {
+            fprintf(stderr, "%s is not a valid operation!\n", argv[1]);
+            std::cerr << "Try running:\n";
+            std::cerr << "1. <exec> run <buildFile> [--explain]\n";
+            std::cerr << "2. <exec> run <codeFile> <buildFile> [--explain]\n";
+            std::cerr << "3. <exec> exec <codeFile> [--explain]\n";
+            std::cerr << "4. <exec> build <codeFile> <buildFile>\n";
+            std::cerr << "5. <exec> repl\n";
+            std::cerr << "6. <exec> serve <socketPath>\n";
+            std::cerr << "7. <exec> client <socketPath> [codeFile]\n";
+
+            return 1;
+        }
+    }
+    catch (const std::exception &exception) {
+        std::cerr << "Runtime error: " << exception.what() << std::endl;
+        exportMetrics();
         return 1;
     }
+
+    // Only written when FQL is built with FQL_METRICS.
+    exportMetrics();
 }
 
-//TODO fix 'and' and 'or' operators within strings not being correctly parsed
 //TODO allow array declaration to start with a constant
 //TODO switch the executor for finding the page size for different operating systems.
\ No newline at end of file
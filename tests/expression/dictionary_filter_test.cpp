@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+/**
+ * Checks where clauses on a dictionary encoded attribute whose values are made of digits, like the
+ * codes of the dictionary. The relation gets enough rows for analyze to encode the attribute, then
+ * it is filtered by aggregates, which decode the values they look at, and by fetches, updates and deletes.
+ * The test runs in a temporary directory, which is removed at the end.
+ * Usage: dictionary_filter_test <FQL executable>
+ */
+
+static const std::string header = R"(schema: School
+using: School
+relation: Person
+Person -> {
+    ID, int, PK
+    Surname, varchar(20), NOT NULL
+}
+)";
+
+static const std::string queries = R"(let aggregates = Person.fetch(count(), max(Surname), min(Surname)) where {
+    Surname == "2"
+}
+show: aggregates
+let greater = Person.fetch(count(), max(Surname)) where {
+    Surname > "1"
+}
+show: greater
+let first = Person.fetch(Surname) where {
+    Surname == "2" and ID < 10
+}
+show: first
+Person.update() where {
+    Surname == "1"
+} set {
+    Surname = "7"
+}
+Person.delete() where {
+    Surname == "0"
+}
+let rest = Person.fetch(Surname, count()) group by {
+    Surname
+}
+show: rest
+)";
+
+/**
+ * Runs FQL on a code file.
+ * @return The vectors it shows, in order, or an empty list when it fails.
+ */
+static std::vector<std::string> runCode(const std::string &executable, const std::string &codeFile) {
+    std::string command = "\"" + executable + "\" exec " + codeFile + " 2>&1";
+    FILE *pipe = popen(command.c_str(), "r");
+    if (pipe == nullptr) return {};
+
+    std::vector<std::string> vectors;
+    std::string output;
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) output += buffer;
+    if (pclose(pipe) != 0) {
+        std::cerr << output;
+        return {};
+    }
+
+    size_t position = 0;
+    while ((position = output.find("Vector: ", position)) != std::string::npos) {
+        position += 8;
+        vectors.push_back(output.substr(position, output.find('\n', position) - position));
+    }
+    return vectors;
+}
+
+static bool check(bool condition, const std::string &message) {
+    if (!condition) std::cerr << "dictionary_filter_test: " << message << std::endl;
+    return condition;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: dictionary_filter_test <FQL executable>" << std::endl;
+        return 1;
+    }
+    std::string executable = std::filesystem::absolute(argv[1]).string();
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() /
+                                      ("fql_dictionary_filter_test_" + std::to_string(getpid()));
+    std::filesystem::create_directories(directory / "DB");
+    std::filesystem::current_path(directory);
+
+    // The surnames cycle through "2", "0" and "1", which are also the codes analyze gives them.
+    std::ofstream setup("setup.fql");
+    setup << header;
+    for (int row = 0 ; row < 300 ; row++) setup << "Person.add(" << row + 1 << ", " << "201"[row % 3] << ")\n";
+    setup << "Person.analyze()\n";
+    setup.close();
+    std::ofstream("queries.fql") << header << queries;
+
+    bool passed = check(runCode(executable, "setup.fql").empty() && std::filesystem::exists("DB/School"),
+                        "the relation could not be set up");
+
+    std::vector<std::string> expected = {"[100]", "[2]", "[2]", "[100]", "[2]", "[2, 2, 2]", "[2, 7]", "[100, 100]"};
+    std::vector<std::string> names = {"count() where Surname == \"2\"", "max(Surname) where Surname == \"2\"",
+                                      "min(Surname) where Surname == \"2\"", "count() where Surname > \"1\"",
+                                      "max(Surname) where Surname > \"1\"", "Surname where Surname == \"2\" and ID < 10",
+                                      "the surnames left after the update and the delete", "the count of every surname left"};
+    std::vector<std::string> vectors = runCode(executable, "queries.fql");
+
+    passed &= check(vectors.size() == expected.size(), "expected " + std::to_string(expected.size()) +
+                    " vectors, got " + std::to_string(vectors.size()));
+    for (size_t index = 0 ; index < std::min(vectors.size(), expected.size()) ; index++) {
+        passed &= check(vectors[index] == expected[index],
+                        names[index] + " gave " + vectors[index] + " instead of " + expected[index]);
+    }
+
+    std::filesystem::current_path(directory.parent_path());
+    std::filesystem::remove_all(directory);
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+/**
+ * Checks that an ordering comparison never matches NULL. A relation with NULL grades is queried and
+ * deleted from with '<', '>=' and '<=' against a constant and against another attribute, where only
+ * the rows with a grade may match, while '==' still finds the NULL grades.
+ * The test runs in a temporary directory, which is removed at the end.
+ * Usage: null_comparison_test <FQL executable>
+ */
+
+static const std::string code = R"(schema: School
+using: School
+relation: Student
+Student -> {
+    ID, int, PK
+    name, varchar(20), NOT NULL
+    grade, int, NULLABLE
+}
+Student.add(1, James, NULL)
+Student.add(2, Mary, 9)
+Student.add(3, John, NULL)
+Student.add(4, Anna, 5)
+let low = Student.fetch(name) where {
+    grade < 8
+}
+show: low
+let high = Student.fetch(name) where {
+    grade >= 5
+}
+show: high
+let below = Student.fetch(name) where {
+    grade <= ID
+}
+show: below
+let missing = Student.fetch(name) where {
+    grade == NULL
+}
+show: missing
+Student.delete() where {
+    grade < 8
+}
+let rest = Student.fetch(name)
+show: rest
+)";
+
+/**
+ * Runs FQL on a code file.
+ * @return The vectors it shows, in order, or an empty list when it fails.
+ */
+static std::vector<std::string> runCode(const std::string &executable, const std::string &codeFile) {
+    std::string command = "\"" + executable + "\" exec " + codeFile + " 2>&1";
+    FILE *pipe = popen(command.c_str(), "r");
+    if (pipe == nullptr) return {};
+
+    std::vector<std::string> vectors;
+    std::string output;
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) output += buffer;
+    if (pclose(pipe) != 0) {
+        std::cerr << output;
+        return {};
+    }
+
+    size_t position = 0;
+    while ((position = output.find("Vector: ", position)) != std::string::npos) {
+        position += 8;
+        vectors.push_back(output.substr(position, output.find('\n', position) - position));
+    }
+    return vectors;
+}
+
+static bool check(bool condition, const std::string &message) {
+    if (!condition) std::cerr << "null_comparison_test: " << message << std::endl;
+    return condition;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: null_comparison_test <FQL executable>" << std::endl;
+        return 1;
+    }
+    std::string executable = std::filesystem::absolute(argv[1]).string();
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() /
+                                      ("fql_null_comparison_test_" + std::to_string(getpid()));
+    std::filesystem::create_directories(directory / "DB");
+    std::filesystem::current_path(directory);
+    std::ofstream("grades.fql") << code;
+
+    std::vector<std::string> expected = {"[Anna]", "[Mary, Anna]", "[]", "[James, John]", "[James, Mary, John]"};
+    std::vector<std::string> names = {"grade < 8", "grade >= 5", "grade <= ID", "grade == NULL",
+                                      "the rows left after deleting grade < 8"};
+    std::vector<std::string> vectors = runCode(executable, "grades.fql");
+
+    bool passed = check(vectors.size() == expected.size(), "expected " + std::to_string(expected.size()) +
+                        " vectors, got " + std::to_string(vectors.size()));
+    for (size_t index = 0 ; index < std::min(vectors.size(), expected.size()) ; index++) {
+        passed &= check(vectors[index] == expected[index],
+                        names[index] + " gave " + vectors[index] + " instead of " + expected[index]);
+    }
+
+    std::filesystem::current_path(directory.parent_path());
+    std::filesystem::remove_all(directory);
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "../../interpretor/operators/join/join.h"
+#include "../../domain/datatype/datatypes/integer/Integer.h"
+
+/**
+ * Checks the merge join against a nested loop join over the same rows. The inputs hold repeated keys
+ * and NULL keys, and are joined unsorted with a memory budget small enough to sort them in several runs,
+ * then already sorted with a header, like a PK range.
+ * The test runs in a temporary directory, which is removed at the end.
+ * Usage: join_test [seed]
+ */
+
+using Row = std::vector<std::string>;
+using Pair = std::pair<Row, Row>;
+
+/**
+ * Generates rows holding a key out of a few, NULL for some rows, and the position of the row.
+ * @param number Amount of rows to generate.
+ * @param name Name written in every row, to tell the inputs apart.
+ * @param generator Generator of the keys.
+ * @return The generated rows.
+ */
+static std::vector<Row> generateRows(size_t number, const std::string &name, std::mt19937 &generator) {
+    std::vector<Row> rows;
+    for (size_t index = 0 ; index < number ; index++) {
+        std::string key = generator() % 10 == 0 ? "NULL" : std::to_string(static_cast<int>(generator() % 40) - 10);
+        rows.push_back({key, name + std::to_string(index)});
+    }
+    return rows;
+}
+
+static void writeRows(const std::string &filePath, const std::vector<Row> &rows, bool hasHeader) {
+    std::ofstream fout(filePath);
+    if (hasHeader) fout << "key,name\n";
+    for (const auto &row : rows) fout << row[0] << "," << row[1] << "\n";
+}
+
+static std::vector<Pair> nestedLoopJoin(const std::vector<Row> &left, const std::vector<Row> &right) {
+    std::vector<Pair> pairs;
+    for (const auto &leftRow : left) {
+        for (const auto &rightRow : right) {
+            if (leftRow[0] == "NULL" || rightRow[0] == "NULL") continue;
+            if (std::stoi(leftRow[0]) == std::stoi(rightRow[0])) pairs.emplace_back(leftRow, rightRow);
+        }
+    }
+    return pairs;
+}
+
+static bool check(bool condition, const std::string &message) {
+    if (!condition) std::cerr << "join_test: " << message << std::endl;
+    return condition;
+}
+
+/**
+ * Runs the merge join and compares its pairs with the pairs of the nested loop join, in any order.
+ */
+static bool checkJoin(const std::string &name, const JoinInput &left, const JoinInput &right,
+                      std::vector<Pair> expected, size_t memoryBudget) {
+    std::vector<Pair> pairs;
+    size_t emitted = mergeJoin(left, right, [&](const Row &leftRow, const Row &rightRow) {
+        pairs.emplace_back(leftRow, rightRow);
+    }, memoryBudget);
+
+    std::sort(pairs.begin(), pairs.end());
+    std::sort(expected.begin(), expected.end());
+    bool passed = check(emitted == pairs.size(), name + ": returned " + std::to_string(emitted) + " but emitted " +
+                        std::to_string(pairs.size()) + " pairs");
+    passed &= check(pairs == expected, name + ": emitted " + std::to_string(pairs.size()) +
+                    " pairs, the nested loop join finds " + std::to_string(expected.size()));
+    return passed;
+}
+
+int main(int argc, char **argv) {
+    unsigned seed = argc > 1 ? std::stoul(argv[1]) : 42;
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() /
+                                      ("fql_join_test_" + std::to_string(getpid()));
+    std::filesystem::create_directories(directory);
+    std::filesystem::current_path(directory);
+
+    std::mt19937 generator(seed);
+    std::vector<Row> leftRows = generateRows(500, "L", generator);
+    std::vector<Row> rightRows = generateRows(300, "R", generator);
+    std::vector<Pair> expected = nestedLoopJoin(leftRows, rightRows);
+    Integer datatype;
+
+    writeRows("left", leftRows, false);
+    writeRows("right", rightRows, false);
+    bool passed = checkJoin("unsorted inputs", {"left", false, 0, &datatype, false},
+                            {"right", false, 0, &datatype, false}, expected, 1024);
+
+    // Sorted inputs are read as they are, after their header.
+    auto byKey = [&datatype](const Row &first, const Row &second) { return datatype.compare(first[0], second[0]) < 0; };
+    std::stable_sort(leftRows.begin(), leftRows.end(), byKey);
+    std::stable_sort(rightRows.begin(), rightRows.end(), byKey);
+    writeRows("left_sorted", leftRows, true);
+    writeRows("right_sorted", rightRows, true);
+    passed &= checkJoin("sorted inputs", {"left_sorted", true, 0, &datatype, true},
+                        {"right_sorted", true, 0, &datatype, true}, expected, defaultSortMemoryBudget);
+
+    std::filesystem::current_path(directory.parent_path());
+    std::filesystem::remove_all(directory);
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../../interpretor/transaction/transaction.h"
+
+/**
+ * Drives a write conflict between two FQL processes. The loser starts its transaction, then waits for
+ * the lock of a relation the test holds, while the winner commits an update of a row the loser updates
+ * next. The loser has to stop with a write conflict and a non-zero exit code instead of aborting, and
+ * has to succeed once it is run again.
+ * The test runs in a temporary directory, which is removed at the end.
+ * Usage: write_conflict_test <FQL executable>
+ */
+
+struct ProcessResult {
+    int exitCode;
+    std::string errors;
+};
+
+static std::vector<std::string> declareRelations() {
+    std::vector<std::string> lines = {"createSchema:Test"};
+    for (const std::string relation : {"Left", "Right"}) {
+        lines.insert(lines.end(), {"createRelation:Test," + relation, "createRelationAttributes:" + relation,
+                                   "createAttribute:ID,UUID,PK", "createAttribute:value,int,NOT NULL"});
+    }
+    return lines;
+}
+
+static std::vector<std::string> buildUpdate(const std::string &relation, const std::string &value) {
+    return {"updateRelation:" + relation, "where:(== ID \"1111111111111111\")", "set:(= value \"" + value + "\")"};
+}
+
+static void writeBuildFile(const std::string &filePath, const std::vector<std::vector<std::string>> &statements) {
+    std::ofstream fout(filePath);
+    for (const auto &line : declareRelations()) fout << line << '\n';
+    for (const auto &statement : statements) {
+        for (const auto &line : statement) fout << line << '\n';
+    }
+}
+
+/**
+ * Starts FQL on a build file, with its output discarded and its errors written to a file.
+ * @return Id of the started process.
+ */
+static pid_t startBuildFile(const std::string &executable, const std::string &buildFile) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        int output = open("/dev/null", O_WRONLY);
+        int errors = open((buildFile + ".err").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        dup2(output, STDOUT_FILENO);
+        dup2(errors, STDERR_FILENO);
+        execl(executable.c_str(), executable.c_str(), "run", buildFile.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    return pid;
+}
+
+static ProcessResult waitBuildFile(pid_t pid, const std::string &buildFile) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+
+    std::ifstream fin(buildFile + ".err");
+    std::stringstream errors;
+    errors << fin.rdbuf();
+
+    // A process killed by a signal, like the abort of an uncaught exception, gets a negative code.
+    return {WIFEXITED(status) ? WEXITSTATUS(status) : -WTERMSIG(status), errors.str()};
+}
+
+static bool check(bool condition, const std::string &message) {
+    if (!condition) std::cerr << "write_conflict_test: " << message << std::endl;
+    return condition;
+}
+
+static bool hasActiveTransaction() {
+    std::error_code error;
+    std::filesystem::directory_iterator entries(transactionDirectory + "/active", error);
+    return !error && entries != std::filesystem::directory_iterator();
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: write_conflict_test <FQL executable>" << std::endl;
+        return 1;
+    }
+    std::string executable = std::filesystem::absolute(argv[1]).string();
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() /
+                                      ("fql_write_conflict_test_" + std::to_string(getpid()));
+    std::filesystem::create_directories(directory / "DB");
+    std::filesystem::current_path(directory);
+
+    std::vector<std::vector<std::string>> rows;
+    for (const std::string relation : {"Left", "Right"}) {
+        rows.push_back({"addRelation:" + relation, "addArgument:1111111111111111", "addArgument:0"});
+    }
+    writeBuildFile("setup.fqlb", rows);
+    writeBuildFile("loser.fqlb", {buildUpdate("Left", "1"), buildUpdate("Right", "1")});
+    writeBuildFile("winner.fqlb", {buildUpdate("Right", "2")});
+
+    bool passed = check(waitBuildFile(startBuildFile(executable, "setup.fqlb"), "setup.fqlb").exitCode == 0,
+                        "the relations could not be set up");
+
+    // The loser takes its snapshot, then waits for Left while the winner commits its update of Right.
+    int lock = acquireFileLock("DB/Test/relations/Left");
+    pid_t loser = startBuildFile(executable, "loser.fqlb");
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!hasActiveTransaction() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    passed &= check(hasActiveTransaction(), "the loser did not start its transaction");
+
+    ProcessResult winner = waitBuildFile(startBuildFile(executable, "winner.fqlb"), "winner.fqlb");
+    passed &= check(winner.exitCode == 0, "the winner failed: " + winner.errors);
+    releaseFileLock(lock);
+
+    ProcessResult result = waitBuildFile(loser, "loser.fqlb");
+    passed &= check(result.exitCode == 1, "the loser exited with " + std::to_string(result.exitCode) + " instead of 1");
+    passed &= check(result.errors.find("Write conflict") != std::string::npos,
+                    "the loser did not report a write conflict: " + result.errors);
+
+    // The conflicting execution was rolled back, so it succeeds once it is run again.
+    result = waitBuildFile(startBuildFile(executable, "loser.fqlb"), "loser.fqlb");
+    passed &= check(result.exitCode == 0, "the loser failed when run again: " + result.errors);
+
+    std::filesystem::current_path(directory.parent_path());
+    std::filesystem::remove_all(directory);
+
+    return passed ? 0 : 1;
+}
@@ -10,8 +10,7 @@ int offset = 10;
 unsigned long headerSize;
 unsigned long lineLength;
 
-void showRelation(const std::string &filePath, const std::string &relation){
-    std::vector<std::string> lines = readLines(filePath);
+size_t showRelation(const std::vector<std::string> &lines, const std::string &relation){
     std::vector<unsigned long> lengthVector = computeLengthVector(lines);
     std::vector<std::string> headers = split(lines[0], ",");
 
@@ -23,6 +22,8 @@ void showRelation(const std::string &filePath, const std::string &relation){
     showEmptyLine(lineLength, headerSize);
     showLines(lines);
     showEmptyLine(lineLength, headerSize);
+
+    return lines.size() - 1;
 }
 
 void showRelationName(const std::string &relationName, unsigned long length){
@@ -3,10 +3,11 @@
 
 /**
  * Displays a given vector of lines (in CSV format).
- * @param filePath Path of the file with the lines.
+ * @param lines Header of the relation followed by its rows.
  * @param relation Name of the relation.
+ * @return Amount of rows shown.
  */
-void showRelation(const std::string &filePath, const std::string &relation);
+size_t showRelation(const std::vector<std::string> &lines, const std::string &relation);
 
 /**
  * Displays the relation name in the middle of the header.
@@ -133,12 +133,12 @@ bool isBoolean(const std::string &b) {
 }
 
 bool isDate(const std::string &date) {
-    std::regex dateRegex(R"(^\d{4}-(0[1-9]|1[0-2])-(0[1-9]|[12]\d|3[01])$)");
+    static const std::regex dateRegex(R"(^\d{4}-(0[1-9]|1[0-2])-(0[1-9]|[12]\d|3[01])$)");
     return std::regex_match(date, dateRegex);
 }
 
 bool isDateTime(const std::string &datetime) {
-    std::regex datetimeRegex(R"(^\d{4}-(0[1-9]|1[0-2])-(0[1-9]|[12]\d|3[01]) (0[0-9]|1[0-9]|2[0-3]):([0-5]\d):([0-5]\d)$)");
+    static const std::regex datetimeRegex(R"(^\d{4}-(0[1-9]|1[0-2])-(0[1-9]|[12]\d|3[01]) (0[0-9]|1[0-9]|2[0-3]):([0-5]\d):([0-5]\d)$)");
     return std::regex_match(datetime, datetimeRegex);
 }
 
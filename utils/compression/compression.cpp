@@ -0,0 +1,174 @@
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+#include "compression.h"
+
+namespace {
+    const size_t minimumMatch = 4;
+    // The last bytes of a block are always literals and a match starts before the last 12 bytes, like in LZ4.
+    const size_t lastLiterals = 5;
+    const size_t matchStartLimit = 12;
+    const size_t maxOffset = 65535;
+    const int hashBits = 16;
+
+    uint32_t readSequence(const char *data) {
+        uint32_t sequence;
+        std::memcpy(&sequence, data, sizeof(sequence));
+        return sequence;
+    }
+
+    uint32_t hashSequence(uint32_t sequence) {
+        return (sequence * 2654435761U) >> (32 - hashBits);
+    }
+
+    /**
+     * Writes the part of a length that does not fit in its token: bytes of 255, ended by a byte below 255.
+     */
+    void writeLength(std::string &output, size_t length) {
+        while (length >= 255) {
+            output.push_back(static_cast<char>(255));
+            length -= 255;
+        }
+        output.push_back(static_cast<char>(length));
+    }
+
+    size_t readLength(std::string_view input, size_t &position) {
+        size_t length = 0;
+        uint8_t byte;
+        do {
+            if (position >= input.size()) throw std::runtime_error("Corrupted compressed block!");
+            byte = static_cast<uint8_t>(input[position++]);
+            length += byte;
+        } while (byte == 255);
+        return length;
+    }
+
+    /**
+     * Writes a sequence: its literals, then its match. The last sequence of a block has no match (matchLength 0).
+     */
+    void writeSequence(std::string &output, const char *literals, size_t literalLength, size_t offset, size_t matchLength) {
+        size_t literalCode = std::min<size_t>(literalLength, 15);
+        size_t matchCode = matchLength == 0 ? 0 : std::min<size_t>(matchLength - minimumMatch, 15);
+        output.push_back(static_cast<char>(literalCode << 4 | matchCode));
+
+        if (literalLength >= 15) writeLength(output, literalLength - 15);
+        output.append(literals, literalLength);
+        if (matchLength == 0) return;
+
+        output.push_back(static_cast<char>(offset & 0xFF));
+        output.push_back(static_cast<char>(offset >> 8));
+        if (matchLength - minimumMatch >= 15) writeLength(output, matchLength - minimumMatch - 15);
+    }
+}
+
+std::string compressBlock(std::string_view input, int level) {
+    const char *data = input.data();
+    const size_t size = input.size();
+
+    std::string output;
+    output.reserve(size + size / 255 + 16);
+    size_t anchor = 0;
+
+    if (size > matchStartLimit) {
+        level = std::clamp(level, 1, maxCompressionLevel);
+        const size_t attempts = static_cast<size_t>(1) << (level - 1);
+        const size_t matchEnd = size - lastLiterals;
+        const size_t searchEnd = size - matchStartLimit;
+
+        // Last position of every hashed 4 byte prefix and, above level 1, the previous position with the same hash.
+        std::vector<int32_t> heads(static_cast<size_t>(1) << hashBits, -1);
+        std::vector<int32_t> previous(level > 1 ? size : 0, -1);
+        auto insert = [&](size_t position) {
+            uint32_t hash = hashSequence(readSequence(data + position));
+            if (!previous.empty()) previous[position] = heads[hash];
+            heads[hash] = static_cast<int32_t>(position);
+        };
+
+        size_t position = 0;
+        size_t misses = 0;
+        while (position <= searchEnd) {
+            uint32_t sequence = readSequence(data + position);
+            size_t bestLength = 0;
+            size_t bestOffset = 0;
+
+            int32_t candidate = heads[hashSequence(sequence)];
+            for (size_t attempt = 0 ; attempt < attempts && candidate >= 0 && position - candidate <= maxOffset ; attempt++) {
+                if (readSequence(data + candidate) == sequence) {
+                    size_t length = minimumMatch;
+                    while (position + length < matchEnd && data[candidate + length] == data[position + length]) length++;
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestOffset = position - candidate;
+                    }
+                }
+                if (previous.empty()) break;
+                candidate = previous[candidate];
+            }
+            insert(position);
+
+            if (bestLength < minimumMatch) {
+                // At level 1 data that does not compress is skipped faster and faster, like in LZ4.
+                position += previous.empty() ? 1 + (misses++ >> 6) : 1;
+                continue;
+            }
+            misses = 0;
+
+            writeSequence(output, data + anchor, position - anchor, bestOffset, bestLength);
+            size_t matchStop = position + bestLength;
+            if (!previous.empty()) {
+                for (size_t inside = position + 1 ; inside < matchStop && inside <= searchEnd ; inside++) insert(inside);
+            }
+            position = matchStop;
+            anchor = matchStop;
+        }
+    }
+
+    writeSequence(output, data + anchor, size - anchor, 0, 0);
+    return output;
+}
+
+std::string decompressBlock(std::string_view input, size_t size) {
+    std::string output(size, '\0');
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < input.size()) {
+        auto token = static_cast<uint8_t>(input[in++]);
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15) literalLength += readLength(input, in);
+        if (literalLength > input.size() - in || literalLength > size - out) {
+            throw std::runtime_error("Corrupted compressed block!");
+        }
+        std::memcpy(output.data() + out, input.data() + in, literalLength);
+        in += literalLength;
+        out += literalLength;
+
+        // The last sequence only holds literals.
+        if (in == input.size()) break;
+
+        if (input.size() - in < 2) throw std::runtime_error("Corrupted compressed block!");
+        size_t offset = static_cast<uint8_t>(input[in]) | static_cast<size_t>(static_cast<uint8_t>(input[in + 1])) << 8;
+        in += 2;
+
+        size_t matchLength = (token & 0x0F) + minimumMatch;
+        if ((token & 0x0F) == 15) matchLength += readLength(input, in);
+        if (offset == 0 || offset > out || matchLength > size - out) {
+            throw std::runtime_error("Corrupted compressed block!");
+        }
+
+        // A match can overlap the bytes it writes (a run), so it is copied byte by byte.
+        char *destination = output.data() + out;
+        const char *source = destination - offset;
+        if (offset >= matchLength) std::memcpy(destination, source, matchLength);
+        else for (size_t index = 0 ; index < matchLength ; index++) destination[index] = source[index];
+        out += matchLength;
+    }
+
+    if (out != size) throw std::runtime_error("Corrupted compressed block!");
+    return output;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#ifndef FQL_COMPRESSION_H
+#define FQL_COMPRESSION_H
+
+#include <string>
+#include <string_view>
+
+/**
+ * Highest compression level, level 0 means no compression.
+ */
+const int maxCompressionLevel = 9;
+
+/**
+ * Compresses a block with an LZ77 codec in the LZ4 block format: every sequence is a token (the
+ * length of its literals and of its match), the literals, and the match as a 2 byte offset back into
+ * the decompressed data. Level 1 looks at a single earlier occurrence of every 4 byte prefix, every
+ * further level looks at twice as many, which finds longer matches at the cost of speed.
+ * @param input Bytes to compress.
+ * @param level Compression level, between 1 and maxCompressionLevel.
+ * @return Compressed bytes.
+ */
+std::string compressBlock(std::string_view input, int level);
+
+/**
+ * Decompresses a block written by compressBlock.
+ * @param input Compressed bytes.
+ * @param size Size of the block before it was compressed.
+ * @return Decompressed bytes.
+ * @throws std::runtime_error If the block is corrupted.
+ */
+std::string decompressBlock(std::string_view input, size_t size);
+
+#endif //FQL_COMPRESSION_H
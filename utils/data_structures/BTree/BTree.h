@@ -1,62 +1,114 @@
 #ifndef FQL_BTREE_H
 #define FQL_BTREE_H
 
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
 #include "BTreeNode.h"
 
 template <typename T>
 class BTree {
 private:
-    BTreeNode<T>* root;
     long degree;
+    SlabArena arena;
+    BTreeNode<T>* root;
+    size_t size;
 
     // Helper function to print the tree recursively
     void showNode(BTreeNode<T>* node) const;
 
+    template<typename Visit>
+    bool visitNode(const BTreeNode<T>* node, const T *low, const T *high, Visit &visit) const;
+
 public:
     BTree();
     explicit BTree(long _degree);
     ~BTree();
 
+    BTree(const BTree &) = delete;
+    BTree &operator=(const BTree &) = delete;
+
     void insert(const T& key);
     bool search(const T& key) const;
     void deleteTree(BTreeNode<T>* node);
 
+    /**
+     * Removes one occurrence of a key, rebalancing the nodes on the way down.
+     * @param key Key to remove.
+     * @return True if the key was in the tree, false otherwise.
+     */
+    bool remove(const T& key);
+
+    /**
+     * Removes one occurrence of every given key. Large batches are removed by rebuilding the
+     * tree from the remaining keys in a single in-order pass instead of one removal per key.
+     * @param keys Keys to remove.
+     * @return Amount of keys that were in the tree and were removed.
+     */
+    size_t removeBatch(std::vector<T> keys);
+
+    size_t getSize() const;
+
+    /**
+     * Gets the amount of memory reserved for the nodes of the tree.
+     * @return Size of the node arena in bytes.
+     */
+    size_t getReservedSize() const;
+
+    /**
+     * Visits all the keys in ascending order.
+     * @param visit Called with every key, returns false to stop the iteration.
+     */
+    template<typename Visit>
+    void forEach(Visit visit) const;
+
+    /**
+     * Visits the keys in [low, high] in ascending order, skipping the subtrees outside the range.
+     * @param low Lowest visited key.
+     * @param high Highest visited key.
+     * @param visit Called with every key in the range, returns false to stop the iteration.
+     */
+    template<typename Visit>
+    void forEachInRange(const T &low, const T &high, Visit visit) const;
+
+    /**
+     * Visits the keys in [low, high] in ascending order, a missing bound leaves that side of the range open.
+     * @param low Lowest visited key, nullptr to start at the first key.
+     * @param high Highest visited key, nullptr to go up to the last key.
+     * @param visit Called with every key in the range, returns false to stop the iteration.
+     */
+    template<typename Visit>
+    void forEachInRange(const T *low, const T *high, Visit visit) const;
+
     // New method to show all values in the B-tree
     void show() const;
 };
 
 template<typename T>
-BTree<T>::BTree() : root(nullptr), degree(100) {}
+BTree<T>::BTree() : BTree(100) {}
 
+// The minimum degree of a B-tree is 2, nodes then hold between 1 and 3 keys.
 template<typename T>
-BTree<T>::BTree(long _degree) : root(nullptr), degree(_degree) {}
+BTree<T>::BTree(long _degree) : degree(std::max(_degree, 2L)),
+                                arena(BTreeNode<T>::getBlockSize(static_cast<int>(std::max(_degree, 2L)))),
+                                root(nullptr), size(0) {}
 
 template<typename T>
 BTree<T>::~BTree() { deleteTree(root); }
 
 template<typename T>
 void BTree<T>::insert(const T &key) {
-    if (root == nullptr) {
-        root = new BTreeNode<T>(degree, true);
-        std::vector<T> rootKeys{key};
-        root->setKeys(rootKeys);
-    }
-    else{
-        if (root->getKeys().size() == 2 * degree - 1) {
-            auto* newRoot = new BTreeNode<T>(degree, false);
+    if (root == nullptr) root = BTreeNode<T>::create(arena, static_cast<int>(degree), true);
 
-            std::vector<BTreeNode<T>*> rootChildren{root};
-            newRoot->setChildren(rootChildren);
-
-            newRoot->splitChild(0);
-
-            int index = (key < newRoot->getKeys()[0]) ? 0 : 1;
-            newRoot->getChildren()[index]->insertNonFull(key);
-
-            root = newRoot;
-        }
-        else root->insertNonFull(key);
+    if (root->isFull()) {
+        auto* newRoot = BTreeNode<T>::create(arena, static_cast<int>(degree), false);
+        newRoot->setChild(0, root);
+        newRoot->splitChild(arena, 0);
+        root = newRoot;
     }
+    root->insertNonFull(arena, key);
+    size++;
 }
 
 template<typename T>
@@ -69,11 +121,111 @@ bool BTree<T>::search(const T &key) const {
 template<typename T>
 void BTree<T>::deleteTree(BTreeNode<T>* node) {
     if (node == nullptr) return;
+    bool isRoot = node == root;
+
+    if (!node->isLeaf()) {
+        for (int index = 0 ; index <= node->getKeyNumber() ; index++) deleteTree(node->getChild(index));
+    }
+    BTreeNode<T>::destroy(arena, node);
+
+    if (isRoot) {
+        root = nullptr;
+        size = 0;
+    }
+}
+
+template<typename T>
+bool BTree<T>::remove(const T &key) {
+    if (root == nullptr) return false;
+
+    bool removed = root->remove(arena, key);
+    if (removed) size--;
+
+    // A root left without keys is replaced by its only child, which is how the tree shrinks.
+    if (root->getKeyNumber() == 0) {
+        BTreeNode<T> *oldRoot = root;
+        root = root->isLeaf() ? nullptr : root->getChild(0);
+        BTreeNode<T>::destroy(arena, oldRoot);
+    }
+
+    return removed;
+}
+
+template<typename T>
+size_t BTree<T>::removeBatch(std::vector<T> keys) {
+    if (keys.empty() || root == nullptr) return 0;
 
-    for (BTreeNode<T>* child : node->getChildren()) {
-        deleteTree(child);
+    size_t removed = 0;
+    if (keys.size() < size / 4) {
+        for (const auto &key : keys) removed += remove(key);
+        return removed;
     }
-    delete node;
+
+    std::sort(keys.begin(), keys.end());
+    std::vector<T> remaining;
+    remaining.reserve(size);
+
+    // Both sequences are sorted, so every removed key is matched against the next tree key in one pass.
+    auto next = keys.begin();
+    forEach([&](const T &key) {
+        while (next != keys.end() && *next < key) next++;
+        if (next != keys.end() && !(key < *next)) {
+            next++;
+            removed++;
+        }
+        else remaining.push_back(key);
+        return true;
+    });
+
+    deleteTree(root);
+    for (const auto &key : remaining) insert(key);
+
+    return removed;
+}
+
+template<typename T>
+size_t BTree<T>::getSize() const {
+    return size;
+}
+
+template<typename T>
+size_t BTree<T>::getReservedSize() const {
+    return arena.getReservedSize();
+}
+
+template<typename T>
+template<typename Visit>
+bool BTree<T>::visitNode(const BTreeNode<T>* node, const T *low, const T *high, Visit &visit) const {
+    int index = (low == nullptr) ? 0 : node->findKey(*low);
+
+    for ( ; index <= node->getKeyNumber() ; index++) {
+        if (!node->isLeaf() && !visitNode(node->getChild(index), low, high, visit)) return false;
+        if (index == node->getKeyNumber()) break;
+
+        const T &key = node->getKey(index);
+        if (high != nullptr && *high < key) return false;
+        if (!visit(key)) return false;
+    }
+
+    return true;
+}
+
+template<typename T>
+template<typename Visit>
+void BTree<T>::forEach(Visit visit) const {
+    if (root != nullptr) visitNode(root, nullptr, nullptr, visit);
+}
+
+template<typename T>
+template<typename Visit>
+void BTree<T>::forEachInRange(const T &low, const T &high, Visit visit) const {
+    if (root != nullptr) visitNode(root, &low, &high, visit);
+}
+
+template<typename T>
+template<typename Visit>
+void BTree<T>::forEachInRange(const T *low, const T *high, Visit visit) const {
+    if (root != nullptr) visitNode(root, low, high, visit);
 }
 
 template<typename T>
@@ -85,13 +237,13 @@ void BTree<T>::show() const {
 
 template<typename T>
 void BTree<T>::showNode(BTreeNode<T>* node) const {
-    for (const T& key : node->getKeys()) {
-        std::cout << key << " ";
+    for (int index = 0 ; index < node->getKeyNumber() ; index++) {
+        std::cout << node->getKey(index) << " ";
     }
 
     if (!node->isLeaf()) {
-        for (BTreeNode<T>* child : node->getChildren()) {
-            showNode(child);
+        for (int index = 0 ; index <= node->getKeyNumber() ; index++) {
+            showNode(node->getChild(index));
         }
     }
 }
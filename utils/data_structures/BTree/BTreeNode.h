@@ -1,40 +1,122 @@
 #ifndef FQL_BTREENODE_H
 #define FQL_BTREENODE_H
 
-#include <vector>
+#include <algorithm>
+#include <memory>
+#include <new>
 
+#include "../SlabArena/SlabArena.h"
+#include "../../metrics/metrics.h"
+
+/**
+ * Node of a B-tree of minimum degree t. The node, its keys (at most 2t - 1) and its children
+ * (at most 2t) are placed in a single block of a slab arena, so the keys of a node are
+ * contiguous and a node is reached with a single pointer dereference.
+ * @tparam T Type of the keys, compared with operator<.
+ */
 template <typename T>
 class BTreeNode {
 private:
     int degree;
+    int keyNumber;
     bool leaf;
-    std::vector<T> keys;
-    std::vector<BTreeNode*> children;
+    T *keys;
+    BTreeNode **children;
+
+    BTreeNode(int _degree, bool _leaf, T *_keys, BTreeNode **_children);
+
+    static size_t getKeysOffset();
+    static size_t getChildrenOffset(int degree);
+
+    void insertKey(int index, T key);
+    void eraseKey(int index);
+    void insertChild(int index, BTreeNode *child);
+    void eraseChild(int index);
+
+    const T &getPredecessor(int index) const;
+    const T &getSuccessor(int index) const;
+    void borrowFromPrevious(int childIndex);
+    void borrowFromNext(int childIndex);
+    void merge(SlabArena &arena, int childIndex);
+    int fill(SlabArena &arena, int childIndex);
 
 public:
-    BTreeNode();
-    BTreeNode(int _degree, bool _leaf);
+    /**
+     * Gets the size of the arena block holding a node and its arrays.
+     * @param degree Minimum degree of the B-tree.
+     * @return Size of the block in bytes.
+     */
+    static size_t getBlockSize(int degree);
+
+    static BTreeNode *create(SlabArena &arena, int degree, bool leaf);
+    static void destroy(SlabArena &arena, BTreeNode *node);
 
     int getDegree() const;
     bool isLeaf() const;
+    bool isFull() const;
+
+    int getKeyNumber() const;
+    const T &getKey(int index) const;
+    BTreeNode *getChild(int index) const;
+    void setChild(int index, BTreeNode *child);
 
-    const std::vector<T>& getKeys() const;
-    const std::vector<BTreeNode*>& getChildren() const;
+    /**
+     * Finds the first key that is not less than the given key with a branchless binary search.
+     * @param key Key to search for.
+     * @return Index of the first key >= key, getKeyNumber() if there is none.
+     */
+    int findKey(const T &key) const;
 
-    void setLeaf(bool _leaf);
-    void setKeys(const std::vector<T>& _keys);
-    void setChildren(const std::vector<BTreeNode*>& _children);
+    void insertNonFull(SlabArena &arena, const T &key);
+    void splitChild(SlabArena &arena, int childIndex);
+    const BTreeNode *search(const T &key) const;
 
-    void insertNonFull(const T& key);
-    void splitChild(int childIndex);
-    BTreeNode<T>* search(const T& key);
+    /**
+     * Removes one occurrence of a key from the subtree of this node. Every visited child is
+     * given at least t keys (borrowing from a sibling or merging with it) before descending,
+     * so the removal never has to walk back up. The node itself may be left without keys.
+     * @param arena Arena the nodes are allocated in.
+     * @param key Key to remove.
+     * @return True if the key was found and removed, false otherwise.
+     */
+    bool remove(SlabArena &arena, const T &key);
 };
 
 template<typename T>
-BTreeNode<T>::BTreeNode() : degree(100), leaf(true) {}
+BTreeNode<T>::BTreeNode(int _degree, bool _leaf, T *_keys, BTreeNode **_children)
+    : degree(_degree), keyNumber(0), leaf(_leaf), keys(_keys), children(_children) {}
+
+template<typename T>
+size_t BTreeNode<T>::getKeysOffset() {
+    return (sizeof(BTreeNode) + alignof(T) - 1) / alignof(T) * alignof(T);
+}
+
+template<typename T>
+size_t BTreeNode<T>::getChildrenOffset(int degree) {
+    size_t keysEnd = getKeysOffset() + sizeof(T) * (2 * degree - 1);
+    return (keysEnd + alignof(BTreeNode*) - 1) / alignof(BTreeNode*) * alignof(BTreeNode*);
+}
+
+template<typename T>
+size_t BTreeNode<T>::getBlockSize(int degree) {
+    return getChildrenOffset(degree) + sizeof(BTreeNode*) * 2 * degree;
+}
+
+template<typename T>
+BTreeNode<T> *BTreeNode<T>::create(SlabArena &arena, int degree, bool leaf) {
+    auto *block = static_cast<std::byte*>(arena.allocate());
+    auto *keys = reinterpret_cast<T*>(block + getKeysOffset());
+    auto *children = reinterpret_cast<BTreeNode**>(block + getChildrenOffset(degree));
+
+    return new (block) BTreeNode(degree, leaf, keys, children);
+}
 
 template<typename T>
-BTreeNode<T>::BTreeNode(int _degree, bool _leaf) : degree(_degree), leaf(_leaf) {}
+void BTreeNode<T>::destroy(SlabArena &arena, BTreeNode *node) {
+    std::destroy_n(node->keys, node->keyNumber);
+    node->~BTreeNode();
+    arena.deallocate(node);
+}
 
 template<typename T>
 int BTreeNode<T>::getDegree() const { return this->degree; }
@@ -43,79 +125,226 @@ template<typename T>
 bool BTreeNode<T>::isLeaf() const { return this->leaf; }
 
 template<typename T>
-const std::vector<T>& BTreeNode<T>::getKeys() const { return this->keys; }
+bool BTreeNode<T>::isFull() const { return this->keyNumber == 2 * this->degree - 1; }
 
 template<typename T>
-const std::vector<BTreeNode<T>*>& BTreeNode<T>::getChildren() const { return this->children; }
+int BTreeNode<T>::getKeyNumber() const { return this->keyNumber; }
 
 template<typename T>
-void BTreeNode<T>::setLeaf(bool _leaf) { this->leaf = _leaf; }
+const T &BTreeNode<T>::getKey(int index) const { return this->keys[index]; }
 
 template<typename T>
-void BTreeNode<T>::setKeys(const std::vector<T>& _keys) { this->keys = _keys; }
+BTreeNode<T> *BTreeNode<T>::getChild(int index) const { return this->children[index]; }
 
 template<typename T>
-void BTreeNode<T>::setChildren(const std::vector<BTreeNode*>& _children) { this->children = _children; }
+void BTreeNode<T>::setChild(int index, BTreeNode *child) { this->children[index] = child; }
 
 template<typename T>
-void BTreeNode<T>::splitChild(int childIndex) {
-    BTreeNode<T>* child = children[childIndex];
-    auto* newChild = new BTreeNode<T>(child->getDegree(), child->isLeaf());
+void BTreeNode<T>::insertKey(int index, T key) {
+    if (index == keyNumber) new (keys + keyNumber) T(std::move(key));
+    else {
+        new (keys + keyNumber) T(std::move(keys[keyNumber - 1]));
+        std::move_backward(keys + index, keys + keyNumber - 1, keys + keyNumber);
+        keys[index] = std::move(key);
+    }
+    keyNumber++;
+}
+
+template<typename T>
+void BTreeNode<T>::eraseKey(int index) {
+    std::move(keys + index + 1, keys + keyNumber, keys + index);
+    std::destroy_at(keys + keyNumber - 1);
+    keyNumber--;
+}
+
+// The children are moved together with their keys, so they are shifted over keyNumber + 1 slots.
+template<typename T>
+void BTreeNode<T>::insertChild(int index, BTreeNode *child) {
+    std::move_backward(children + index, children + keyNumber + 1, children + keyNumber + 2);
+    children[index] = child;
+}
 
-    int middle = (degree - 1) / 2;
-    std::vector<T> childKeys(child->getKeys().begin() + middle + 1, child->getKeys().end());
-    newChild->setKeys(childKeys);
+template<typename T>
+void BTreeNode<T>::eraseChild(int index) {
+    std::move(children + index + 1, children + keyNumber + 1, children + index);
+}
 
-    child->setKeys(std::vector<T>(child->getKeys().begin(), child->getKeys().begin() + middle));
+template<typename T>
+int BTreeNode<T>::findKey(const T &key) const {
+    if (keyNumber == 0) return 0;
 
-    if (!child->isLeaf()) {
-        std::vector<BTreeNode*> childChildren(child->getChildren().begin() + middle + 1, child->getChildren().end());
-        newChild->setChildren(childChildren);
-        child->setChildren(std::vector<BTreeNode*>(child->getChildren().begin(), child->getChildren().begin() + middle + 1));
+    // The range is halved without branching on the comparison, which the compiler turns into a conditional move.
+    const T *base = keys;
+    int length = keyNumber;
+    while (length > 1) {
+        int half = length / 2;
+        base = (base[half - 1] < key) ? base + half : base;
+        length -= half;
     }
 
-    keys.insert(keys.begin() + childIndex, child->getKeys()[middle]);
-    child->setKeys(std::vector<T>(child->getKeys().begin(), child->getKeys().begin() + middle));
+    return static_cast<int>(base - keys) + (*base < key);
+}
+
+template<typename T>
+void BTreeNode<T>::splitChild(SlabArena &arena, int childIndex) {
+    BTreeNode<T>* child = children[childIndex];
+    BTreeNode<T>* newChild = create(arena, child->degree, child->leaf);
+
+    // The full child keeps the first t - 1 keys, the new child takes the last t - 1 and the middle one moves up.
+    int middle = degree - 1;
+    std::uninitialized_move_n(child->keys + middle + 1, degree - 1, newChild->keys);
+    newChild->keyNumber = degree - 1;
+
+    if (!child->leaf) std::copy_n(child->children + middle + 1, degree, newChild->children);
+
+    insertChild(childIndex + 1, newChild);
+    insertKey(childIndex, std::move(child->keys[middle]));
 
-    children.insert(children.begin() + childIndex + 1, newChild);
+    std::destroy_n(child->keys + middle, degree);
+    child->keyNumber = middle;
 }
 
 template<typename T>
-void BTreeNode<T>::insertNonFull(const T &key) {
-    int rightIndex = keys.size() - 1;
+void BTreeNode<T>::insertNonFull(SlabArena &arena, const T &key) {
+    BTreeNode<T> *node = this;
 
-    if (leaf) {
-        keys.push_back(key);
-        while (rightIndex >= 0 && keys[rightIndex] > key) {
-            keys[rightIndex + 1] = keys[rightIndex];
-            rightIndex--;
+    while (!node->leaf) {
+        // Equal keys go to the right, after the keys they are equal to.
+        int index = node->findKey(key);
+        while (index < node->keyNumber && !(key < node->keys[index])) index++;
+
+        if (node->children[index]->isFull()) {
+            node->splitChild(arena, index);
+            if (!(key < node->keys[index])) index++;
         }
-        keys[rightIndex + 1] = key;
+        node = node->children[index];
+    }
 
-        return;
-    } else {
-        while (rightIndex >= 0 && keys[rightIndex] > key) rightIndex--;
-        rightIndex++;
+    int index = node->findKey(key);
+    while (index < node->keyNumber && !(key < node->keys[index])) index++;
 
-        if (children[rightIndex]->getKeys().size() == 2 * degree - 1) {
-            splitChild(rightIndex);
-            if (keys[rightIndex] < key) rightIndex++;
-        }
-        children[rightIndex]->insertNonFull(key);
+    node->insertKey(index, key);
+}
+
+template<typename T>
+const BTreeNode<T>* BTreeNode<T>::search(const T &key) const {
+    const BTreeNode<T> *node = this;
+
+    while (true) {
+        countMetric(Metric::BTreeNodeVisits);
+        int index = node->findKey(key);
+        if (index < node->keyNumber && !(key < node->keys[index])) return node;
+
+        if (node->leaf) return nullptr;
+        node = node->children[index];
     }
 }
 
 template<typename T>
-BTreeNode<T>* BTreeNode<T>::search(const T &key) {
-    int index = 0;
-    while (index < keys.size() && key > keys[index]) index++;
+const T &BTreeNode<T>::getPredecessor(int index) const {
+    const BTreeNode<T> *node = children[index];
+    while (!node->leaf) node = node->children[node->keyNumber];
+
+    return node->keys[node->keyNumber - 1];
+}
+
+template<typename T>
+const T &BTreeNode<T>::getSuccessor(int index) const {
+    const BTreeNode<T> *node = children[index + 1];
+    while (!node->leaf) node = node->children[0];
+
+    return node->keys[0];
+}
+
+template<typename T>
+void BTreeNode<T>::borrowFromPrevious(int childIndex) {
+    BTreeNode<T> *child = children[childIndex];
+    BTreeNode<T> *sibling = children[childIndex - 1];
+
+    // The separator moves down into the child and the last key of the sibling replaces it.
+    if (!child->leaf) child->insertChild(0, sibling->children[sibling->keyNumber]);
+    child->insertKey(0, std::move(keys[childIndex - 1]));
+    keys[childIndex - 1] = std::move(sibling->keys[sibling->keyNumber - 1]);
+    sibling->eraseKey(sibling->keyNumber - 1);
+}
+
+template<typename T>
+void BTreeNode<T>::borrowFromNext(int childIndex) {
+    BTreeNode<T> *child = children[childIndex];
+    BTreeNode<T> *sibling = children[childIndex + 1];
 
-    if (index < keys.size() && keys[index] == key) {
-        return this;
+    // The separator moves down into the child and the first key of the sibling replaces it.
+    if (!child->leaf) child->children[child->keyNumber + 1] = sibling->children[0];
+    child->insertKey(child->keyNumber, std::move(keys[childIndex]));
+    keys[childIndex] = std::move(sibling->keys[0]);
+
+    if (!sibling->leaf) sibling->eraseChild(0);
+    sibling->eraseKey(0);
+}
+
+template<typename T>
+void BTreeNode<T>::merge(SlabArena &arena, int childIndex) {
+    BTreeNode<T> *child = children[childIndex];
+    BTreeNode<T> *sibling = children[childIndex + 1];
+
+    // The child, the separator and the sibling become a single node of at most 2t - 1 keys.
+    new (child->keys + child->keyNumber) T(std::move(keys[childIndex]));
+    std::uninitialized_move_n(sibling->keys, sibling->keyNumber, child->keys + child->keyNumber + 1);
+    if (!child->leaf) std::copy_n(sibling->children, sibling->keyNumber + 1, child->children + child->keyNumber + 1);
+    child->keyNumber += sibling->keyNumber + 1;
+
+    eraseChild(childIndex + 1);
+    eraseKey(childIndex);
+    destroy(arena, sibling);
+}
+
+template<typename T>
+int BTreeNode<T>::fill(SlabArena &arena, int childIndex) {
+    if (childIndex > 0 && children[childIndex - 1]->keyNumber >= degree) borrowFromPrevious(childIndex);
+    else if (childIndex < keyNumber && children[childIndex + 1]->keyNumber >= degree) borrowFromNext(childIndex);
+    else if (childIndex < keyNumber) merge(arena, childIndex);
+    else {
+        merge(arena, childIndex - 1);
+        return childIndex - 1;
     }
 
-    if (leaf) return nullptr;
-    return children[index]->search(key);
+    return childIndex;
+}
+
+template<typename T>
+bool BTreeNode<T>::remove(SlabArena &arena, const T &key) {
+    BTreeNode<T> *node = this;
+    T target = key;
+
+    while (true) {
+        int index = node->findKey(target);
+        bool found = index < node->keyNumber && !(target < node->keys[index]);
+
+        if (found && node->leaf) {
+            node->eraseKey(index);
+            return true;
+        }
+        if (found) {
+            // The key is replaced by its predecessor or successor, which is then removed from the child.
+            if (node->children[index]->keyNumber >= degree) {
+                target = node->getPredecessor(index);
+                node->keys[index] = target;
+            }
+            else if (node->children[index + 1]->keyNumber >= degree) {
+                target = node->getSuccessor(index);
+                node->keys[index] = target;
+                index++;
+            }
+            else node->merge(arena, index);
+
+            node = node->children[index];
+            continue;
+        }
+
+        if (node->leaf) return false;
+        if (node->children[index]->keyNumber < degree) index = node->fill(arena, index);
+        node = node->children[index];
+    }
 }
 
-#endif //FQL_BTREENODE_H
\ No newline at end of file
+#endif //FQL_BTREENODE_H
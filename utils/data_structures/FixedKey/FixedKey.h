@@ -0,0 +1,69 @@
+#ifndef FQL_FIXEDKEY_H
+#define FQL_FIXEDKEY_H
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string_view>
+
+/**
+ * String key of at most N characters stored inline and padded with zeros, so that keys
+ * can be kept in contiguous arrays and compared with a single fixed-size memcmp.
+ * @tparam N Maximum amount of characters of the key.
+ */
+template <size_t N>
+class FixedKey {
+    static_assert(N <= UINT8_MAX, "The length of a fixed key must fit in a byte.");
+
+private:
+    char characters[N];
+    uint8_t length;
+
+public:
+    static constexpr size_t capacity = N;
+
+    FixedKey();
+    explicit FixedKey(std::string_view key);
+
+    std::string_view view() const;
+
+    bool operator==(const FixedKey &other) const;
+    bool operator<(const FixedKey &other) const;
+    bool operator>(const FixedKey &other) const;
+};
+
+template<size_t N>
+FixedKey<N>::FixedKey() : characters(), length(0) {}
+
+template<size_t N>
+FixedKey<N>::FixedKey(std::string_view key) : characters(), length(static_cast<uint8_t>(key.size())) {
+    std::memcpy(characters, key.data(), key.size());
+}
+
+template<size_t N>
+std::string_view FixedKey<N>::view() const {
+    return {characters, length};
+}
+
+// Stored values never contain '\0', so the zero padding orders a key before its extensions.
+template<size_t N>
+bool FixedKey<N>::operator==(const FixedKey &other) const {
+    return std::memcmp(characters, other.characters, N) == 0;
+}
+
+template<size_t N>
+bool FixedKey<N>::operator<(const FixedKey &other) const {
+    return std::memcmp(characters, other.characters, N) < 0;
+}
+
+template<size_t N>
+bool FixedKey<N>::operator>(const FixedKey &other) const {
+    return std::memcmp(characters, other.characters, N) > 0;
+}
+
+template<size_t N>
+std::ostream &operator<<(std::ostream &os, const FixedKey<N> &key) {
+    return os << key.view();
+}
+
+#endif //FQL_FIXEDKEY_H
@@ -0,0 +1,111 @@
+#ifndef FQL_LOSERTREE_H
+#define FQL_LOSERTREE_H
+
+#include <vector>
+#include <utility>
+
+/**
+ * Tournament tree used for k-way merging. Every internal node stores the loser of the
+ * match played in it, so replacing the winner only replays the matches on its path to
+ * the root (log k comparisons).
+ * @tparam T Type of the merged elements.
+ * @tparam Compare Strict weak ordering, returns true if the first element goes before the second.
+ */
+template <typename T, typename Compare>
+class LoserTree {
+private:
+    size_t size;
+    std::vector<size_t> losers;
+    std::vector<T> heads;
+    std::vector<bool> exhausted;
+    Compare compare;
+
+    bool beats(size_t first, size_t second) const;
+    void replay(size_t source);
+
+public:
+    LoserTree(const std::vector<T> &_heads, const std::vector<bool> &_exhausted, Compare _compare);
+
+    bool empty() const;
+    size_t winner() const;
+    const T& top() const;
+
+    void replaceTop(const T &next);
+    void exhaustTop();
+};
+
+template<typename T, typename Compare>
+LoserTree<T, Compare>::LoserTree(const std::vector<T> &_heads, const std::vector<bool> &_exhausted, Compare _compare)
+    : size(_heads.size()), losers(_heads.size(), _heads.size()), heads(_heads),
+      exhausted(_exhausted), compare(_compare) {
+    // An empty slot (index == size) loses every match, so each source climbs until it finds a parked loser.
+    for (size_t source = 0 ; source < size ; source++) replay(source);
+}
+
+template<typename T, typename Compare>
+bool LoserTree<T, Compare>::beats(size_t first, size_t second) const {
+    if (second >= size || exhausted[second]) return true;
+    if (first >= size || exhausted[first]) return false;
+    if (compare(heads[first], heads[second])) return true;
+    if (compare(heads[second], heads[first])) return false;
+
+    // Ties are broken by source index to keep the merge stable.
+    return first < second;
+}
+
+template<typename T, typename Compare>
+void LoserTree<T, Compare>::replay(size_t source) {
+    size_t current = source;
+    size_t node = (source + size) / 2;
+
+    while (node > 0) {
+        if (losers[node] == size) {
+            losers[node] = current;
+            return;
+        }
+        if (beats(losers[node], current)) std::swap(losers[node], current);
+        node /= 2;
+    }
+    losers[0] = current;
+}
+
+template<typename T, typename Compare>
+bool LoserTree<T, Compare>::empty() const {
+    return size == 0 || exhausted[losers[0]];
+}
+
+template<typename T, typename Compare>
+size_t LoserTree<T, Compare>::winner() const {
+    return losers[0];
+}
+
+template<typename T, typename Compare>
+const T& LoserTree<T, Compare>::top() const {
+    return heads[losers[0]];
+}
+
+template<typename T, typename Compare>
+void LoserTree<T, Compare>::replaceTop(const T &next) {
+    size_t source = losers[0];
+    heads[source] = next;
+
+    size_t current = source;
+    for (size_t node = (source + size) / 2 ; node > 0 ; node /= 2) {
+        if (beats(losers[node], current)) std::swap(losers[node], current);
+    }
+    losers[0] = current;
+}
+
+template<typename T, typename Compare>
+void LoserTree<T, Compare>::exhaustTop() {
+    size_t source = losers[0];
+    exhausted[source] = true;
+
+    size_t current = source;
+    for (size_t node = (source + size) / 2 ; node > 0 ; node /= 2) {
+        if (beats(losers[node], current)) std::swap(losers[node], current);
+    }
+    losers[0] = current;
+}
+
+#endif //FQL_LOSERTREE_H
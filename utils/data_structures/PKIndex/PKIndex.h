@@ -0,0 +1,233 @@
+#ifndef FQL_PKINDEX_H
+#define FQL_PKINDEX_H
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../BTree/BTree.h"
+#include "../FixedKey/FixedKey.h"
+#include "../../metrics/metrics.h"
+#include "../../../domain/value/Value.h"
+
+/**
+ * Describes how a decoded value is stored as a key of type Key in a PK index, and how a key is
+ * turned back into a value of a given type.
+ * @tparam Key Type of the keys stored in the B-tree.
+ */
+template <typename Key>
+struct PKKeyTraits;
+
+/**
+ * UUID, int, boolean, date and datetime PKs are stored as 64-bit integers. UUIDs are
+ * always 16 decimal digits, so their numeric order is their lexicographic order.
+ */
+template <>
+struct PKKeyTraits<int64_t> {
+    static Value decode(const int64_t &key, ValueType type) {
+        switch (type) {
+            case ValueType::Integer: return Value::fromInteger(key);
+            case ValueType::Boolean: return Value::fromBoolean(key != 0);
+            case ValueType::Date: return Value::fromDate(key);
+            case ValueType::Datetime: return Value::fromDatetime(key);
+            default: break;
+        }
+
+        std::string digits = std::to_string(key);
+        if (digits.size() < 16) digits.insert(0, 16 - digits.size(), '0');
+        return Value::fromString(digits);
+    }
+
+    static bool encode(const Value &value, int64_t &key) {
+        if (value.isNull()) return false;
+        if (value.getType() != ValueType::String) {
+            key = value.getInteger();
+            return true;
+        }
+
+        const char *characters = value.getCharacters();
+        size_t length = value.getLength();
+        if (length == 0 || length > 18) return false;
+
+        key = 0;
+        for (size_t index = 0 ; index < length ; index++) {
+            if (characters[index] < '0' || characters[index] > '9') return false;
+            key = key * 10 + (characters[index] - '0');
+        }
+        return true;
+    }
+};
+
+/**
+ * char(x) and varchar(x) PKs of at most N characters are stored inline.
+ */
+template <size_t N>
+struct PKKeyTraits<FixedKey<N>> {
+    static Value decode(const FixedKey<N> &key, ValueType) {
+        return Value::fromString(std::string(key.view()));
+    }
+
+    static bool encode(const Value &value, FixedKey<N> &key) {
+        if (value.getType() != ValueType::String || value.getLength() > N) return false;
+
+        key = FixedKey<N>(std::string_view(value.getCharacters(), value.getLength()));
+        return true;
+    }
+};
+
+/**
+ * Any other PK is stored as the decoded value itself.
+ */
+template <>
+struct PKKeyTraits<Value> {
+    static Value decode(const Value &key, ValueType) {
+        return key;
+    }
+
+    static bool encode(const Value &value, Value &key) {
+        if (value.isNull()) return false;
+
+        key = value;
+        return true;
+    }
+};
+
+/**
+ * Index over the PKs of a relation, independent of how the keys are stored.
+ */
+class PKIndex {
+public:
+    virtual ~PKIndex() = default;
+
+    /**
+     * Inserts a PK into the index.
+     * @param PK Decoded PK.
+     */
+    virtual void insert(const Value &PK) = 0;
+
+    /**
+     * Searches a PK in the index.
+     * @param PK Decoded PK.
+     * @return True if the PK is in the index, false otherwise.
+     */
+    virtual bool search(const Value &PK) const = 0;
+
+    /**
+     * Removes a PK from the index.
+     * @param PK Decoded PK.
+     * @return True if the PK was in the index, false otherwise.
+     */
+    virtual bool remove(const Value &PK) = 0;
+
+    /**
+     * Removes several PKs from the index at once.
+     * @param PKs Decoded PKs.
+     * @return Amount of PKs that were in the index.
+     */
+    virtual size_t removeBatch(const std::vector<Value> &PKs) = 0;
+
+    /**
+     * Visits the PKs in [low, high] in ascending order, skipping the subtrees outside the range.
+     * @param low Lowest visited PK, nullptr to start at the first PK.
+     * @param high Highest visited PK, nullptr to go up to the last PK.
+     * @param type Type of the decoded PKs.
+     * @param visit Called with every PK in the range, returns false to stop the iteration.
+     */
+    virtual void forEachInRange(const Value *low, const Value *high, ValueType type,
+                                const std::function<bool(const Value &)> &visit) const = 0;
+};
+
+/**
+ * PK index backed by a B-tree of keys of type Key.
+ * @tparam Key Type of the keys, described by PKKeyTraits.
+ */
+template <typename Key>
+class BTreePKIndex : public PKIndex {
+private:
+    BTree<Key> btree;
+
+public:
+    explicit BTreePKIndex(long pageSize);
+
+    /**
+     * Computes the degree of the B-tree so that a node with its keys and children fills a page.
+     * @param pageSize Size of a page in bytes.
+     * @return Degree of the B-tree.
+     */
+    static long getDegree(long pageSize);
+
+    void insert(const Value &PK) override;
+    bool search(const Value &PK) const override;
+    bool remove(const Value &PK) override;
+    size_t removeBatch(const std::vector<Value> &PKs) override;
+    void forEachInRange(const Value *low, const Value *high, ValueType type,
+                        const std::function<bool(const Value &)> &visit) const override;
+};
+
+template<typename Key>
+BTreePKIndex<Key>::BTreePKIndex(long pageSize) : btree(getDegree(pageSize)) {}
+
+template<typename Key>
+long BTreePKIndex<Key>::getDegree(long pageSize) {
+    const long overhead = sizeof(BTreeNode<Key>);
+    const long keySize = sizeof(Key);
+    const long pointerSize = sizeof(BTreeNode<Key>*);
+
+    // A node holds at most 2t - 1 keys and 2t children.
+    return (pageSize - overhead + keySize) / (2 * (keySize + pointerSize));
+}
+
+template<typename Key>
+void BTreePKIndex<Key>::insert(const Value &PK) {
+    Key key;
+    if (!PKKeyTraits<Key>::encode(PK, key)) throw std::runtime_error("Invalid primary key: " + PK.toString());
+
+    btree.insert(key);
+}
+
+template<typename Key>
+bool BTreePKIndex<Key>::search(const Value &PK) const {
+    countMetric(Metric::IndexProbes);
+    Key key;
+    if (!PKKeyTraits<Key>::encode(PK, key)) return false;
+
+    return btree.search(key);
+}
+
+template<typename Key>
+bool BTreePKIndex<Key>::remove(const Value &PK) {
+    Key key;
+    if (!PKKeyTraits<Key>::encode(PK, key)) return false;
+
+    return btree.remove(key);
+}
+
+template<typename Key>
+size_t BTreePKIndex<Key>::removeBatch(const std::vector<Value> &PKs) {
+    std::vector<Key> keys;
+    keys.reserve(PKs.size());
+
+    for (const auto &PK : PKs) {
+        Key key;
+        if (PKKeyTraits<Key>::encode(PK, key)) keys.push_back(key);
+    }
+    return btree.removeBatch(std::move(keys));
+}
+
+template<typename Key>
+void BTreePKIndex<Key>::forEachInRange(const Value *low, const Value *high, ValueType type,
+                                       const std::function<bool(const Value &)> &visit) const {
+    countMetric(Metric::IndexProbes);
+    Key lowKey, highKey;
+    // A bound that can not be stored as a key is left open, the caller checks the PKs against it.
+    bool hasLow = low != nullptr && PKKeyTraits<Key>::encode(*low, lowKey);
+    bool hasHigh = high != nullptr && PKKeyTraits<Key>::encode(*high, highKey);
+
+    btree.forEachInRange(hasLow ? &lowKey : nullptr, hasHigh ? &highKey : nullptr, [&visit, type](const Key &key) {
+        return visit(PKKeyTraits<Key>::decode(key, type));
+    });
+}
+
+#endif //FQL_PKINDEX_H
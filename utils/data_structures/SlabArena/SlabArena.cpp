@@ -0,0 +1,42 @@
+#include "SlabArena.h"
+
+SlabArena::SlabArena(size_t _blockSize, size_t slabSize) : nextBlock(0), freeList(nullptr) {
+    // Every block must be able to hold the free list link and keep the next block aligned.
+    const size_t alignment = alignof(std::max_align_t);
+    if (_blockSize < sizeof(void*)) _blockSize = sizeof(void*);
+    this->blockSize = (_blockSize + alignment - 1) / alignment * alignment;
+
+    this->blocksPerSlab = slabSize / this->blockSize;
+    if (this->blocksPerSlab == 0) this->blocksPerSlab = 1;
+    this->nextBlock = this->blocksPerSlab;
+}
+
+void *SlabArena::allocate() {
+    if (freeList != nullptr) {
+        void *block = freeList;
+        freeList = *static_cast<void**>(block);
+        return block;
+    }
+
+    if (nextBlock == blocksPerSlab) {
+        slabs.emplace_back(new std::byte[blockSize * blocksPerSlab]);
+        nextBlock = 0;
+    }
+
+    return slabs.back().get() + blockSize * nextBlock++;
+}
+
+void SlabArena::deallocate(void *block) {
+    if (block == nullptr) return;
+
+    *static_cast<void**>(block) = freeList;
+    freeList = block;
+}
+
+size_t SlabArena::getBlockSize() const {
+    return this->blockSize;
+}
+
+size_t SlabArena::getReservedSize() const {
+    return this->slabs.size() * this->blockSize * this->blocksPerSlab;
+}
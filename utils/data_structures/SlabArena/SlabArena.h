@@ -0,0 +1,52 @@
+#ifndef FQL_SLABARENA_H
+#define FQL_SLABARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * Allocator of fixed-size blocks carved out of large slabs. Blocks of consecutive
+ * allocations are adjacent in memory and freed blocks are reused before a new slab is
+ * allocated, so allocating and freeing a block does not go through the heap.
+ */
+class SlabArena {
+private:
+    size_t blockSize;
+    size_t blocksPerSlab;
+    size_t nextBlock;
+    void *freeList;
+    std::vector<std::unique_ptr<std::byte[]>> slabs;
+
+public:
+    /**
+     * @param _blockSize Size of every allocated block in bytes.
+     * @param slabSize Size of a slab in bytes, at least one block is placed in every slab.
+     */
+    explicit SlabArena(size_t _blockSize, size_t slabSize = 1 << 20);
+
+    SlabArena(const SlabArena &) = delete;
+    SlabArena &operator=(const SlabArena &) = delete;
+
+    /**
+     * Allocates a block, aligned for any fundamental type.
+     * @return Pointer to the uninitialized block.
+     */
+    void *allocate();
+
+    /**
+     * Returns a block to the arena so that it can be reused.
+     * @param block Block previously returned by allocate.
+     */
+    void deallocate(void *block);
+
+    size_t getBlockSize() const;
+
+    /**
+     * Gets the amount of memory reserved by the arena.
+     * @return Size of all the slabs in bytes.
+     */
+    size_t getReservedSize() const;
+};
+
+#endif //FQL_SLABARENA_H
@@ -0,0 +1,118 @@
+#include "metrics.h"
+
+#ifdef FQL_METRICS
+
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "../../io/io.h"
+
+namespace {
+    // Bucket i counts the latencies of at most 2^i microseconds, the last one holds the slower ones.
+    const size_t bucketNumber = 26;
+
+    struct Histogram {
+        std::array<uint64_t, bucketNumber> buckets{};
+        uint64_t count = 0;
+        uint64_t sum = 0;
+    };
+
+    // Ordered by opcode, so the exported files are stable between runs.
+    std::map<std::string, Histogram> opcodeLatencies;
+
+    const std::array<std::string, metricNumber> metricNames = {
+            "file_opens", "rows_scanned", "predicate_evaluations", "index_probes", "btree_node_visits",
+            "block_pool_hits", "block_pool_misses"
+    };
+
+    std::string getBucketBound(size_t bucket) {
+        if (bucket == bucketNumber - 1) return "+Inf";
+        return std::to_string(uint64_t{1} << bucket);
+    }
+
+    std::vector<std::pair<std::string, uint64_t>> getCounters() {
+        std::vector<std::pair<std::string, uint64_t>> counters;
+        for (size_t index = 0 ; index < metricNumber ; index++) {
+            counters.emplace_back(metricNames[index], metricCounters[index].load(std::memory_order_relaxed));
+        }
+        counters.emplace_back("bytes_read", getBytesRead());
+        counters.emplace_back("bytes_written", getBytesWritten());
+        return counters;
+    }
+
+    std::string toPrometheus() {
+        std::ostringstream out;
+        for (const auto &[name, value] : getCounters()) {
+            out << "# TYPE fql_" << name << "_total counter\n";
+            out << "fql_" << name << "_total " << value << "\n";
+        }
+
+        out << "# TYPE fql_opcode_latency_microseconds histogram\n";
+        for (const auto &[opCode, histogram] : opcodeLatencies) {
+            uint64_t cumulative = 0;
+            for (size_t bucket = 0 ; bucket < bucketNumber ; bucket++) {
+                cumulative += histogram.buckets[bucket];
+                out << "fql_opcode_latency_microseconds_bucket{opcode=\"" << opCode << "\",le=\""
+                    << getBucketBound(bucket) << "\"} " << cumulative << "\n";
+            }
+            out << "fql_opcode_latency_microseconds_sum{opcode=\"" << opCode << "\"} " << histogram.sum << "\n";
+            out << "fql_opcode_latency_microseconds_count{opcode=\"" << opCode << "\"} " << histogram.count << "\n";
+        }
+        return out.str();
+    }
+
+    std::string toJSON() {
+        std::ostringstream out;
+        out << "{\n  \"counters\": {";
+
+        auto counters = getCounters();
+        for (size_t index = 0 ; index < counters.size() ; index++) {
+            out << (index == 0 ? "\n" : ",\n") << "    \"" << counters[index].first << "\": " << counters[index].second;
+        }
+
+        out << "\n  },\n  \"opcode_latency_microseconds\": {";
+        bool first = true;
+        for (const auto &[opCode, histogram] : opcodeLatencies) {
+            out << (first ? "\n" : ",\n") << "    \"" << opCode << "\": {\"count\": " << histogram.count
+                << ", \"sum\": " << histogram.sum << ", \"buckets\": [";
+
+            uint64_t cumulative = 0;
+            for (size_t bucket = 0 ; bucket < bucketNumber ; bucket++) {
+                cumulative += histogram.buckets[bucket];
+                out << (bucket == 0 ? "" : ", ") << "{\"le\": \"" << getBucketBound(bucket) << "\", \"count\": "
+                    << cumulative << "}";
+            }
+            out << "]}";
+            first = false;
+        }
+        out << "\n  }\n}\n";
+        return out.str();
+    }
+}
+
+void recordOpcodeLatency(const std::string &opCode, uint64_t microseconds) {
+    Histogram &histogram = opcodeLatencies[opCode];
+
+    size_t bucket = 0;
+    while (bucket < bucketNumber - 1 && microseconds > (uint64_t{1} << bucket)) bucket++;
+
+    histogram.buckets[bucket]++;
+    histogram.count++;
+    histogram.sum += microseconds;
+}
+
+void exportMetrics() {
+    const char *variable = std::getenv("FQL_METRICS_FILE");
+    std::string filePath = variable != nullptr && *variable != '\0' ? variable : "fql_metrics.json";
+    bool prometheus = filePath.size() >= 5 && filePath.compare(filePath.size() - 5, 5, ".prom") == 0;
+
+    std::ofstream fout(filePath);
+    if (!fout.is_open()) throw std::runtime_error("Unable to open file: " + filePath);
+    fout << (prometheus ? toPrometheus() : toJSON());
+}
+
+#endif
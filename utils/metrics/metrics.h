@@ -0,0 +1,89 @@
+#pragma once
+
+#ifndef FQL_METRICS_H
+#define FQL_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * Counters of the work done by the executor. They are collected only when FQL is built with
+ * FQL_METRICS defined (the FQL_METRICS CMake option), otherwise every call below is an empty
+ * inline function and compiles to nothing.
+ */
+enum class Metric {
+    FileOpens,
+    RowsScanned,
+    PredicateEvaluations,
+    IndexProbes,
+    BTreeNodeVisits,
+    BlockPoolHits,
+    BlockPoolMisses
+};
+
+const size_t metricNumber = 7;
+
+#ifdef FQL_METRICS
+
+// The counters live in the header, so the B-tree and the aggregation threads count without a call.
+inline std::array<std::atomic<uint64_t>, metricNumber> metricCounters{};
+
+/**
+ * Adds to a counter.
+ * @param metric Counter to add to.
+ * @param amount Amount to add.
+ */
+inline void countMetric(Metric metric, uint64_t amount = 1) {
+    metricCounters[static_cast<size_t>(metric)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+/**
+ * Adds the latency of an executed opcode to the histogram of the opcode.
+ * @param opCode Opcode of the build line.
+ * @param microseconds Latency of the opcode.
+ */
+void recordOpcodeLatency(const std::string &opCode, uint64_t microseconds);
+
+/**
+ * Writes the counters and the histograms to the file named by the FQL_METRICS_FILE environment
+ * variable, fql_metrics.json by default. Files ending in .prom are written in the Prometheus text
+ * format, any other file is written as JSON.
+ */
+void exportMetrics();
+
+/**
+ * Measures the latency of an opcode from its construction to its destruction.
+ */
+class OpcodeTimer {
+public:
+    explicit OpcodeTimer(const std::string &_opCode) : opCode(_opCode), start(std::chrono::steady_clock::now()) {}
+
+    ~OpcodeTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        recordOpcodeLatency(opCode, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
+
+private:
+    const std::string &opCode;
+    std::chrono::steady_clock::time_point start;
+};
+
+#else
+
+inline void countMetric(Metric, uint64_t = 1) {}
+
+inline void recordOpcodeLatency(const std::string &, uint64_t) {}
+
+inline void exportMetrics() {}
+
+class OpcodeTimer {
+public:
+    explicit OpcodeTimer(const std::string &) {}
+};
+
+#endif
+
+#endif //FQL_METRICS_H